@@ -3,6 +3,7 @@
 #define ANIMAL_H
 
 #include "entity.hpp"
+#include "speciesParams.hpp" // For AnimalParams
 #include <vector>  // For potentialMates vector
 #include <memory>  // For std::shared_ptr
 #include <string>  // For species name in events
@@ -10,7 +11,26 @@
 
 // Forward declarations
 class Grid;
-struct MonthlyStats;
+struct StatsShard;
+
+// Cell an animal wants to move to this month (moves == false means it stays put).
+struct MoveIntent
+{
+    int targetR;
+    int targetC;
+    bool moves;
+};
+
+// Everything about an animal that changes month to month (its species parameters are in AnimalParams).
+struct AnimalState
+{
+    int currentAge;
+    int currentEnergy;
+    int currentCooldownForReproduction;
+    bool currentlyPregnant;
+    int currentGestationProgress;
+    int mealsMissedTurns;
+};
 
 // Base class for animal entities (Herbivores, Carnivores).
 class Animal : public Entity
@@ -44,20 +64,28 @@ public:
     // Gets the gender of the animal.
     Gender getGender() const override;
     // Handles the death of an animal.
-    virtual void die(MonthlyStats &stats, bool eaten = false);
+    virtual void die(StatsShard &stats, bool eaten = false);
     // Base update logic common to all animals.
-    virtual void baseUpdate(MonthlyStats &stats, Season currentSeason);
+    virtual void baseUpdate(StatsShard &stats, Season currentSeason);
     // Overridden update logic for animals.
-    void update(Grid &grid, MonthlyStats &stats, Season currentSeason) override;
+    void update(Grid &grid, StatsShard &stats, Season currentSeason) override;
+    // Runs everything in update() that comes before moving; returns true if the animal should still move.
+    bool updateBeforeMove(Grid &grid, StatsShard &stats, Season currentSeason);
+    // Deducts the movement cost and applies a planned move on the grid (a refused move still costs the effort).
+    void applyMove(Grid &grid, const MoveIntent &intent);
 
     // Pure virtual function for attempting reproduction.
-    virtual void attemptReproduce(Grid &grid, MonthlyStats &stats, const std::vector<std::shared_ptr<Animal>> &potentialMates, Season currentSeason) = 0;
+    virtual void attemptReproduce(Grid &grid, StatsShard &stats, const std::vector<std::shared_ptr<Animal>> &potentialMates, Season currentSeason) = 0;
     // Pure virtual function for giving birth.
-    virtual void giveBirth(Grid &grid, MonthlyStats &stats) = 0;
+    virtual void giveBirth(Grid &grid, StatsShard &stats) = 0;
     // Pure virtual function for attempting to eat.
-    virtual bool attemptEat(Grid &grid, MonthlyStats &stats, Season currentSeason) = 0;
-    // Pure virtual function for movement logic.
-    virtual void move(Grid &grid, MonthlyStats &stats, Season currentSeason) = 0;
+    virtual bool attemptEat(Grid &grid, StatsShard &stats, Season currentSeason) = 0;
+    // Pure virtual function crediting a meal: gains energy, kills the prey and counts it (the caller takes the prey off the grid).
+    virtual void eatPrey(Entity &prey, StatsShard &stats) = 0;
+    // Pure virtual function choosing a move from the current grid without changing anything.
+    virtual MoveIntent planMove(const Grid &grid, Season currentSeason) const = 0;
+    // Movement logic: plans a move and applies it straight away.
+    virtual void move(Grid &grid, StatsShard &stats, Season currentSeason);
     
     // Checks if the animal can currently reproduce.
     bool canReproduceInternal() const;
@@ -80,10 +108,16 @@ public:
     int getMealsMissedTurns() const;
     int getMaxTurnsWithoutFoodAllowed() const;
     double getAnimalSize() const;
+    // Gets the species parameters this animal was created with.
+    AnimalParams getParams() const;
+    // Gets the animal's month-to-month state.
+    AnimalState getState() const;
 
     // Setters/Modifiers (examples, add more if needed by external logic not part of update flow)
     void setCurrentEnergy(int energy_val);
     void setCurrentlyPregnant(bool is_pregnant_val);
+    // Restores state captured with getState (e.g. after handing the animal to another process).
+    void setState(const AnimalState &state);
     // Note: Most other variables are managed internally by update/baseUpdate cycles.
     // For example, age is incremented internally.
 };
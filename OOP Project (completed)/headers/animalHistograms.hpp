@@ -0,0 +1,76 @@
+// animalHistograms.h
+#ifndef ANIMALHISTOGRAMS_H
+#define ANIMALHISTOGRAMS_H
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <iosfwd>
+#include "constants.hpp" // For EntityType
+
+class Animal;
+
+// Fixed-bin distributions kept per animal species.
+enum class AnimalHistogram
+{
+    ENERGY,       // 10 bins of 10% of the species' maximum energy
+    AGE,          // 10 bins of 10% of the species' maximum age
+    MEALS_MISSED, // Months since the last meal: 0, 1, ..., 6, 7 or more
+    GESTATION,    // Not pregnant, then the four quarters of the gestation period
+    AGE_AT_DEATH, // Like AGE, for the animals that died
+    COUNT
+};
+
+// One month's histograms of herbivores and carnivores, filled as the month runs instead
+// of by a pass over the population: every animal adds its state once, at the end of its
+// baseUpdate (if it survived it); newborns add theirs at birth; every death adds the age
+// the animal reached. An animal that dies later in the month it was counted stays counted,
+// so the state histograms describe the population as each animal was updated.
+class AnimalHistograms
+{
+public:
+    static const size_t SPECIES_COUNT = 2; // Herbivores, carnivores
+    static const size_t HISTOGRAM_COUNT = static_cast<size_t>(AnimalHistogram::COUNT);
+    static const size_t BINS_PER_SPECIES = 10 + 10 + 8 + 5 + 10;
+
+private:
+    std::array<std::uint32_t, SPECIES_COUNT * BINS_PER_SPECIES> counts{};
+    bool anyCounts = false; // Whether any bin may be non-zero (plant tiles never record, so absorbing them is skipped)
+
+    // Gets the position of one bin in the counts (species must be HERBIVORE or CARNIVORE).
+    static size_t indexOf(EntityType species, AnimalHistogram histogram, size_t binIndex);
+
+public:
+    // Adds an animal's current energy, age, meals missed and gestation state.
+    void recordState(const Animal &animal);
+    // Adds the age an animal reached when it died.
+    void recordDeath(const Animal &animal);
+    // Adds another month's (or tile's) counts; an empty one costs nothing.
+    void absorb(const AnimalHistograms &other);
+    // Empties every bin.
+    void clear();
+    // Checks whether nothing has been counted since the last clear.
+    bool isEmpty() const { return !anyCounts; }
+
+    // Gets the count of one bin.
+    std::uint32_t getCount(EntityType species, AnimalHistogram histogram, size_t binIndex) const;
+    // Gets every count, species by species and histogram by histogram.
+    const std::array<std::uint32_t, SPECIES_COUNT * BINS_PER_SPECIES> &getCounts() const { return counts; }
+    // Overwrites every count (same order as getCounts), e.g. when reading a saved history.
+    void setCounts(const std::array<std::uint32_t, SPECIES_COUNT * BINS_PER_SPECIES> &counts_val)
+    {
+        counts = counts_val;
+        anyCounts = true;
+    }
+    // Gets the number of bins of a histogram.
+    static size_t getBinCount(AnimalHistogram histogram);
+    // Gets the CSV name of a histogram.
+    static const char *getHistogramName(AnimalHistogram histogram);
+
+    // Writes the CSV header line (one row per month, species, histogram and bin).
+    static void writeCsvHeader(std::ostream &out);
+    // Writes the CSV rows of one month.
+    void writeCsvRows(std::ostream &out, size_t month) const;
+};
+
+#endif // ANIMALHISTOGRAMS_H
@@ -0,0 +1,61 @@
+// ansiRenderer.h
+#ifndef ANSIRENDERER_H
+#define ANSIRENDERER_H
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <iosfwd>
+
+class Grid;
+
+// Draws the grid on an ANSI/VT100 terminal, sending only what changed. The grid stays at
+// the top of the screen in the layout of Grid::display, and the lines below it become a
+// scroll region for the text printed after each frame (month banner, statistics, prompts).
+// Every frame after the first moves the cursor to each cell whose symbol changed and
+// rewrites just that symbol (a run of changed neighbours shares one cursor move). The whole
+// screen is redrawn for the first frame, when the grid's shape changes, and when more than
+// fullRedrawFraction of the cells changed.
+//
+// When standard output is a terminal too small for the frame (its rows plus three lines, or
+// its widest line), the scroll region and cursor moves would land off screen or on wrapped
+// lines, so the frame is printed plainly, as Grid::display does, and the first frame that
+// fits again is drawn in full. Output that is not a terminal is always drawn in place.
+class AnsiRenderer
+{
+private:
+    double fullRedrawFraction;
+    std::vector<char> shown; // Symbols on the terminal now
+    std::vector<char> next;  // Symbols of the frame being drawn (reused)
+    int shownFirstRow;
+    int shownWidth;
+    bool hasFrame;
+    std::string frame;  // Escape sequences and symbols of the frame being drawn (reused)
+    std::string layout; // Grid::renderSymbols output of a full redraw (reused)
+    size_t fullRedraws;
+    size_t partialRedraws;
+    size_t cellsRedrawn;
+    size_t plainFrames;
+
+public:
+    // AnsiRenderer constructor (the first frame is always drawn in full).
+    explicit AnsiRenderer(double fullRedrawFraction_val = 0.5);
+
+    // Draws the grid's owned rows and leaves the cursor on the first line below it.
+    void render(std::ostream &out, const Grid &grid);
+    // Same, for symbols taken with Grid::symbolSnapshot.
+    void render(std::ostream &out, const std::vector<char> &symbols, int firstRow, int width);
+    // Releases the scroll region (keeping the cursor where it is); the next frame is drawn in full.
+    void finish(std::ostream &out);
+
+    // Gets the number of frames drawn in full.
+    size_t getFullRedraws() const { return fullRedraws; }
+    // Gets the number of frames that only rewrote changed cells.
+    size_t getPartialRedraws() const { return partialRedraws; }
+    // Gets the number of cells rewritten by partial frames.
+    size_t getCellsRedrawn() const { return cellsRedrawn; }
+    // Gets the number of frames printed plainly because they did not fit the terminal.
+    size_t getPlainFrames() const { return plainFrames; }
+};
+
+#endif // ANSIRENDERER_H
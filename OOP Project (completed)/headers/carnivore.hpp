@@ -6,7 +6,7 @@
 
 // Forward declarations
 class Grid;
-struct MonthlyStats;
+struct StatsShard;
 class Herbivore; // For casting in attemptEat
 
 // Represents carnivore entities in the simulation.
@@ -14,18 +14,20 @@ class Carnivore : public Animal
 {
 public:
     // Carnivore constructor.
-    Carnivore(int r_coord, int c_coord, Gender gender_val);
+    Carnivore(int r_coord, int c_coord, Gender gender_val, const AnimalParams &params = CARNIVORE_DEFAULTS);
 
     // Gets the species name ("Carnivore").
     std::string getSpeciesName() const override;
     // Carnivore's attempt to eat.
-    bool attemptEat(Grid &grid, MonthlyStats &stats, Season currentSeason) override;
-    // Carnivore's movement logic.
-    void move(Grid &grid, MonthlyStats &stats, Season currentSeason) override;
+    bool attemptEat(Grid &grid, StatsShard &stats, Season currentSeason) override;
+    // Carnivore's meal: gains energy, kills the prey and counts it.
+    void eatPrey(Entity &prey, StatsShard &stats) override;
+    // Carnivore's movement choice, computed without changing the grid.
+    MoveIntent planMove(const Grid &grid, Season currentSeason) const override;
     // Carnivore's attempt to reproduce.
-    void attemptReproduce(Grid &grid, MonthlyStats &stats, const std::vector<std::shared_ptr<Animal>> &potentialMates, Season currentSeason) override;
+    void attemptReproduce(Grid &grid, StatsShard &stats, const std::vector<std::shared_ptr<Animal>> &potentialMates, Season currentSeason) override;
     // Carnivore's logic for giving birth.
-    void giveBirth(Grid &grid, MonthlyStats &stats) override;
+    void giveBirth(Grid &grid, StatsShard &stats) override;
 };
 
 #endif // CARNIVORE_H
\ No newline at end of file
@@ -0,0 +1,67 @@
+// checkpoint.h
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <iosfwd>
+#include "constants.hpp"     // For Season
+#include "speciesParams.hpp" // For AnimalParams, PlantParams
+#include "entityRecord.hpp"
+#include "statsHistory.hpp"
+
+// One saved entity and where the grid held it.
+struct CheckpointEntity
+{
+    EntityRecord record;
+    bool listed; // In its species' list; unlisted ones died but still fill their cell
+    bool inCell; // Its cell holds it (a plant an animal moved onto stays listed, off its cell)
+};
+
+// Everything a simulation needs to carry on exactly where it stopped: every entity the grid
+// holds in a list or a cell, the month counters, the generator and the statistics of the months run so far.
+// Settings that only change how a run is executed or reported (threads, output, tracing,
+// heatmaps) are not part of it; they come from the restoring simulation.
+//
+// Binary format (all integers little-endian, doubles as their IEEE-754 bits):
+//   "ECOCHKPT", uint32 version (1),
+//   int32 grid height and width, uint64 next entity id and id stride,
+//   int32 total months, int32 months run, int32 month index in the year, uint8 season,
+//   uint8 northern hemisphere, uint8 carnivores starved last month,
+//   uint32 length and bytes of the end reason,
+//   uint32 count and words of the generator state,
+//   herbivore, carnivore and plant parameters,
+//   uint64 entity count and the entities (plants, herbivores, carnivores, each in list order,
+//   then the unlisted ones left in cells, row by row),
+//   then the statistics history in its own binary format (see StatsHistory).
+// An entity is uint8 flags (1 = listed, 2 = in its cell), uint64 id, int32 row and column,
+// uint8 type and gender, then either the plant's parameters and int32 age or the animal's
+// parameters and state.
+struct SimulationCheckpoint
+{
+    int gridHeight = 0;
+    int gridWidth = 0;
+    unsigned long long nextEntityId = 1;
+    unsigned long long entityIdStride = 1;
+    int totalMonths = 0;
+    int monthsRun = 0;
+    int monthIndexInYear = 0;
+    Season season = Season::NONE;
+    bool northernHemisphere = true;
+    bool carnivoresStarvedPreviousMonth = false;
+    std::string endReason;
+    std::vector<std::uint32_t> generatorState; // The numbers std::mt19937 writes to a stream, in order
+    AnimalParams herbivoreParams = HERBIVORE_DEFAULTS;
+    AnimalParams carnivoreParams = CARNIVORE_DEFAULTS;
+    PlantParams plantParams = PLANT_DEFAULTS;
+    std::vector<CheckpointEntity> entities;
+    StatsHistory history;
+
+    // Writes the binary format described above; returns false if the stream failed.
+    bool writeBinary(std::ostream &out) const;
+    // Replaces this checkpoint with one read in the binary format; on failure error explains why.
+    bool readBinary(std::istream &in, std::string &error);
+};
+
+#endif // CHECKPOINT_H
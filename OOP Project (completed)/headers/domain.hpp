@@ -0,0 +1,130 @@
+// domain.h
+#ifndef DOMAIN_H
+#define DOMAIN_H
+
+#include <vector>
+#include <string>
+#include <utility>
+#include <iosfwd>
+#include "simulationConfig.hpp"
+#include "entityRecord.hpp"
+
+// Forward declarations
+class Grid;
+struct MonthlyStats;
+struct StatsShard;
+
+// Hooks that let a Simulation run one subdomain of a world split across processes.
+class DomainExchange
+{
+public:
+    virtual ~DomainExchange() = default;
+    // Settles ghosts eaten last phase (crediting granted meals to stats), hands off entities that
+    // crossed into the halo and refreshes the halo (called before every phase).
+    virtual void beforePhase(Grid &grid, StatsShard &stats) = 0;
+    // Checks whether this subdomain handles migration in the given month (subdomains take turns).
+    virtual bool runsMigration(int month) const = 0;
+    // Reports the month's statistics; returns false (and sets endReason) when the whole world should stop.
+    virtual bool finishMonth(const MonthlyStats &stats, std::string &endReason) = 0;
+};
+
+// Month figures of one subdomain, or of the whole world once summed by the coordinator.
+struct DomainMonthReport
+{
+    int plants = 0;
+    int herbivores = 0;
+    int carnivores = 0;
+    int plantsEaten = 0;
+    int herbivoresEaten = 0;
+    int herbivoresSpawned = 0;
+    int carnivoresSpawned = 0;
+    int handedOff = 0;    // Entities sent to a neighbouring subdomain
+    int heldHandoffs = 0; // Received entities still waiting for a free cell (included in the counts above)
+    int refusedClaims = 0; // Ghosts eaten here that their owner had already lost (the meal did not count)
+};
+
+// Decision the coordinator sends every subdomain after each month.
+struct DomainDecision
+{
+    int keepRunning;
+    char endReason[96];
+};
+
+// One subdomain process's side of the decomposition. Before every phase it talks to the stripe
+// above and the stripe below in two rounds. First it claims the ghosts its animals ate and
+// grants or refuses the neighbours' claims on its own entities: a claim is granted only if
+// the entity is still alive here, so an entity eaten on both sides of a border in the same
+// phase is eaten once, and the eater is credited only for a granted claim. Then it sends the
+// entities that crossed the border (with their full state) and copies of its own boundary
+// rows, which the neighbour keeps as read-only ghosts in its halo. Arrivals with no free
+// owned cell near their position are held and retried at every later exchange. Neighbour
+// pairs always talk in the same order (the lower rank sends first), so it cannot deadlock.
+class SubdomainExchange : public DomainExchange
+{
+private:
+    int rank;
+    int rankCount;
+    int upperFd;   // Socket to rank - 1, or -1
+    int lowerFd;   // Socket to rank + 1, or -1
+    int controlFd; // Socket to the coordinator
+    int haloRows;
+    int handedOff;     // Since the last month report
+    int refusedClaims; // Since the last month report
+    std::vector<EntityRecord> heldArrivals; // Handed off here but not yet placed
+
+    // Sends outgoing to a neighbour and receives its message, in the order agreed for the pair.
+    void swapWith(int fd, bool sendFirst, const std::vector<char> &outgoing, std::vector<char> &incoming);
+    // Sends one message to each neighbour and receives theirs (pairs of ranks take turns).
+    void swapWithNeighbours(const std::vector<char> &toUpper, const std::vector<char> &toLower,
+                            std::vector<char> &fromUpper, std::vector<char> &fromLower);
+    // Claims the ghosts eaten here, grants the neighbours' claims and credits the granted meals.
+    void settleClaims(Grid &grid, StatsShard &stats);
+    // Removes the owned entities a neighbour claimed that are still alive; returns the ids removed.
+    std::vector<unsigned long long> grantClaims(Grid &grid, const std::vector<unsigned long long> &claims);
+    // Lists an entity handed off by a neighbour in the nearest free owned cell; false if there is none.
+    bool landArrival(Grid &grid, const EntityRecord &record);
+    // Lists entities handed off by a neighbour, holding those that cannot land yet.
+    void adoptEmigrants(Grid &grid, const std::vector<EntityRecord> &arrivals);
+
+public:
+    // SubdomainExchange constructor (the sockets must already be connected).
+    SubdomainExchange(int rank, int rankCount, int upperFd, int lowerFd, int controlFd, int haloRows);
+
+    void beforePhase(Grid &grid, StatsShard &stats) override;
+    bool runsMigration(int month) const override;
+    bool finishMonth(const MonthlyStats &stats, std::string &endReason) override;
+};
+
+// Outcome of a decomposed run, as seen by the coordinator.
+struct DomainRunResult
+{
+    bool succeeded = false;
+    std::string error;
+    int monthsRun = 0;
+    std::string endReason; // Empty if the run lasted its full length.
+    std::vector<DomainMonthReport> months; // World totals per month
+};
+
+// Splits the grid into full-width horizontal stripes and runs each one in its own forked
+// process, connected to its neighbours by local socket pairs; the calling process becomes
+// the coordinator that sums month reports and decides when the world stops.
+class DomainDecomposition
+{
+private:
+    int processCount;
+
+public:
+    // DomainDecomposition constructor.
+    explicit DomainDecomposition(int processCount);
+
+    // Halo depth that keeps every neighbourhood read of an owned animal inside the stored rows.
+    static int haloRowsFor(const SimulationConfig &config);
+    // Gets the rows [first, second) owned by a rank.
+    std::pair<int, int> stripeRows(int rank, int gridHeight) const;
+    // Checks that every stripe is at least twice as tall as the halo and that no option writes one file per run.
+    bool validate(const SimulationConfig &config, std::string &error) const;
+    // Forks the subdomains, coordinates them month by month and prints world totals to out.
+    DomainRunResult run(const SimulationConfig &config, std::ostream &out);
+};
+
+#endif // DOMAIN_H
@@ -0,0 +1,89 @@
+// ensemble.h
+#ifndef ENSEMBLE_H
+#define ENSEMBLE_H
+
+#include <vector>
+#include <string>
+#include <array>
+#include <iosfwd>
+#include "simulationConfig.hpp"
+
+// Population counts (plants, herbivores, carnivores) at the end of every month of one run.
+struct MemberTrajectory
+{
+    std::vector<std::array<int, 3>> monthlyPopulations;
+    std::string endReason; // Empty if the run lasted its full length.
+    std::string writeError; // Why a file of the member could not be written (empty if all were)
+};
+
+// Spread of one population over the members still running in a month.
+struct PopulationAggregate
+{
+    double mean = 0.0;
+    double stdDev = 0.0;
+    int min = 0;
+    int max = 0;
+};
+
+// Population figures of one month aggregated over the ensemble.
+struct EnsembleMonthSummary
+{
+    int month;
+    int membersRunning;
+    PopulationAggregate plants;
+    PopulationAggregate herbivores;
+    PopulationAggregate carnivores;
+};
+
+// Outcome of an ensemble run.
+struct EnsembleResult
+{
+    std::vector<EnsembleMonthSummary> months;
+    int members = 0;
+    int membersEndedEarly = 0;
+    int membersNotWritten = 0;   // Members whose files could not be written
+    std::string firstWriteError; // Why the first of them failed
+    double wallSeconds = 0.0;
+    double runsPerSecond = 0.0;
+};
+
+// Runs many independent copies of one scenario, each with its own seed, on a thread pool.
+// Every member owns its Simulation, generator and output stream, so members never share
+// state; member i is seeded with deriveSeed(scenario.seed, i) and gives the same result
+// whatever the thread count. Each member runs on one worker that is never pinned (the
+// scenario's pin-threads and numa-placement are ignored), so members spread over the CPUs.
+class EnsembleRunner
+{
+private:
+    SimulationConfig scenario;
+    int memberCount;
+    int threadCount;
+    std::string memberLogDirectory; // Empty discards member output
+    std::string memberHistoryDirectory; // Empty keeps no per-member statistics history
+
+public:
+    // EnsembleRunner constructor.
+    EnsembleRunner(const SimulationConfig &scenario_val, int memberCount_val, int threadCount_val);
+
+    // Writes each member's full output to <directory>/member_<i>.log instead of discarding it.
+    void setMemberLogDirectory(const std::string &directory);
+    // Writes each member's month-by-month statistics to <directory>/member_<i>.stats (see StatsHistory).
+    void setMemberHistoryDirectory(const std::string &directory);
+    // Checks the scenario, including that no option writes one file all members would share.
+    bool validate(std::string &error) const;
+    // Runs all members and aggregates their monthly populations.
+    EnsembleResult run() const;
+
+    // Runs one simulation to completion and records its monthly populations
+    // (and, given a path, saves its statistics history there in the binary format;
+    // writeError tells if that failed).
+    static MemberTrajectory runMember(const SimulationConfig &config, std::ostream *output, const std::string &historyPath = "");
+    // Gets the seed used for a member of an ensemble.
+    static unsigned int memberSeed(unsigned int baseSeed, int memberIndex);
+    // Aggregates member trajectories month by month.
+    static std::vector<EnsembleMonthSummary> aggregate(const std::vector<MemberTrajectory> &trajectories);
+    // Prints the per-month table and the throughput summary.
+    static void report(const EnsembleResult &result, std::ostream &out);
+};
+
+#endif // ENSEMBLE_H
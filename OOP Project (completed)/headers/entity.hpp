@@ -6,7 +6,7 @@
 #include <memory> // For std::shared_ptr (used in derived classes and Grid)
 #include "constants.hpp" // For EntityType, Gender, Season
 // Forward declaration
-struct MonthlyStats; 
+struct StatsShard;
 class Grid;
 
 
@@ -19,6 +19,7 @@ private:
     EntityType entityType;
     char displaySymbol;
     bool is_alive;
+    unsigned long long entityId; // Assigned by the Grid when the entity is first placed; 0 until then.
 
 public:
     // Entity constructor.
@@ -27,7 +28,7 @@ public:
     virtual ~Entity() = default;
 
     // Pure virtual function for updating entity state.
-    virtual void update(Grid &grid, MonthlyStats &stats, Season currentSeason) = 0;
+    virtual void update(Grid &grid, StatsShard &stats, Season currentSeason) = 0;
     
     // Getters
     int getR() const;
@@ -35,11 +36,13 @@ public:
     EntityType getType() const;
     char getSymbol() const;
     bool isAlive() const;
+    unsigned long long getId() const;
 
     // Setters/Modifiers
     void setR(int r_val);
     void setC(int c_val);
     void kill(); // Marks the entity as not alive.
+    void setId(unsigned long long id_val);
     
     // Gets the gender of the entity (default for non-animals).
     virtual Gender getGender() const;
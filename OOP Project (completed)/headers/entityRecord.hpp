@@ -0,0 +1,29 @@
+// entityRecord.h
+#ifndef ENTITYRECORD_H
+#define ENTITYRECORD_H
+
+#include "constants.hpp"     // For EntityType, Gender
+#include "speciesParams.hpp" // For AnimalParams, PlantParams
+#include "animal.hpp"        // For AnimalState
+#include <memory>
+
+// Flat, trivially copyable copy of one entity: enough to rebuild it in another process or file.
+struct EntityRecord
+{
+    unsigned long long id;
+    int r;
+    int c;
+    EntityType type;
+    Gender gender;
+    AnimalParams animalParams; // Animals only
+    AnimalState animalState;   // Animals only
+    PlantParams plantParams;   // Plants only
+    int plantAge;              // Plants only
+};
+
+// Captures the full state of an entity.
+EntityRecord makeEntityRecord(const Entity &entity);
+// Rebuilds a living entity (same id, position and state) from a record.
+std::shared_ptr<Entity> rebuildEntity(const EntityRecord &record);
+
+#endif // ENTITYRECORD_H
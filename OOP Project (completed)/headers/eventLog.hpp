@@ -0,0 +1,140 @@
+// eventLog.h
+#ifndef EVENTLOG_H
+#define EVENTLOG_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm> // For std::min
+#include "constants.hpp" // For EntityType
+
+// What happened in a monthly event.
+enum class EventKind : std::uint8_t
+{
+    ATE,        // subject ate other (a plant or a herbivore)
+    MATED,      // subject (the female) mated with other
+    BORN,       // subject was born to other (the mother)
+    IMMIGRATED, // subject arrived from outside the grid
+    EMIGRATED   // subject left the grid
+};
+
+// Event categories, combined into a bit mask to choose which events are recorded.
+const unsigned int EVENTS_FEEDING = 1u << 0;   // ATE
+const unsigned int EVENTS_BIRTHS = 1u << 1;    // BORN
+const unsigned int EVENTS_MATING = 1u << 2;    // MATED
+const unsigned int EVENTS_MIGRATION = 1u << 3; // IMMIGRATED, EMIGRATED
+const unsigned int EVENTS_NONE = 0;
+const unsigned int EVENTS_ALL = EVENTS_FEEDING | EVENTS_BIRTHS | EVENTS_MATING | EVENTS_MIGRATION;
+
+// Gets the category an event kind belongs to.
+inline unsigned int eventCategoryOf(EventKind kind)
+{
+    switch (kind)
+    {
+    case EventKind::ATE: return EVENTS_FEEDING;
+    case EventKind::BORN: return EVENTS_BIRTHS;
+    case EventKind::MATED: return EVENTS_MATING;
+    default: return EVENTS_MIGRATION;
+    }
+}
+
+// Parses "all", "none" or a comma-separated list of feeding, births, mating and migration.
+bool parseEventMask(const std::string &text, unsigned int &mask);
+
+// Records an event in a StatsShard. Building with ECOSIM_DISABLE_EVENTS removes every event
+// site from the update code, arguments included, leaving only the counters.
+#ifdef ECOSIM_DISABLE_EVENTS
+#define ECOSIM_RECORD_EVENT(shard, ...) ((void)(shard))
+#else
+#define ECOSIM_RECORD_EVENT(shard, ...) (shard).recordEvent(__VA_ARGS__)
+#endif
+
+// One monthly event as a fixed-size record. Nothing is formatted when an event is
+// recorded; formatEvent builds the text only when the events are displayed or exported.
+struct EventRecord
+{
+    EventKind kind;
+    EntityType species;           // Species of the subject
+    int month;                    // Simulation month the event happened in (1-based)
+    int r, c;                     // Position of the subject
+    int otherR, otherC;           // Position of the other entity (-1 if there is none)
+    unsigned long long subjectId;
+    unsigned long long otherId;   // 0 if there is no other entity (or it was never listed)
+};
+
+// Builds the display text of an event (the same wording the monthly report has always used).
+std::string formatEvent(const EventRecord &event);
+
+// Fixed-capacity arena of event records. Storage for capacity records is allocated once, by
+// setCapacity or at the first append (a log nothing is recorded into, like a plant tile's,
+// allocates nothing), and never grows: events past the capacity are only counted as
+// dropped. Clearing keeps the storage, so recording an event is always a plain copy into
+// memory that is already there. The month's counters are kept whatever is dropped.
+class EventLog
+{
+public:
+    static const size_t DEFAULT_CAPACITY = 65536; // Events kept per month unless configured
+
+private:
+    std::vector<EventRecord> records; // Reserved to capacity, never reallocated
+    size_t capacity = DEFAULT_CAPACITY;
+    size_t dropped = 0; // Events that did not fit since the last clear
+
+public:
+    // Sets the most events kept until the next clear and allocates their storage now.
+    void setCapacity(size_t capacity_val)
+    {
+        capacity = capacity_val;
+        if (records.size() > capacity)
+            records.resize(capacity);
+        if (records.capacity() != capacity)
+        {
+            std::vector<EventRecord> resized;
+            resized.reserve(capacity);
+            resized.assign(records.begin(), records.end());
+            records.swap(resized);
+        }
+    }
+    size_t getCapacity() const { return capacity; }
+    // Appends one event, or counts it as dropped if the log is full.
+    void append(const EventRecord &event)
+    {
+        if (records.size() >= capacity)
+        {
+            dropped++;
+            return;
+        }
+        if (records.capacity() < capacity)
+            records.reserve(capacity); // First event: the only allocation
+        records.push_back(event);
+    }
+    // Appends every event of another log, in order, as far as they fit; the rest and the other
+    // log's own dropped events are counted as dropped.
+    void appendAll(const EventLog &other)
+    {
+        const size_t fitting = std::min(other.records.size(), capacity - std::min(capacity, records.size()));
+        if (fitting > 0 && records.capacity() < capacity)
+            records.reserve(capacity);
+        records.insert(records.end(), other.records.begin(), other.records.begin() + static_cast<std::ptrdiff_t>(fitting));
+        dropped += other.records.size() - fitting + other.dropped;
+    }
+    // Drops all events but keeps the storage for the next month.
+    void clear()
+    {
+        records.clear();
+        dropped = 0;
+    }
+
+    bool empty() const { return records.empty(); }
+    size_t size() const { return records.size(); }
+    // Gets the number of events that did not fit since the last clear.
+    size_t getDroppedCount() const { return dropped; }
+    // Gets the bytes reserved for records (kept across clear()).
+    size_t getStorageBytes() const { return records.capacity() * sizeof(EventRecord); }
+    const EventRecord &operator[](size_t index) const { return records[index]; }
+    std::vector<EventRecord>::const_iterator begin() const { return records.begin(); }
+    std::vector<EventRecord>::const_iterator end() const { return records.end(); }
+};
+
+#endif // EVENTLOG_H
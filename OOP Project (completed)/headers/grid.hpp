@@ -5,8 +5,10 @@
 #include <vector>
 #include <algorithm>
 #include <memory> // For std::shared_ptr
-#include <string> // For display/events (indirectly via MonthlyStats)
+#include <string> // For display/events (indirectly via StatsShard)
 #include <iomanip> // For display formatting
+#include <iostream> // For the default display stream
+#include <unordered_set> // For ghost ids
 #include "constants.hpp" // For GRID_WIDTH, GRID_HEIGHT, EntityType, etc.
 
 // Forward declarations
@@ -15,24 +17,83 @@ class Plant;
 class Herbivore;
 class Carnivore;
 class Animal; // Animal needed for addMigratingAnimal
-struct MonthlyStats;
+struct StatsShard;
+
+// A ghost an animal of this grid wants to eat. Only the owning subdomain can remove the real
+// entity, so the meal is credited to the eater once the owner grants the claim.
+struct GhostClaim
+{
+    std::shared_ptr<Entity> ghost; // Off its halo cell, still alive until the meal is credited
+    Animal *eater;                 // Listed here at least until the month-end cleanup
+};
 
 // Manages the simulation grid and entities within it.
 class Grid
 {
 private:
-    std::vector<std::vector<std::shared_ptr<Entity>>> cells_grid; // Renamed to avoid conflict
+    int gridHeight;
+    int gridWidth;
+    int ownedRowBegin;  // First row whose entities this grid updates
+    int ownedRowEnd;    // One past the last owned row
+    int storedRowBegin; // First row held in cells_grid (owned rows plus halo)
+    int storedRowEnd;   // One past the last stored row
+    std::vector<std::shared_ptr<Entity>> cells_grid; // Row-major, stored rows * gridWidth cells
+    std::vector<std::shared_ptr<Entity>> frozen_cells; // Cells as a synchronous month began (kept in step between months)
+    bool synchronousReads; // Whether neighbourhood reads come from frozen_cells instead of cells_grid
     std::vector<std::shared_ptr<Plant>> plants_list; // Renamed
     std::vector<std::shared_ptr<Herbivore>> herbivores_list; // Renamed
     std::vector<std::shared_ptr<Carnivore>> carnivores_list; // Renamed
+    unsigned long long nextEntityId; // Next identifier handed out to a newly listed entity
+    unsigned long long entityIdStride; // Step between identifiers (> 1 when several grids share an id space)
+    std::unordered_set<unsigned long long> ghostIds; // Halo copies of entities owned by a neighbouring subdomain
+    std::vector<GhostClaim> ghostClaims; // Ghosts eaten since the last exchange, waiting for their owner
+
+    // Converts coordinates into an index into cells_grid (coordinates must be stored).
+    size_t cellIndex(int r_coord, int c_coord) const { return static_cast<size_t>(r_coord - storedRowBegin) * gridWidth + c_coord; }
+    // Gets the cells that reads see: last month's frozen copy in synchronous mode, the live cells otherwise.
+    const std::vector<std::shared_ptr<Entity>> &readCells() const { return synchronousReads ? frozen_cells : cells_grid; }
+    // Checks if a cell is empty both for reads and in the live cells (the only cells a write may claim).
+    bool isFreeForWrite(int r_coord, int c_coord) const;
+    // Copies the live cells that differ from the frozen copy into it.
+    void syncFrozenCells();
+    // Checks if a valid cell lies in the stored rows of this grid.
+    bool isStored(int r_coord, int c_coord) const { return isValid(r_coord, c_coord) && r_coord >= storedRowBegin && r_coord < storedRowEnd; }
 
 public:
     // Grid constructor.
-    Grid();
+    Grid(int height_val = GRID_HEIGHT, int width_val = GRID_WIDTH);
+    // Subdomain constructor: owns rows [rowBegin, rowEnd) and also stores haloRows rows on either side.
+    Grid(int height_val, int width_val, int rowBegin, int rowEnd, int haloRows);
     
+    // Gets the number of rows in the grid.
+    int getHeight() const;
+    // Gets the number of columns in the grid.
+    int getWidth() const;
+    // Gets the maximum number of entities the grid can hold.
+    int getMaxPopulation() const;
+    // Gets the first row owned by this grid (0 unless it is a subdomain).
+    int getOwnedRowBegin() const;
+    // Gets one past the last row owned by this grid.
+    int getOwnedRowEnd() const;
+    // Gets the first row stored by this grid, including the halo.
+    int getStoredRowBegin() const;
+    // Gets one past the last stored row, including the halo.
+    int getStoredRowEnd() const;
+    // Gets the number of cells in the owned rows.
+    int getOwnedCellCount() const;
+    // Checks if a row is owned (updated) by this grid rather than being halo.
+    bool isOwnedRow(int r_coord) const;
+    // Gets the first cell of a stored row, for placing the row's memory (see NumaPlacement).
+    const std::shared_ptr<Entity> *storedRow(int r_coord) const;
+    // Gets the bytes reserved for the cells (and their synchronous-month copy).
+    size_t getCellStorageBytes() const;
+    // Gets the bytes reserved by the plant, herbivore and carnivore lists.
+    size_t getListStorageBytes() const;
+
     // Checks if given coordinates are within grid boundaries.
     bool isValid(int r_coord, int c_coord) const;
-    // Checks if a cell at given coordinates is empty.
+    // Checks if a cell at given coordinates is empty (cells outside the stored rows never are).
+    // In synchronous mode this and getEntity describe the grid as it was when the month began.
     bool isEmpty(int r_coord, int c_coord) const;
     // Retrieves the entity at given coordinates.
     std::shared_ptr<Entity> getEntity(int r_coord, int c_coord) const;
@@ -42,12 +103,56 @@ public:
     // Adds a migrating animal to a random empty cell.
     bool addMigratingAnimal(const std::shared_ptr<Animal> &animal_ptr);
     // Removes an entity from the grid and lists.
-    void removeEntity(const std::shared_ptr<Entity> &entity_ptr, MonthlyStats &stats);
-    // Moves an entity from its current position to new coordinates.
-    void moveEntity(const std::shared_ptr<Entity> &entity_ptr, int newR, int newC);
+    void removeEntity(const std::shared_ptr<Entity> &entity_ptr, StatsShard &stats);
+    // Moves an entity from its current position to new coordinates; returns false if the move was refused
+    // (only in synchronous mode, when another animal already claimed the cell this month).
+    bool moveEntity(const std::shared_ptr<Entity> &entity_ptr, int newR, int newC);
+    // Places an entity in its empty cell without listing it (used by parallel phases).
+    bool placeInCell(const std::shared_ptr<Entity> &entity);
+    // Lists plants that were already placed with placeInCell.
+    void adoptPlacedPlants(const std::vector<std::shared_ptr<Plant>> &placed);
+    // Puts back an entity read from a checkpoint with its id: lists it if listed and places it in
+    // its cell if inCell; returns false if it is off the grid or the cell is taken.
+    bool restoreEntity(const std::shared_ptr<Entity> &entity, bool listed, bool inCell);
+
+    // Starts a synchronous month: reads see a frozen copy of the current cells, writes go to the live cells.
+    void beginSynchronousMonth();
+    // Ends a synchronous month: reads see the live cells again, and the frozen copy catches up with them.
+    void endSynchronousMonth();
+    // Checks whether reads currently come from the frozen copy.
+    bool isSynchronous() const;
+
+    // Makes newly listed entities take ids first, first + stride, first + 2 * stride, ...
+    void setEntityIdSequence(unsigned long long first, unsigned long long stride);
+    // Gets the id the next newly listed entity takes.
+    unsigned long long getNextEntityId() const;
+    // Gets the step between identifiers.
+    unsigned long long getEntityIdStride() const;
+    // Places a read-only copy of a neighbour's entity in a halo cell (it is never listed or updated here).
+    bool placeGhost(const std::shared_ptr<Entity> &ghost);
+    // Unlists and returns the living entities of this grid that moved or were born into halo rows.
+    std::vector<std::shared_ptr<Entity>> takeEmigrants();
+    // Empties every halo cell and forgets all ghosts.
+    void clearHalo();
+    // Checks whether an entity is a halo copy of a neighbour's entity.
+    bool isGhost(const Entity &entity) const;
+    // Takes a ghost off its halo cell so nothing else eats it, and queues the claim for its owner.
+    void claimGhost(const std::shared_ptr<Entity> &ghost, Animal &eater);
+    // Returns the ghosts claimed since the last call, e.g. plants eaten across the border.
+    std::vector<GhostClaim> takeGhostClaims();
     
     // Displays the current state of the grid.
-    void display() const;
+    void display(std::ostream &out = std::cout) const;
+    // Copies the display symbol of every owned cell, row-major ('*' for empty cells).
+    std::vector<char> symbolSnapshot() const;
+    // Same, into a buffer whose storage is reused from frame to frame.
+    void symbolSnapshot(std::vector<char> &symbols) const;
+    // Prints symbols taken with symbolSnapshot in the same layout as display, as one write.
+    static void displaySymbols(std::ostream &out, const std::vector<char> &symbols, int firstRow, int width);
+    // Lays symbols out as display prints them, replacing the contents of frame (its capacity is kept).
+    static void renderSymbols(std::string &frame, const std::vector<char> &symbols, int firstRow, int width);
+    // Gets the characters display takes for a row or column number (at least 2).
+    static size_t getLabelWidth(int value);
     // Gets a list of empty cells adjacent to given coordinates.
     std::vector<std::pair<int, int>> getAdjacentEmptyCells(int r_coord, int c_coord) const;
     // Finds entities of a specific type within a given range of coordinates.
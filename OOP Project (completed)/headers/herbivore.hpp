@@ -6,25 +6,27 @@
 
 // Forward declarations
 class Grid;
-struct MonthlyStats;
+struct StatsShard;
 
 // Represents herbivore entities in the simulation.
 class Herbivore : public Animal
 {
 public:
     // Herbivore constructor.
-    Herbivore(int r_coord, int c_coord, Gender gender_val);
+    Herbivore(int r_coord, int c_coord, Gender gender_val, const AnimalParams &params = HERBIVORE_DEFAULTS);
     
     // Gets the species name ("Herbivore").
     std::string getSpeciesName() const override;
     // Herbivore's attempt to eat.
-    bool attemptEat(Grid &grid, MonthlyStats &stats, Season currentSeason) override;
-    // Herbivore's movement logic.
-    void move(Grid &grid, MonthlyStats &stats, Season currentSeason) override;
+    bool attemptEat(Grid &grid, StatsShard &stats, Season currentSeason) override;
+    // Herbivore's meal: gains energy, kills the prey and counts it.
+    void eatPrey(Entity &prey, StatsShard &stats) override;
+    // Herbivore's movement choice, computed without changing the grid.
+    MoveIntent planMove(const Grid &grid, Season currentSeason) const override;
     // Herbivore's attempt to reproduce.
-    void attemptReproduce(Grid &grid, MonthlyStats &stats, const std::vector<std::shared_ptr<Animal>> &potentialMates, Season currentSeason) override;
+    void attemptReproduce(Grid &grid, StatsShard &stats, const std::vector<std::shared_ptr<Animal>> &potentialMates, Season currentSeason) override;
     // Herbivore's logic for giving birth.
-    void giveBirth(Grid &grid, MonthlyStats &stats) override;
+    void giveBirth(Grid &grid, StatsShard &stats) override;
 };
 
 #endif // HERBIVORE_H
\ No newline at end of file
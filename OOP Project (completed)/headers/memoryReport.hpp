@@ -0,0 +1,63 @@
+// memoryReport.h
+#ifndef MEMORYREPORT_H
+#define MEMORYREPORT_H
+
+#include <array>
+#include <vector>
+#include <cstddef>
+#include <iosfwd>
+#include "constants.hpp" // For EntityType
+
+// Live entities of one species and the heap bytes each one takes.
+struct SpeciesMemory
+{
+    const char *species = "";
+    size_t count = 0;
+    size_t bytesEach = 0; // Object and shared_ptr control block, as requested from the allocator
+};
+
+// Where a simulation's memory goes (see Simulation::getMemoryReport), for sizing machines
+// before running worlds too large to try. "Tracked" bytes are the structures listed here;
+// peak RSS is everything the process touched, including allocator overhead.
+struct MemoryReport
+{
+    long long gridCells = 0;
+    std::array<SpeciesMemory, 3> species; // Plants, herbivores, carnivores
+    size_t cellStorageBytes = 0;    // Grid cells (and their synchronous copy)
+    size_t listStorageBytes = 0;    // Capacity of the entity lists
+    size_t eventStorageBytes = 0;   // Event records kept for reuse (fixed, whatever the grid size)
+    size_t historyStorageBytes = 0; // Per-month statistics history (fixed, whatever the grid size)
+    size_t peakRssBytes = 0;
+    bool allocationsCounted = false;               // Built with ECOSIM_COUNT_ALLOCATIONS
+    std::vector<unsigned long long> monthlyAllocations; // Heap allocations of each month, all threads
+
+    // Gets the bytes of every live entity.
+    size_t getEntityBytes() const;
+    // Gets the bytes of every structure listed in the report.
+    size_t getTrackedBytes() const;
+    // Gets the bytes that do not grow with the grid (events and history).
+    size_t getFixedBytes() const;
+    // Gets the bytes that grow with the grid (cells, entities and lists) per grid cell.
+    double getBytesPerCell() const;
+    // Gets the tracked bytes of a world of cells cells at the same density: the per-cell bytes
+    // scaled up, plus the fixed bytes once.
+    double getProjectedBytes(long long cells) const;
+    // Prints the report, with a projection to a 10^8-cell world at the same density.
+    void print(std::ostream &out) const;
+    // Writes the report as one JSON object.
+    void writeJson(std::ostream &out) const;
+};
+
+// Gets the heap bytes one entity of a type takes when made with std::make_shared.
+size_t sharedEntityBytes(EntityType type);
+// Gets the peak resident set size of the process.
+size_t peakResidentBytes();
+
+// Whether the counting operator new is built in (compile with -DECOSIM_COUNT_ALLOCATIONS).
+bool allocationCountingEnabled();
+// Gets the number of heap allocations made so far by every thread (0 if not counting).
+unsigned long long heapAllocationCount();
+// Gets the bytes requested by those allocations (0 if not counting).
+unsigned long long heapAllocatedBytes();
+
+#endif // MEMORYREPORT_H
@@ -6,6 +6,7 @@
 #include <vector>
 #include <iostream> // For display method
 #include <iomanip>  // For display formatting (if any)
+#include "statsShard.hpp"
 
 // Stores and manages monthly simulation statistics.
 struct MonthlyStats
@@ -28,7 +29,8 @@ private:
     int animalsEmigrated;
     std::string currentMonthName;
     std::string currentSeasonName;
-    std::vector<std::string> monthlyEvents;
+    EventLog monthlyEvents; // Formatted only when displayed
+    AnimalHistograms animalHistograms; // Exported with the history, not displayed
 
 public:
     // Constructor
@@ -37,7 +39,9 @@ public:
     // Resets all monthly statistical counters.
     void reset();
     // Displays all current monthly statistics.
-    void display() const;
+    void display(std::ostream &out = std::cout) const;
+    // Adds the counters and events gathered in a shard during the month.
+    void mergeShard(const StatsShard &shard);
 
     // Getters
     int getPlantsEaten() const;
@@ -57,27 +61,17 @@ public:
     int getAnimalsEmigrated() const;
     std::string getCurrentMonthName() const;
     std::string getCurrentSeasonName() const;
-    const std::vector<std::string>& getMonthlyEvents() const;
+    const EventLog& getMonthlyEvents() const;
+    const AnimalHistograms& getAnimalHistograms() const;
 
     // Setters / Modifiers
-    void incrementPlantsEaten();
-    void incrementPlantsDiedNaturalAge();
-    void incrementPlantsDiedWeather();
-    void incrementPlantsSpread();
     void setCurrentPlants(int count);
-    void incrementHerbivoresEaten();
-    void incrementHerbivoresDiedNatural();
-    void incrementHerbivoresSpawned();
     void setCurrentHerbivores(int count);
-    void incrementCarnivoresEaten();
-    void incrementCarnivoresDiedNatural();
-    void incrementCarnivoresSpawned();
     void setCurrentCarnivores(int count);
-    void incrementAnimalsImmigrated();
-    void incrementAnimalsEmigrated();
+    // Sets the most events kept per month and allocates their storage (see EventLog).
+    void setEventCapacity(size_t capacity);
     void setCurrentMonthName(const std::string& name);
     void setCurrentSeasonName(const std::string& name);
-    void addMonthlyEvent(const std::string& event);
 };
 
 #endif // MONTHLYSTATS_H
\ No newline at end of file
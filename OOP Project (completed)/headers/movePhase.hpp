@@ -0,0 +1,48 @@
+// movePhase.h
+#ifndef MOVEPHASE_H
+#define MOVEPHASE_H
+
+#include <vector>
+#include <memory>
+#include "constants.hpp"
+#include "animal.hpp" // For MoveIntent
+
+// Forward declarations
+class Grid;
+class ThreadPool;
+struct StatsShard;
+
+// A planned move together with the animal making it and its tie-break priority.
+struct PlannedMove
+{
+    std::shared_ptr<Animal> animal;
+    MoveIntent intent;
+    unsigned int priority;
+};
+
+// Two-phase alternative to the in-place animal update for one species:
+//   1. every animal eats, gives birth and mates in list order (as before),
+//   2. all survivors plan a target cell in parallel from the unchanged grid,
+//   3. a resolve pass lets only the highest-priority animal into each target
+//      cell; the others stay where they are and pay no movement cost.
+// Priorities are a hash of (entity id, month), so the outcome is the same for
+// any number of threads.
+class IntentMovePhase
+{
+private:
+    int planChunkSize; // Movers planned per task; each chunk draws from its own generator.
+
+public:
+    // IntentMovePhase constructor.
+    explicit IntentMovePhase(int planChunkSize_val = 256);
+
+    // Runs the update of the given animals for one month.
+    void run(Grid &grid, StatsShard &stats, Season currentSeason, ThreadPool &pool,
+             const std::vector<std::shared_ptr<Animal>> &animals, int month, unsigned int monthSeed) const;
+    // Settles collisions so at most one animal enters each cell and applies the winning moves.
+    static void resolveAndApply(Grid &grid, std::vector<PlannedMove> &moves);
+    // Gets the deterministic priority of an animal's move in the given month.
+    static unsigned int movePriority(unsigned long long entityId, int month);
+};
+
+#endif // MOVEPHASE_H
@@ -0,0 +1,54 @@
+// numaPlacement.h
+#ifndef NUMAPLACEMENT_H
+#define NUMAPLACEMENT_H
+
+#include <vector>
+#include <cstddef>
+#include <iosfwd>
+
+// Forward declarations
+class Grid;
+class ThreadPool;
+
+// Gets the number of NUMA nodes the kernel reports (1 if it reports none).
+int numaNodeCount();
+// Gets the NUMA node a CPU belongs to (0 if unknown).
+int numaNodeOfCpu(int cpu);
+// Gets the CPUs the calling thread may run on, spread round-robin over the NUMA nodes.
+std::vector<int> allowedCpusByNode();
+// Restricts the calling thread to the given CPUs; returns false if the kernel refused.
+bool pinCurrentThread(const std::vector<int> &cpus);
+
+// Pages of grid memory on each NUMA node.
+struct MemoryPlacement
+{
+    bool supported = false;                 // Whether the kernel could report page locations
+    std::vector<size_t> cellPagesPerNode;   // Pages holding the cell array
+    std::vector<size_t> entityPagesPerNode; // Pages holding listed entity objects
+    size_t unplacedPages = 0;               // Pages the kernel could not locate (not yet touched, or swapped out)
+};
+
+// Puts the memory of each stripe of tile rows on the NUMA node of the worker its plant-phase
+// tasks start on (see ParallelPlantPhase), so that worker reads its cells and entities from
+// local memory. The grid and its initial population are allocated by one thread, so their
+// pages already exist; they are migrated with move_pages rather than touched again. Entities
+// created later by a tile task are allocated by that task's worker and land locally anyway.
+class NumaPlacement
+{
+private:
+    int tileSize;
+
+public:
+    // NumaPlacement constructor (use the tile size of the plant phase).
+    explicit NumaPlacement(int tileSize_val = 64);
+
+    // Migrates the cell rows and entities of every stripe to its worker's node; returns the pages moved.
+    // Does nothing unless the pool's threads are pinned and the machine has more than one node.
+    size_t apply(const Grid &grid, const ThreadPool &pool) const;
+    // Asks the kernel where the grid's cells and entities currently live.
+    static MemoryPlacement survey(const Grid &grid);
+    // Prints a survey as a per-node table.
+    static void report(const MemoryPlacement &placement, std::ostream &out);
+};
+
+#endif // NUMAPLACEMENT_H
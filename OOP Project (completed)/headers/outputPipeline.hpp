@@ -0,0 +1,79 @@
+// outputPipeline.h
+#ifndef OUTPUTPIPELINE_H
+#define OUTPUTPIPELINE_H
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <iosfwd>
+#include <cstddef>
+#include "monthlyStats.hpp"
+
+class AnsiRenderer;
+
+// What the simulation does when the output thread falls behind and the queue is full.
+enum class OutputBackpressure
+{
+    BLOCK,      // Wait for the output thread (every month is printed)
+    DROP_OLDEST // Discard the oldest month still waiting (the newest month is always printed)
+};
+
+// Everything needed to print one month, copied off the simulation so it can be printed later.
+struct MonthSnapshot
+{
+    std::string header;             // Month banner printed before the grid
+    int firstRow = 0;               // Row number of the first row in cellSymbols
+    int width = 0;
+    std::vector<char> cellSymbols;  // Grid::symbolSnapshot() of the month
+    MonthlyStats stats;
+};
+
+// Prints month snapshots on its own thread so the simulation does not wait on the
+// terminal or disk. Snapshots go through a bounded queue; when it is full the producer
+// either blocks or drops the oldest queued month, depending on the backpressure policy.
+class OutputPipeline
+{
+private:
+    std::ostream &out;
+    size_t capacity;
+    OutputBackpressure policy;
+    AnsiRenderer *ansiRenderer; // Draws the grids in place when set (not owned)
+    std::deque<MonthSnapshot> queue;
+    std::mutex queueMutex;
+    std::condition_variable queueChanged;
+    bool stopping;
+    bool rendering; // The output thread is printing a snapshot it already took off the queue
+    size_t framesWritten;
+    size_t framesDropped;
+    std::thread consumer;
+
+    // Output thread: prints snapshots in order until stopped and drained.
+    void consume();
+
+public:
+    // OutputPipeline constructor (starts the output thread); grids are drawn through ansiRenderer_val
+    // if given, which only the output thread may use until the pipeline is destroyed.
+    OutputPipeline(std::ostream &out_val, size_t capacity_val, OutputBackpressure policy_val,
+                   AnsiRenderer *ansiRenderer_val = nullptr);
+    // Prints everything still queued, then stops the output thread.
+    ~OutputPipeline();
+    OutputPipeline(const OutputPipeline &) = delete;
+    OutputPipeline &operator=(const OutputPipeline &) = delete;
+
+    // Queues a month for printing, applying the backpressure policy if the queue is full.
+    void submit(MonthSnapshot snapshot);
+    // Waits until every queued month has been printed (call before writing to the stream directly).
+    void flush();
+    // Prints one snapshot the way Simulation::runMonth prints a month.
+    static void render(std::ostream &out, const MonthSnapshot &snapshot, AnsiRenderer *ansiRenderer = nullptr);
+
+    // Gets the number of months printed so far.
+    size_t getFramesWritten();
+    // Gets the number of months dropped because the queue was full.
+    size_t getFramesDropped();
+};
+
+#endif // OUTPUTPIPELINE_H
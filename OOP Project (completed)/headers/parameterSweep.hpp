@@ -0,0 +1,47 @@
+// parameterSweep.h
+#ifndef PARAMETERSWEEP_H
+#define PARAMETERSWEEP_H
+
+#include <string>
+#include <vector>
+#include <iosfwd>
+#include "simulationConfig.hpp"
+
+// One swept option and the values it takes (any SimulationConfig option name).
+struct SweepAxis
+{
+    std::string option;
+    std::vector<std::string> values;
+};
+
+// Runs every combination of the axes (a full grid) with several replicates each,
+// all on one thread pool, and writes a single CSV table with one row per run:
+// the swept values, the final populations and the populations after every month.
+// Replicate r of every point uses the same seed, so points are compared on
+// common random numbers. As in an ensemble, each run has one unpinned worker.
+class ParameterSweep
+{
+private:
+    SimulationConfig baseConfig;
+    std::vector<SweepAxis> axes;
+    int replicates;
+    int threadCount;
+
+    // Builds the configuration of one grid point.
+    bool configForPoint(size_t point, SimulationConfig &config, std::string &error) const;
+
+public:
+    // ParameterSweep constructor.
+    ParameterSweep(const SimulationConfig &baseConfig_val, int replicates_val, int threadCount_val);
+
+    // Parses "option=a,b,c" (a list) or "option=start:stop:step" (an inclusive range) into an axis.
+    static bool parseAxis(const std::string &spec, SweepAxis &axis, std::string &error);
+    // Adds an axis after checking that every value is accepted by SimulationConfig.
+    bool addAxis(const SweepAxis &axis, std::string &error);
+    // Gets the number of parameter combinations.
+    size_t getPointCount() const;
+    // Runs all points and replicates and writes the results table.
+    bool run(std::ostream &table, std::string &error) const;
+};
+
+#endif // PARAMETERSWEEP_H
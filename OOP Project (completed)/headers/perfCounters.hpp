@@ -0,0 +1,58 @@
+// perfCounters.h
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+#include <array>
+#include <string>
+#include <cstddef>
+
+// Hardware events counted by a PerfCounterGroup.
+enum class HardwareCounter
+{
+    CYCLES,
+    INSTRUCTIONS,
+    L1D_MISSES,    // L1 data cache read misses
+    LLC_MISSES,    // Last-level cache misses
+    BRANCH_MISSES,
+    COUNT
+};
+
+const size_t HARDWARE_COUNTER_COUNT = static_cast<size_t>(HardwareCounter::COUNT);
+using CounterValues = std::array<unsigned long long, HARDWARE_COUNTER_COUNT>;
+
+// The hardware counters of the calling thread, opened with Linux perf_event_open as one
+// group so they are always scheduled (and multiplexed) together. Only user-space events
+// are counted, which most perf_event_paranoid settings allow. Counters the CPU, kernel or
+// container does not offer are left out; if none can be opened the group is unavailable
+// and read() fails, with the reason kept for the report.
+class PerfCounterGroup
+{
+private:
+    std::array<int, HARDWARE_COUNTER_COUNT> fds;         // -1 for counters that could not be opened
+    std::array<int, HARDWARE_COUNTER_COUNT> groupSlots;  // Position of each counter in a group read (-1 if absent)
+    int leaderFd;
+    int openedCount;
+    std::string unavailableReason;
+
+public:
+    // Opens every counter it can on the calling thread and starts counting.
+    PerfCounterGroup();
+    // Closes the counters.
+    ~PerfCounterGroup();
+    PerfCounterGroup(const PerfCounterGroup &) = delete;
+    PerfCounterGroup &operator=(const PerfCounterGroup &) = delete;
+
+    // Whether at least one counter is counting.
+    bool isAvailable() const;
+    // Whether a particular counter is counting.
+    bool hasCounter(HardwareCounter counter) const;
+    // Gets why no counter (or not every counter) could be opened; empty if all are counting.
+    const std::string &getUnavailableReason() const;
+    // Reads the running totals, scaled up if the kernel had to multiplex the group; false if unavailable.
+    bool read(CounterValues &values) const;
+
+    // Gets the display name of a counter.
+    static const char *getCounterName(HardwareCounter counter);
+};
+
+#endif // PERFCOUNTERS_H
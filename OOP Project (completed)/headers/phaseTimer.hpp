@@ -0,0 +1,122 @@
+// phaseTimer.h
+#ifndef PHASETIMER_H
+#define PHASETIMER_H
+
+#include <array>
+#include <vector>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <iosfwd>
+#include "traceRecorder.hpp"
+#include "perfCounters.hpp"
+
+// Parts of Simulation::runMonth that are timed separately.
+enum class SimPhase
+{
+    SETUP,      // Stats reset, month header, synchronous copy, list copies
+    EXCHANGE,   // Halo exchanges with neighbouring subdomains
+    CARNIVORES,
+    HERBIVORES,
+    PLANTS,
+    MIGRATION,
+    CLEANUP,    // Removing dead entities, merging the month's stats
+    DISPLAY,    // Grid and stats output, statistics sinks
+    COUNT
+};
+
+// Wraps a timing statement in runMonth; building with ECOSIM_DISABLE_PHASE_TIMING removes it.
+#ifdef ECOSIM_DISABLE_PHASE_TIMING
+#define ECOSIM_PHASE_TIMING(...) ((void)0)
+#else
+#define ECOSIM_PHASE_TIMING(...) __VA_ARGS__
+#endif
+
+// Per-phase wall time of every month of a run. runMonth marks the end of each phase with
+// lap(), which charges the time since the previous lap to that phase, so every part of the
+// month is counted exactly once; endMonth() stores the month's time of each phase as one
+// sample. With a trace recorder attached, every lap and month is also recorded as a span.
+// With hardware counters on, each lap also charges the counter deltas of the calling thread
+// to the phase. While disabled and not tracing, every call returns straight away.
+class PhaseTimer
+{
+public:
+    static const size_t PHASE_COUNT = static_cast<size_t>(SimPhase::COUNT);
+    using Clock = std::chrono::steady_clock;
+
+private:
+    bool enabled;
+    TraceRecorder *traceRecorder; // Receives a span per phase and month (not owned; nullptr for none)
+    int month;
+    Clock::time_point monthStart;
+    Clock::time_point lapStart;
+    std::array<double, PHASE_COUNT> monthSeconds;
+    std::array<unsigned long long, PHASE_COUNT> monthUpdates;
+    std::array<std::vector<double>, PHASE_COUNT> samples; // Seconds per month, one entry per month
+    std::array<unsigned long long, PHASE_COUNT> totalUpdates; // Entities updated over the run
+    std::unique_ptr<PerfCounterGroup> hardwareCounters; // Counters of the thread running the months, when on
+    CounterValues lapCounters;                            // Counter totals at the last lap
+    std::array<CounterValues, PHASE_COUNT> totalCounters; // Counter deltas of each phase over the run
+
+    // Charges the counter deltas since the last lap to a phase.
+    void chargeCounters(SimPhase phase);
+    // Prints the counters of every phase per entity update (per month for phases without updates).
+    void reportCounters(std::ostream &out) const;
+
+public:
+    // PhaseTimer constructor (disabled).
+    PhaseTimer();
+
+    // Turns timing on or off (samples taken so far are kept).
+    void setEnabled(bool enabled_val);
+    bool isEnabled() const { return enabled; }
+    // Also records every phase and month as a trace span (nullptr stops it).
+    void setTraceRecorder(TraceRecorder *recorder);
+    // Forgets every sample.
+    void reset();
+    // Also counts cycles, instructions, cache and branch misses of each phase; call on the
+    // thread that runs the months. Returns false if no counter could be opened (see report).
+    bool setHardwareCounters(bool enabled_val);
+    bool hasHardwareCounters() const { return hardwareCounters && hardwareCounters->isAvailable(); }
+
+    // Starts timing a month (month numbers the month's trace span).
+    void beginMonth(int month_val = 0)
+    {
+        if (!enabled && !traceRecorder)
+            return;
+        month = month_val;
+        if (hardwareCounters)
+            hardwareCounters->read(lapCounters);
+        monthStart = lapStart = Clock::now();
+    }
+    // Charges the time since the last lap to a phase, which updated entitiesUpdated entities.
+    void lap(SimPhase phase, size_t entitiesUpdated = 0)
+    {
+        if (!enabled && !traceRecorder)
+            return;
+        Clock::time_point now = Clock::now();
+        monthSeconds[static_cast<size_t>(phase)] += std::chrono::duration<double>(now - lapStart).count();
+        monthUpdates[static_cast<size_t>(phase)] += entitiesUpdated;
+        if (hardwareCounters)
+            chargeCounters(phase);
+        if (traceRecorder)
+            traceRecorder->addSpan(getPhaseName(phase), "phase", lapStart, now, "entities", static_cast<long long>(entitiesUpdated));
+        lapStart = now;
+    }
+    // Stores this month's time of every phase as one sample.
+    void endMonth();
+
+    // Gets the number of months timed.
+    size_t getMonthCount() const;
+    // Gets the time of a phase in every month timed.
+    const std::vector<double> &getSamples(SimPhase phase) const;
+    // Gets the counter deltas of a phase over the run (zero without hardware counters).
+    const CounterValues &getCounterTotals(SimPhase phase) const;
+    // Gets the display name of a phase.
+    static const char *getPhaseName(SimPhase phase);
+    // Prints total, mean, p50 and p99 time and entity updates per second of every phase that ran,
+    // then the hardware counters if they are on.
+    void report(std::ostream &out) const;
+};
+
+#endif // PHASETIMER_H
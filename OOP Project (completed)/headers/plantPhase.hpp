@@ -0,0 +1,46 @@
+// plantPhase.h
+#ifndef PLANTPHASE_H
+#define PLANTPHASE_H
+
+#include <vector>
+#include <memory>
+#include "constants.hpp"
+#include "statsShard.hpp"
+#include "speciesParams.hpp"
+
+// Forward declarations
+class Grid;
+class Plant;
+class ThreadPool;
+
+// Side effects of the plants updated inside one tile, merged after all tiles ran.
+struct PlantTileBuffer
+{
+    std::vector<std::shared_ptr<Plant>> spreadPlants; // Already in their cells, not yet in the plant list.
+    std::vector<PlantParams> pendingSeeds;             // Random global seedings left for the merge step.
+    StatsShard stats;                                  // Counters and events of this tile only.
+};
+
+// Updates all plants in parallel by splitting the grid into square tiles.
+// Tiles are 4-colored in a 2x2 pattern, so two tiles of the same color are
+// always at least one tile apart and their 8-neighborhoods never overlap.
+// Each color runs in parallel on the work-stealing pool, in tasks sized by
+// plant population; the colors run one after another. Every tile
+// draws from its own generator seeded from (month seed, tile index), so the
+// result does not depend on the number of threads.
+class ParallelPlantPhase
+{
+private:
+    int tileSize;
+
+public:
+    // ParallelPlantPhase constructor (tiles smaller than 2 cells would let neighborhoods touch).
+    explicit ParallelPlantPhase(int tileSize_val = 64);
+
+    // Runs the plant update for one month and merges every tile into stats.
+    void run(Grid &grid, StatsShard &stats, Season currentSeason, ThreadPool &pool, unsigned int monthSeed) const;
+    // Gets the tile edge length in cells.
+    int getTileSize() const;
+};
+
+#endif // PLANTPHASE_H
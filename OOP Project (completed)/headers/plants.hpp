@@ -3,10 +3,12 @@
 #define PLANT_H
 
 #include "entity.hpp"
+#include "speciesParams.hpp" // For PlantParams
 
 // Forward declarations
 class Grid;
-struct MonthlyStats;
+struct StatsShard;
+struct PlantTileBuffer;
 
 // Represents plant entities in the simulation.
 class Plant : public Entity
@@ -18,21 +20,30 @@ private:
     const int winterDeathChanceRate; 
     const int autumnDeathChanceRate; 
 
+    // Shared update logic; with a tile buffer, new plants are deferred for the merge step.
+    void grow(Grid &grid, StatsShard &stats, Season currentSeason, PlantTileBuffer *tileBuffer);
+
 public:
     // Plant constructor.
-    Plant(int r_coord, int c_coord);
+    Plant(int r_coord, int c_coord, const PlantParams &params = PLANT_DEFAULTS);
     
     // Gets the species name ("Plant").
     std::string getSpeciesName() const override;
     // Updates the plant's state for the current month.
-    void update(Grid &grid, MonthlyStats &stats, Season currentSeason) override;
+    void update(Grid &grid, StatsShard &stats, Season currentSeason) override;
+    // Updates the plant inside a tile of the parallel plant phase (see ParallelPlantPhase).
+    void updateInTile(Grid &grid, StatsShard &stats, Season currentSeason, PlantTileBuffer &tileBuffer);
+    // Seeds a new plant with the given parameters into a random empty cell among the grid's owned rows.
+    static bool seedRandomCell(Grid &grid, const PlantParams &params);
 
     // Getters
     int getBaseSpreadChance() const;
     int getMaxAgePlant() const; // Renamed to avoid conflict if Animal also had getMaxAge
     int getCurrentAgePlant() const; // Renamed for clarity
+    PlantParams getParams() const; // Parameters passed on to spread and seeded plants
 
     // Setters (if any are needed externally, most are internal)
+    void setCurrentAgePlant(int age_val); // Restores the age of a plant handed over from another process
     // void setBaseSpreadChance(int chance);
 };
 
@@ -5,16 +5,34 @@
 #include "grid.hpp" // Full definition needed
 #include "monthlyStats.hpp" // Full definition needed
 #include "constants.hpp" // For Season, MAX_SIMULATION_YEARS, etc.
+#include "threadPool.hpp" // For the worker pool owned by the simulation
+#include "simulationConfig.hpp"
+#include "outputPipeline.hpp" // For background month output
+#include "statsHistory.hpp"
+#include "phaseTimer.hpp"
+#include "traceRecorder.hpp"
+#include "memoryReport.hpp"
+#include "spatialHeatmaps.hpp"
+#include "ansiRenderer.hpp"
+#include "checkpoint.hpp"
 #include <string>
 #include <vector>
+#include <memory>
+#include <random> // For the per-simulation generator
+#include <iostream> // For the output stream
 #include <limits> // For std::numeric_limits
 
+class DomainExchange; // See domain.hpp
+class StatsSink; // See statsSink.hpp
+
 // Controls the overall simulation flow, time, and initialization.
 class Simulation
 {
 private:
     Grid sim_grid; // Renamed to avoid conflict if any
     MonthlyStats sim_stats; // Renamed
+    StatsHistory sim_history; // Every completed month's counters, kept for export
+    StatsShard sim_shard; // Filled by the month's updates (parallel phases fold their tile shards in), merged into sim_stats at month end
     int totalMonthsDuration; // Renamed
     int currentMonthCounter; // Renamed
     bool carnivoresStarvedPreviousMonth; // Renamed
@@ -23,31 +41,170 @@ private:
     int currentMonthIndexInYear; // Renamed
     std::vector<std::string> month_Names_sim; // Renamed
     std::string simulationEndReason; // Renamed
+    std::mt19937 sim_rng; // Generator bound to the random helpers while this simulation runs
+    std::unique_ptr<ThreadPool> workerPool;
+    bool parallelPlantUpdate;
+    int plantTileSize;
+    bool intentMovement;
+    bool synchronousUpdate; // Cell reads see the cells as they were at the start of the month
+    bool pinWorkerThreads; // Each worker of workerPool is bound to its own CPU
+    bool numaPlacement;    // Grid memory was moved to the nodes of the workers updating it
+    size_t pagesPlaced;    // Pages moved by the last NUMA placement
+    std::ostream *outputStream; // Where grids, statistics and messages go; nullptr discards them
+    bool interactivePrompts;    // Whether runMonth pauses for Enter after each month
+    size_t outputQueueCapacity; // Months the background output may fall behind (0 prints on the simulation thread)
+    OutputBackpressure outputBackpressure;
+    std::unique_ptr<AnsiRenderer> ansiRenderer; // Redraws only changed cells in place, when on (outlives the pipeline using it)
+    std::unique_ptr<OutputPipeline> outputPipeline; // Prints months on its own thread when outputQueueCapacity > 0
+    AnimalParams herbivoreParams; // Used for initial and immigrating herbivores
+    AnimalParams carnivoreParams; // Used for initial and immigrating carnivores
+    PlantParams plantParams;      // Used for initial plants
+    DomainExchange *domainExchange; // Set when this simulation runs one subdomain of a larger world
+    std::vector<StatsSink *> statsSinks; // Receive every completed month (not owned)
+    PhaseTimer phaseTimer; // Per-phase month timings, when enabled
+    std::string traceFile; // Where the trace is written at the end (empty when not tracing)
+    std::unique_ptr<TraceRecorder> traceRecorder; // Spans of every month, phase, task and tile, while tracing
+    std::string traceError; // Why the trace could not be written (set at the end)
+    bool printMemoryReport;       // Add the memory report to the end report
+    std::string memoryReportFile; // Where the memory report is written as JSON at the end (empty for nowhere)
+    std::string memoryReportError; // Why the memory report could not be written (set at the end)
+    std::vector<unsigned long long> monthlyAllocations; // Heap allocations of each month, while reporting memory
+    std::unique_ptr<SpatialHeatmaps> heatmaps; // Per-cell event counters of the current year, when on
+    std::string heatmapDirectory;
+    HeatmapFormat heatmapFormat;
+    int heatmapMonths;       // Months counted since the heatmaps were last written
+    int heatmapYear;         // Year the heatmaps are counting
+    std::string heatmapError; // Why the last write failed (reported at the end)
+    std::string checkpointFile;  // Where checkpoints are written (empty when not checkpointing)
+    int checkpointInterval;      // Months between checkpoints
+    std::string checkpointError; // Why the last checkpoint could not be written (reported at the end)
+    std::string snapshotDirectory; // Where world snapshots are written (empty when not writing them)
+    int snapshotInterval;          // Months between snapshots
+    std::string snapshotError;     // Why the last snapshot could not be written (reported at the end)
 
+    // Builds a simulation around an already constructed (possibly subdomain) grid.
+    explicit Simulation(Grid grid);
     // Helper function to get validated integer input.
     int getValidIntInput(const std::string& prompt, int minVal = std::numeric_limits<int>::min(), int maxVal = std::numeric_limits<int>::max());
     // Helper function to get validated hemisphere input.
     char getValidHemisphereInput(const std::string& prompt);
+    // Places the initial plants, herbivores and carnivores at random empty cells.
+    void populate(int numP, int numH, int numC);
+    // Shows the grid and population before the first month.
+    void showInitialState();
+    // Reports why and when the simulation ended.
+    void reportEnd();
+    // Recreates (or removes) the background output pipeline after an output setting changed.
+    void rebuildOutputPipeline();
+    // Waits for the background output to catch up before writing to the output stream directly.
+    void flushOutput();
+    // Adds the month's populations, births and deaths to the trace as counter tracks.
+    void recordTraceCounters();
+    // Writes the trace to traceFile; returns false if the file could not be written.
+    bool writeTraceFile() const;
+    // Whether a memory report is printed or written at the end.
+    bool reportsMemory() const;
+    // Writes the heatmaps of the year so far and starts counting the next year.
+    void flushHeatmaps();
 
 public:
     // Simulation constructor.
-    Simulation();
+    Simulation(int gridHeight = GRID_HEIGHT, int gridWidth = GRID_WIDTH);
+    // Builds and populates a non-interactive simulation from a validated configuration.
+    explicit Simulation(const SimulationConfig &config);
+    // Same as above, but simulating only the owned rows of a subdomain grid.
+    Simulation(const SimulationConfig &config, Grid grid);
+    
+    // Reseeds the simulation's random generator (seeded from the global gen by default).
+    void setSeed(unsigned int seed);
+    // Sets how many threads the parallel phases may use (1 keeps everything on the caller);
+    // pinThreads binds every one of them, the caller included, to its own CPU.
+    void setWorkerThreads(int threadCount, bool pinThreads = false);
+    // Moves each stripe of grid rows, with its entities, to the NUMA node of the worker that
+    // updates it (call after the grid is populated; needs pinned worker threads).
+    void setNumaPlacement(bool enabled);
+    // Switches the plant phase to the tiled parallel update (see ParallelPlantPhase).
+    void setParallelPlantUpdate(bool enabled, int tileSize = 64);
+    // Switches the animal phases to two-phase intent/resolve movement (see IntentMovePhase).
+    void setIntentMovement(bool enabled);
+    // Switches to synchronous updates: cells are read as they were when the month began (entity
+    // state such as energy still changes in place); moves and births show next month.
+    void setSynchronousUpdate(bool enabled);
+    // Chooses which event categories (EVENTS_FEEDING, ...) the monthly report records; counters are always kept.
+    void setEventMask(unsigned int mask);
+    // Sets the most events the monthly report keeps; later ones are only counted (see EventLog).
+    void setEventCapacity(size_t capacity);
+    // Redirects all output of the simulation (nullptr discards it).
+    void setOutput(std::ostream *out);
+    // Prints months on a background thread through a queue of queueCapacity months (0 turns it off).
+    void setBackgroundOutput(size_t queueCapacity, OutputBackpressure policy = OutputBackpressure::BLOCK);
+    // Keeps the grid in place at the top of an ANSI terminal and redraws only the cells that changed
+    // each month (see AnsiRenderer); the month's text scrolls below it.
+    void setAnsiRendering(bool enabled, double fullRedrawFraction = 0.5);
+    // Times every phase of runMonth and adds a per-phase summary to the end report.
+    void setPhaseTiming(bool enabled);
+    // Adds cycles, instructions, L1D/LLC misses and branch misses per entity update of every phase
+    // to the phase timing report (Linux perf_event_open; the report says why if they are unavailable).
+    void setHardwareCounters(bool enabled);
+    // Records a Chrome trace-event JSON trace of the run and writes it to path when the
+    // simulation ends (an empty path turns tracing off).
+    void setTraceFile(const std::string &path);
+    // Adds a memory report to the end report and/or writes it as JSON to jsonPath; heap
+    // allocations per month are counted only in builds with ECOSIM_COUNT_ALLOCATIONS.
+    void setMemoryReport(bool print, const std::string &jsonPath = "");
+    // Counts births, deaths by cause, predation, grazing and animal occupancy per cell and
+    // writes them to directory once per simulated year (an empty directory turns it off).
+    void setHeatmaps(const std::string &directory, HeatmapFormat format = HeatmapFormat::PGM);
+    // Writes a checkpoint to path after every everyMonths months (0 turns it off); each one
+    // replaces the previous one only once it is complete.
+    void setCheckpointing(const std::string &path, int everyMonths);
+    // Writes a memory-mappable snapshot of the world (see WorldSnapshot) as
+    // <directory>/world_month<N>.ecosnap after every everyMonths months (0 turns it off).
+    void setSnapshots(const std::string &directory, int everyMonths);
+    // Hands every completed month to a sink as well (the sink must outlive the simulation's run).
+    void addStatsSink(StatsSink *sink);
+    // Stops handing months to the sinks added so far.
+    void clearStatsSinks();
+    // Runs this simulation as one subdomain: halo exchange before each phase, world-wide end checks.
+    void setDomainExchange(DomainExchange *exchange);
     
     // Determines the current season based on the month and hemisphere.
     void determineSeason();
-    // Initializes the simulation with user inputs.
-    void initialize();
+    // Initializes the simulation with user inputs; false if they cannot be used (nothing is placed then).
+    bool initialize();
     // Handles animal migration events.
     void handleMigration();
     // Runs one month of the simulation.
     void runMonth();
-    // Starts and manages the simulation loop.
-    void start();
+    // Starts and manages the simulation loop; false if the setup entered could not be used.
+    bool start();
+    // Runs every remaining month without prompts (for simulations built from a SimulationConfig).
+    void runToCompletion();
+    // Checks whether the simulation still has months left to run.
+    bool hasMonthsRemaining() const;
+
+    // Captures the grid, counters, generator and statistics history between months.
+    SimulationCheckpoint makeCheckpoint() const;
+    // Carries on from a checkpoint, replacing the grid and run state (settings such as threads
+    // and output stay); on failure error explains why and nothing is changed.
+    bool restoreCheckpoint(const SimulationCheckpoint &checkpoint, std::string &error);
+    // Writes makeCheckpoint() to a file (through a temporary file renamed into place).
+    bool saveCheckpoint(const std::string &path, std::string &error) const;
+    // Reads a checkpoint file and restores it; on failure error explains why.
+    bool loadCheckpoint(const std::string &path, std::string &error);
 
-    // Getters (add if needed for external access, though most logic is internal to start/runMonth)
-    // int getCurrentMonthCounter() const;
-    // const Grid& getGrid() const; 
-    // const MonthlyStats& getStats() const;
+    // Getters
+    int getCurrentMonthCounter() const;
+    const Grid& getGrid() const; 
+    const MonthlyStats& getStats() const;
+    const StatsHistory& getHistory() const;
+    const PhaseTimer& getPhaseTimer() const;
+    // Gets where the simulation's memory goes right now.
+    MemoryReport getMemoryReport() const;
+    const std::string& getEndReason() const;
+    // Gets why files the run writes (trace, heatmaps, checkpoints, snapshots, memory report) could
+    // not be written, one message each; empty when every write succeeded.
+    std::vector<std::string> getWriteErrors() const;
 };
 
 #endif // SIMULATION_H
\ No newline at end of file
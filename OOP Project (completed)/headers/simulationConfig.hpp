@@ -0,0 +1,67 @@
+// simulationConfig.h
+#ifndef SIMULATIONCONFIG_H
+#define SIMULATIONCONFIG_H
+
+#include <string>
+#include "constants.hpp" // For GRID_WIDTH, GRID_HEIGHT, MAX_SIMULATION_YEARS
+#include "speciesParams.hpp"
+#include "eventLog.hpp" // For the event category mask
+#include "spatialHeatmaps.hpp" // For HeatmapFormat
+
+// Everything needed to set up a simulation without asking the user.
+struct SimulationConfig
+{
+    bool northernHemisphere = true;
+    int years = 1;
+    int initialPlants = 250;
+    int initialHerbivores = 110;
+    int initialCarnivores = 12;
+    int gridHeight = GRID_HEIGHT;
+    int gridWidth = GRID_WIDTH;
+    unsigned int seed = 0;
+    int workerThreads = 1;
+    bool parallelPlantUpdate = false;
+    int plantTileSize = 64;
+    bool intentMovement = false;
+    bool synchronousUpdate = false;
+    bool pinThreads = false;    // Bind each worker thread to its own CPU
+    bool numaPlacement = false; // Move grid memory to the NUMA node of the worker updating it (needs pinThreads)
+    bool phaseTiming = false; // Time every phase of every month and report p50/p99 at the end
+    bool hardwareCounters = false; // Add perf_event_open counters of every phase to the timing report (needs phaseTiming)
+    bool memoryReport = false;    // Add a memory report to the end report
+    std::string memoryReportFile; // Also write the memory report as JSON here (empty = don't)
+    std::string heatmapDirectory; // Write per-cell event heatmaps here once per year (empty = don't count them)
+    HeatmapFormat heatmapFormat = HeatmapFormat::PGM;
+    std::string traceFile;    // Write a Chrome trace-event JSON trace of the run here (empty = no trace)
+    unsigned int eventMask = EVENTS_ALL; // Event categories recorded in the monthly report
+    int eventCapacity = static_cast<int>(EventLog::DEFAULT_CAPACITY); // Events the monthly report keeps (the rest are counted)
+    int outputQueueCapacity = 0;       // Months printed in the background may lag behind (0 = print inline)
+    bool dropOutputWhenBehind = false; // With a full queue, drop the oldest month instead of waiting
+    bool ansiRendering = false;        // Keep the grid in place on an ANSI terminal and redraw only changed cells
+    std::string checkpointFile; // Write a binary checkpoint of the whole run state here (empty = don't)
+    int checkpointInterval = 0; // Months between checkpoints (0 = none)
+    std::string restoreFile;    // Carry on from this checkpoint instead of populating (see Simulation::loadCheckpoint)
+    std::string snapshotDirectory; // Write memory-mappable world snapshots here (empty = don't)
+    int snapshotInterval = 0;      // Months between snapshots (0 = none)
+    AnimalParams herbivoreParams = HERBIVORE_DEFAULTS;
+    AnimalParams carnivoreParams = CARNIVORE_DEFAULTS;
+    PlantParams plantParams = PLANT_DEFAULTS;
+
+    // Sets one option by name (e.g. "years", "plants", "herbivore.maxAge"); on failure error explains why.
+    bool applyOption(const std::string &name, const std::string &value, std::string &error);
+    // Applies every "name = value" line of a file ('#' starts a comment); on failure error
+    // names the file and line.
+    bool loadFile(const std::string &path, std::string &error);
+    // Checks the values against the simulation limits; on failure error explains why.
+    bool validate(std::string &error) const;
+    // Checks that no option writes to one fixed path or restores one saved run, for a config copied
+    // into several runs at once (runs names them in the error, e.g. "ensemble members"); they would
+    // overwrite each other.
+    bool validateForManyRuns(const std::string &runs, std::string &error) const;
+
+    // Parses the value of a driver's own count flag (e.g. "--members") as a whole int of at
+    // least minimum; on failure error explains why.
+    static bool parseCount(const std::string &flag, const std::string &value, int minimum, int &result, std::string &error);
+};
+
+#endif // SIMULATIONCONFIG_H
@@ -0,0 +1,76 @@
+// spatialHeatmaps.h
+#ifndef SPATIALHEATMAPS_H
+#define SPATIALHEATMAPS_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <iosfwd>
+
+// Per-cell counters kept by SpatialHeatmaps.
+enum class HeatmapLayer
+{
+    BIRTHS,              // Animals born in the cell
+    DIED_OLD_AGE,        // Animals that died in the cell having outlived their maximum age
+    DIED_STARVATION,     // Animals that died in the cell of hunger or exhaustion
+    EATEN,               // Herbivores caught by a carnivore in the cell (predation events)
+    PLANTS_EATEN,        // Plants grazed in the cell
+    HERBIVORE_OCCUPANCY, // Herbivore-months spent in the cell
+    CARNIVORE_OCCUPANCY, // Carnivore-months spent in the cell
+    COUNT
+};
+
+// How SpatialHeatmaps::writeYear stores a year.
+enum class HeatmapFormat
+{
+    PGM,    // One 8-bit greyscale image per layer, scaled to the layer's busiest cell
+    BINARY  // One file with every layer's raw counts
+};
+
+// Where events happened on the grid, accumulated in one flat array of counters per layer
+// with a single increment per event, so the spatial picture of a run needs no per-month
+// dump of the grid. The update code reaches it through StatsShard::recordCell.
+//
+// Binary format (all integers little-endian):
+//   "ECOHEAT", uint8 version (1), uint32 layer count, uint32 height, uint32 width,
+//   then each layer's height * width uint32 counts, row by row.
+class SpatialHeatmaps
+{
+public:
+    static const size_t LAYER_COUNT = static_cast<size_t>(HeatmapLayer::COUNT);
+
+private:
+    int height;
+    int width;
+    std::vector<std::uint32_t> counts; // Layer by layer, each row-major
+
+public:
+    // SpatialHeatmaps constructor for a grid of the given size (all counters zero).
+    SpatialHeatmaps(int height_val, int width_val);
+
+    // Counts one event in a cell (coordinates must be on the grid).
+    void increment(HeatmapLayer layer, int r_coord, int c_coord)
+    {
+        counts[(static_cast<size_t>(layer) * height + r_coord) * width + c_coord]++;
+    }
+    // Gets the count of one cell.
+    std::uint32_t getCount(HeatmapLayer layer, int r_coord, int c_coord) const;
+    // Sets every counter back to zero.
+    void clear();
+
+    int getHeight() const { return height; }
+    int getWidth() const { return width; }
+    // Gets the file name stem of a layer.
+    static const char *getLayerName(HeatmapLayer layer);
+
+    // Writes one layer as a binary PGM image; returns false if the stream failed.
+    bool writePgm(std::ostream &out, HeatmapLayer layer) const;
+    // Writes every layer in the binary format described above; returns false if the stream failed.
+    bool writeBinary(std::ostream &out) const;
+    // Writes the counters as <directory>/<layer>_year<N>.pgm, or <directory>/heatmaps_year<N>.bin;
+    // on failure error explains why.
+    bool writeYear(const std::string &directory, int year, HeatmapFormat format, std::string &error) const;
+};
+
+#endif // SPATIALHEATMAPS_H
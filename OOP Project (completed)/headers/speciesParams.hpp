@@ -0,0 +1,33 @@
+// speciesParams.h
+#ifndef SPECIESPARAMS_H
+#define SPECIESPARAMS_H
+
+// Life-history parameters of an animal species. Offspring inherit their parent's values.
+struct AnimalParams
+{
+    int maxAge;
+    int maxEnergy;
+    int visionRange;
+    int moveCost;
+    int gestationPeriod;
+    int minBreedingAge;
+    int energyToReproduce;
+    int maxTurnsWithoutFood;
+    double size;
+};
+
+// Growth parameters of plants (percent chances per month). Spread and seeded plants inherit them.
+struct PlantParams
+{
+    int spreadChance;
+    int maxAge;
+    int winterDeathChance;
+    int autumnDeathChance;
+};
+
+// --- Default Species Parameters ---
+const AnimalParams HERBIVORE_DEFAULTS = {70, 120, 5, 10, 3, 2, 40, 3, 1.0};
+const AnimalParams CARNIVORE_DEFAULTS = {100, 120, 6, 15, 4, 5, 50, 2, 1.5};
+const PlantParams PLANT_DEFAULTS = {35, 40, 20, 10};
+
+#endif // SPECIESPARAMS_H
@@ -0,0 +1,94 @@
+// statsHistory.h
+#ifndef STATSHISTORY_H
+#define STATSHISTORY_H
+
+#include <array>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <iosfwd>
+#include "constants.hpp" // For Season
+#include "animalHistograms.hpp"
+
+struct MonthlyStats;
+
+// Counters kept for every month, in the order they are exported.
+enum class StatsColumn
+{
+    PLANTS_EATEN,
+    PLANTS_DIED_NATURAL_AGE,
+    PLANTS_DIED_WEATHER,
+    PLANTS_SPREAD,
+    CURRENT_PLANTS,
+    HERBIVORES_EATEN,
+    HERBIVORES_DIED_NATURAL,
+    HERBIVORES_SPAWNED,
+    CURRENT_HERBIVORES,
+    CARNIVORES_EATEN,
+    CARNIVORES_DIED_NATURAL,
+    CARNIVORES_SPAWNED,
+    CURRENT_CARNIVORES,
+    ANIMALS_IMMIGRATED,
+    ANIMALS_EMIGRATED,
+    COUNT
+};
+
+// Month-by-month statistics of one run, stored column-wise: one array per counter,
+// indexed by month (0 = the first simulated month). MonthlyStats is reset every month;
+// this keeps the whole time series so it can be exported or read back without parsing
+// the console report.
+//
+// Each month's animal histograms are kept alongside the counters.
+//
+// Binary format (all integers little-endian):
+//   "ECOSTATS", uint32 version (2), uint32 column count, uint32 month count,
+//   month count season bytes, then each column as month count int32 values,
+//   then uint32 histogram bins per month and every month's bins as uint32 values
+//   (version 1 files end after the columns; their histograms read back empty).
+class StatsHistory
+{
+public:
+    static const size_t COLUMN_COUNT = static_cast<size_t>(StatsColumn::COUNT);
+
+private:
+    std::vector<std::uint8_t> seasons; // Season of each month
+    std::array<std::vector<std::int32_t>, COLUMN_COUNT> columns;
+    std::vector<AnimalHistograms> histograms; // One entry per month
+
+public:
+    // Appends the figures of a completed month.
+    void append(const MonthlyStats &stats, Season season);
+    // Reserves room for a number of months, so appending never reallocates during a run.
+    void reserve(size_t months);
+    // Forgets every month.
+    void clear();
+
+    // Gets the number of months recorded.
+    size_t getMonthCount() const;
+    // Gets the bytes reserved for the months.
+    size_t getStorageBytes() const;
+    // Gets all values of one counter, indexed by month.
+    const std::vector<std::int32_t> &getColumn(StatsColumn column) const;
+    // Gets the season of a recorded month.
+    Season getSeason(size_t month) const;
+    // Gets the animal histograms of a recorded month.
+    const AnimalHistograms &getHistograms(size_t month) const;
+    // Gets the CSV header name of a counter.
+    static const char *getColumnName(StatsColumn column);
+
+    // Writes one CSV row per month (month, season and every counter), after a header line.
+    void writeCsv(std::ostream &out) const;
+    // Writes the CSV header line.
+    static void writeCsvHeader(std::ostream &out);
+    // Writes the CSV row of one recorded month.
+    void writeCsvRow(std::ostream &out, size_t month) const;
+    // Writes every month's animal histograms as CSV (see AnimalHistograms::writeCsvHeader).
+    void writeHistogramCsv(std::ostream &out) const;
+    // Writes the binary format described above; returns false if the stream failed.
+    bool writeBinary(std::ostream &out) const;
+    // Replaces this history with one read in the binary format; on failure error explains why.
+    bool readBinary(std::istream &in, std::string &error);
+};
+
+#endif // STATSHISTORY_H
@@ -0,0 +1,101 @@
+// statsShard.h
+#ifndef STATSSHARD_H
+#define STATSSHARD_H
+
+#include "eventLog.hpp"
+#include "animalHistograms.hpp"
+#include "spatialHeatmaps.hpp"
+
+// Event counters and event records gathered by one unit of update work (the sequential
+// phases of a month, or one tile of a parallel phase). Entities only ever touch the shard
+// they were handed, so increments are plain ++ with no atomics or locks; a shard fills a
+// whole cache line of its own so shards of neighbouring tiles never false-share. Shards are
+// folded into the displayed MonthlyStats once per month, always in the same order, so the
+// totals and event order match a sequential run.
+struct alignas(64) StatsShard
+{
+private:
+    int plantsEaten = 0;
+    int plantsDiedNaturalAge = 0;
+    int plantsDiedWeather = 0;
+    int plantsSpread = 0;
+    int herbivoresEaten = 0;
+    int herbivoresDiedNatural = 0;
+    int herbivoresSpawned = 0;
+    int carnivoresEaten = 0;
+    int carnivoresDiedNatural = 0;
+    int carnivoresSpawned = 0;
+    int animalsImmigrated = 0;
+    int animalsEmigrated = 0;
+    int currentMonth = 0; // Stamped on every event recorded
+    unsigned int eventMask = EVENTS_ALL; // Categories recorded (see eventLog.hpp)
+    EventLog monthlyEvents;
+    AnimalHistograms animalHistograms;
+    SpatialHeatmaps *heatmaps = nullptr; // Per-cell counters of the run (not owned; nullptr when off)
+
+public:
+    // Resets every counter and drops the events (keeping their storage, the event mask and the heatmaps).
+    void clear();
+    // Sets the month stamped on the events recorded from now on.
+    void setMonth(int month) { currentMonth = month; }
+    // Chooses which event categories are recorded; counters are kept either way.
+    void setEventMask(unsigned int mask) { eventMask = mask; }
+    unsigned int getEventMask() const { return eventMask; }
+    // Sets the most events kept per month and allocates their storage (see EventLog).
+    void setEventCapacity(size_t capacity) { monthlyEvents.setCapacity(capacity); }
+    // Routes recordCell to a set of heatmaps (nullptr stops it). Only the month's main shard
+    // gets one: animals always update into it, and plant tile shards record no cells.
+    void setHeatmaps(SpatialHeatmaps *heatmaps_val) { heatmaps = heatmaps_val; }
+    // Adds another shard's counters and appends its events (used to fold tile shards together).
+    void absorb(const StatsShard &other);
+
+    // Getters
+    int getPlantsEaten() const { return plantsEaten; }
+    int getPlantsDiedNaturalAge() const { return plantsDiedNaturalAge; }
+    int getPlantsDiedWeather() const { return plantsDiedWeather; }
+    int getPlantsSpread() const { return plantsSpread; }
+    int getHerbivoresEaten() const { return herbivoresEaten; }
+    int getHerbivoresDiedNatural() const { return herbivoresDiedNatural; }
+    int getHerbivoresSpawned() const { return herbivoresSpawned; }
+    int getCarnivoresEaten() const { return carnivoresEaten; }
+    int getCarnivoresDiedNatural() const { return carnivoresDiedNatural; }
+    int getCarnivoresSpawned() const { return carnivoresSpawned; }
+    int getAnimalsImmigrated() const { return animalsImmigrated; }
+    int getAnimalsEmigrated() const { return animalsEmigrated; }
+    const EventLog& getMonthlyEvents() const { return monthlyEvents; }
+    const AnimalHistograms& getAnimalHistograms() const { return animalHistograms; }
+
+    // Modifiers (inline: they run once per entity event)
+    void incrementPlantsEaten() { plantsEaten++; }
+    void incrementPlantsDiedNaturalAge() { plantsDiedNaturalAge++; }
+    void incrementPlantsDiedWeather() { plantsDiedWeather++; }
+    void incrementPlantsSpread() { plantsSpread++; }
+    void incrementHerbivoresEaten() { herbivoresEaten++; }
+    void incrementHerbivoresDiedNatural() { herbivoresDiedNatural++; }
+    void incrementHerbivoresSpawned() { herbivoresSpawned++; }
+    void incrementCarnivoresEaten() { carnivoresEaten++; }
+    void incrementCarnivoresDiedNatural() { carnivoresDiedNatural++; }
+    void incrementCarnivoresSpawned() { carnivoresSpawned++; }
+    void incrementAnimalsImmigrated() { animalsImmigrated++; }
+    void incrementAnimalsEmigrated() { animalsEmigrated++; }
+    // Adds an animal to the month's energy, age, meals missed and gestation histograms.
+    void recordAnimalState(const Animal &animal) { animalHistograms.recordState(animal); }
+    // Adds an animal's age at death to the month's histograms.
+    void recordAnimalDeath(const Animal &animal) { animalHistograms.recordDeath(animal); }
+    // Counts an event in a cell of the heatmaps, if there are any.
+    void recordCell(HeatmapLayer layer, int r_coord, int c_coord)
+    {
+        if (heatmaps)
+            heatmaps->increment(layer, r_coord, c_coord);
+    }
+    // Records an event without formatting it (see formatEvent), unless its category is masked out.
+    // Update code calls it through ECOSIM_RECORD_EVENT so the call can be compiled out.
+    void recordEvent(EventKind kind, EntityType species, int r_coord, int c_coord, unsigned long long subjectId,
+                     int otherR = -1, int otherC = -1, unsigned long long otherId = 0)
+    {
+        if (eventMask & eventCategoryOf(kind))
+            monthlyEvents.append({kind, species, currentMonth, r_coord, c_coord, otherR, otherC, subjectId, otherId});
+    }
+};
+
+#endif // STATSSHARD_H
@@ -0,0 +1,97 @@
+// statsSink.h
+#ifndef STATSSINK_H
+#define STATSSINK_H
+
+#include <iosfwd>
+#include "constants.hpp" // For Season
+#include "statsHistory.hpp"
+
+// Forward declarations
+class Grid;
+struct MonthlyStats;
+
+// Receives every completed month of a Simulation (see Simulation::addStatsSink), so results
+// can be consumed in-process instead of being scraped from the console output.
+class StatsSink
+{
+public:
+    virtual ~StatsSink() = default;
+    // Whether onMonth should be handed the grid (otherwise it gets nullptr).
+    virtual bool wantsGrid() const { return false; }
+    // Called once per month, after the month's statistics and populations are final.
+    virtual void onMonth(int month, Season season, const MonthlyStats &stats, const Grid *grid) = 0;
+    // Called when the simulation ends (from runToCompletion or the interactive loop).
+    virtual void finish() {}
+};
+
+// Discards everything; lets benchmarks keep the sink plumbing while measuring the simulation alone.
+class NullSink : public StatsSink
+{
+public:
+    void onMonth(int, Season, const MonthlyStats &, const Grid *) override {}
+};
+
+// Prints each month's statistics, and optionally the grid, in the usual console layout.
+class ConsoleSink : public StatsSink
+{
+private:
+    std::ostream &out;
+    bool showGrid;
+
+public:
+    // ConsoleSink constructor.
+    explicit ConsoleSink(std::ostream &out_val, bool showGrid_val = false);
+
+    bool wantsGrid() const override;
+    void onMonth(int month, Season season, const MonthlyStats &stats, const Grid *grid) override;
+};
+
+// Writes one CSV row per month as it completes (same columns as StatsHistory::writeCsv).
+class CsvSink : public StatsSink
+{
+private:
+    std::ostream &out;
+    StatsHistory rows;
+
+public:
+    // CsvSink constructor.
+    explicit CsvSink(std::ostream &out_val);
+
+    void onMonth(int month, Season season, const MonthlyStats &stats, const Grid *grid) override;
+    void finish() override;
+};
+
+// Writes each month's animal histograms as CSV rows as the month completes
+// (same layout as StatsHistory::writeHistogramCsv).
+class HistogramCsvSink : public StatsSink
+{
+private:
+    std::ostream &out;
+    bool headerWritten;
+
+public:
+    // HistogramCsvSink constructor.
+    explicit HistogramCsvSink(std::ostream &out_val);
+
+    void onMonth(int month, Season season, const MonthlyStats &stats, const Grid *grid) override;
+    void finish() override;
+};
+
+// Collects the months and writes them in the StatsHistory binary format when the run finishes
+// (the format starts with the month count, so nothing can be written earlier).
+class BinarySink : public StatsSink
+{
+private:
+    std::ostream &out;
+    StatsHistory months;
+    bool written;
+
+public:
+    // BinarySink constructor.
+    explicit BinarySink(std::ostream &out_val);
+
+    void onMonth(int month, Season season, const MonthlyStats &stats, const Grid *grid) override;
+    void finish() override;
+};
+
+#endif // STATSSINK_H
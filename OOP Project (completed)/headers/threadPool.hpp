@@ -0,0 +1,93 @@
+// threadPool.h
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <atomic>
+#include <cstddef>
+#include <iosfwd>
+
+class TraceRecorder; // See traceRecorder.hpp
+
+// Scheduling counters of one worker, accumulated over all jobs since the last reset.
+struct WorkerStats
+{
+    unsigned long long tasksRun = 0;
+    unsigned long long tasksStolen = 0; // Tasks this worker took from another worker's queue.
+    double busySeconds = 0.0;           // Time spent running tasks.
+    double idleSeconds = 0.0;           // Time inside a job with nothing left to run or steal.
+};
+
+// Work-stealing pool that runs the parallel simulation phases.
+// Every task of a job starts in the queue of its owning worker (so a tile keeps
+// going to the same thread); a worker pops its own queue from the front and,
+// once empty, steals from the back of the others' queues.
+class ThreadPool
+{
+private:
+    // Task queue of one worker, padded so neighbouring queues do not share a cache line.
+    struct alignas(64) WorkerQueue
+    {
+        std::mutex queueMutex;
+        std::deque<size_t> tasks;
+        WorkerStats stats;
+        double jobBusySeconds = 0.0;
+    };
+
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<WorkerQueue>> queues; // queues[0] belongs to the calling thread
+    std::vector<int> workerCpus;  // CPU each worker is pinned to (empty if unpinned)
+    std::vector<int> callerCpus;  // CPUs the calling thread was allowed before it was pinned
+    std::mutex poolMutex;
+    std::condition_variable workAvailable;
+    std::condition_variable workFinished;
+    const std::function<void(size_t)> *currentJob;
+    int busyWorkers;
+    unsigned long long jobGeneration;
+    bool stopping;
+    TraceRecorder *traceRecorder; // Receives a span per task on every worker (not owned; nullptr for none)
+
+    // Takes the next task for a worker, from its own queue first and then by stealing.
+    bool takeTask(int workerIndex, size_t &task);
+    // Runs tasks for a worker until none are left anywhere.
+    void drainJob(int workerIndex, const std::function<void(size_t)> &job);
+    // Main loop of each worker thread.
+    void workerLoop(int workerIndex);
+
+public:
+    // ThreadPool constructor; the calling thread counts as one of threadCount. With pinThreads
+    // every worker (the caller included) is bound to its own CPU, alternating between NUMA nodes.
+    explicit ThreadPool(int threadCount, bool pinThreads = false);
+    // Joins all worker threads (and gives the calling thread back its CPUs if it was pinned).
+    ~ThreadPool();
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    // Runs job(0..count-1); task i starts on worker ownerOf(i) and may be stolen by idle workers.
+    void runTasks(size_t count, const std::function<void(size_t)> &job, const std::function<int(size_t)> &ownerOf);
+    // Runs job(0..count-1), handing each worker a contiguous block of indices to start with.
+    void parallelFor(size_t count, const std::function<void(size_t)> &job);
+    // Gets the number of threads taking part in a job, including the caller.
+    int getThreadCount() const;
+    // Gets the CPU a worker is pinned to, or -1 if the pool is not pinned.
+    int getWorkerCpu(int workerIndex) const;
+
+    // Records every task as a span on its worker's thread and routes the trace scopes inside
+    // tasks to the recorder (nullptr stops it). Call between jobs only.
+    void setTraceRecorder(TraceRecorder *recorder);
+
+    // Gets the scheduling counters of every worker (index 0 is the calling thread).
+    std::vector<WorkerStats> getWorkerStats() const;
+    // Clears the scheduling counters.
+    void resetWorkerStats();
+    // Prints per-worker task, steal and idle figures.
+    void reportWorkerStats(std::ostream &out) const;
+};
+
+#endif // THREADPOOL_H
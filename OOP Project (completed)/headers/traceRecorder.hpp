@@ -0,0 +1,131 @@
+// traceRecorder.h
+#ifndef TRACERECORDER_H
+#define TRACERECORDER_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <cstddef>
+#include <iosfwd>
+
+// Collects timed spans and counters of a run and writes them as Chrome trace-event JSON
+// (open the file in chrome://tracing or ui.perfetto.dev). Every thread appends to its own
+// buffer, found through a thread-local cache, so recording takes no lock after a thread's
+// first event. Names, categories and argument names must be string literals (only the
+// pointers are stored). writeJson and clear must not run while other threads record.
+class TraceRecorder
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // One recorded span ('X') or counter sample ('C').
+    struct TraceEvent
+    {
+        const char *name;
+        const char *category; // For a counter: the series name
+        char type;
+        long long startNs;    // Since the recorder was created
+        long long durationNs;
+        const char *argName;  // nullptr for no argument
+        long long argValue;
+    };
+
+private:
+    // Events of one thread.
+    struct ThreadBuffer
+    {
+        std::thread::id owner;
+        int traceThreadId;
+        std::string threadName;
+        std::vector<TraceEvent> events;
+    };
+
+    const unsigned long long recorderId; // Unique per recorder, so a cached buffer is never taken for another recorder's
+    const Clock::time_point origin;
+    mutable std::mutex buffersMutex; // Guards the list of buffers, not their events
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+
+    // Gets the calling thread's buffer, registering it on first use.
+    ThreadBuffer &threadBuffer();
+    // Converts a time point to nanoseconds since the recorder was created.
+    long long sinceOrigin(Clock::time_point time) const;
+
+public:
+    // TraceRecorder constructor; timestamps count from now.
+    TraceRecorder();
+    TraceRecorder(const TraceRecorder &) = delete;
+    TraceRecorder &operator=(const TraceRecorder &) = delete;
+
+    // Records a span on the calling thread, optionally with one integer argument.
+    void addSpan(const char *name, const char *category, Clock::time_point start, Clock::time_point end,
+                 const char *argName = nullptr, long long argValue = 0);
+    // Records the current value of one series of a counter track (e.g. "Population", "plants").
+    void addCounter(const char *name, const char *series, long long value);
+    // Names the calling thread in the trace as role (or "role index"), unless it already has a name.
+    void nameThread(const char *role, int index = -1);
+
+    // Gets the number of events recorded on all threads.
+    size_t getEventCount() const;
+    // Forgets every event (thread names are kept).
+    void clear();
+    // Writes every event as a Chrome trace-event JSON object.
+    void writeJson(std::ostream &out) const;
+};
+
+// Gets the recorder spans on the calling thread go to (nullptr when tracing is off).
+TraceRecorder *activeTraceRecorder();
+
+// Routes the calling thread's trace scopes to a recorder (nullptr turns them off) while in scope.
+class ScopedTraceRecorder
+{
+private:
+    TraceRecorder *previousRecorder;
+
+public:
+    explicit ScopedTraceRecorder(TraceRecorder *recorder);
+    ~ScopedTraceRecorder();
+    ScopedTraceRecorder(const ScopedTraceRecorder &) = delete;
+    ScopedTraceRecorder &operator=(const ScopedTraceRecorder &) = delete;
+};
+
+// Records a span from construction to destruction on the calling thread's active recorder.
+// Without an active recorder it costs one thread-local load.
+class TraceScope
+{
+private:
+    TraceRecorder *recorder;
+    const char *name;
+    const char *category;
+    const char *argName;
+    long long argValue;
+    TraceRecorder::Clock::time_point start;
+
+public:
+    TraceScope(const char *name_val, const char *category_val, const char *argName_val = nullptr, long long argValue_val = 0)
+        : recorder(activeTraceRecorder()), name(name_val), category(category_val), argName(argName_val), argValue(argValue_val)
+    {
+        if (recorder)
+            start = TraceRecorder::Clock::now();
+    }
+    ~TraceScope()
+    {
+        if (recorder)
+            recorder->addSpan(name, category, start, TraceRecorder::Clock::now(), argName, argValue);
+    }
+    TraceScope(const TraceScope &) = delete;
+    TraceScope &operator=(const TraceScope &) = delete;
+};
+
+// Traces the rest of the enclosing block; building with ECOSIM_DISABLE_TRACING removes it.
+#define ECOSIM_TRACE_CONCAT_(a, b) a##b
+#define ECOSIM_TRACE_CONCAT(a, b) ECOSIM_TRACE_CONCAT_(a, b)
+#ifdef ECOSIM_DISABLE_TRACING
+#define ECOSIM_TRACE_SCOPE(...) ((void)0)
+#else
+#define ECOSIM_TRACE_SCOPE(...) TraceScope ECOSIM_TRACE_CONCAT(traceScope_, __LINE__)(__VA_ARGS__)
+#endif
+
+#endif // TRACERECORDER_H
@@ -18,4 +18,23 @@ double getRandomDouble(double min, double max);
 // Returns the string name of a given season.
 std::string getSeasonName(Season season);
 
+// Returns the generator the random helpers use on the calling thread (gen unless rebound).
+std::mt19937& activeRandomGenerator();
+
+// Routes the random helpers on the calling thread to another generator while in scope.
+class ScopedRandomGenerator
+{
+private:
+    std::mt19937 *previousGenerator;
+
+public:
+    explicit ScopedRandomGenerator(std::mt19937 &generator);
+    ~ScopedRandomGenerator();
+    ScopedRandomGenerator(const ScopedRandomGenerator &) = delete;
+    ScopedRandomGenerator &operator=(const ScopedRandomGenerator &) = delete;
+};
+
+// Derives an independent seed for a numbered stream (tile, worker, member) from a base seed.
+unsigned int deriveSeed(unsigned long long baseSeed, unsigned long long streamIndex);
+
 #endif // UTILS_H
\ No newline at end of file
@@ -0,0 +1,122 @@
+// worldSnapshot.h
+#ifndef WORLDSNAPSHOT_H
+#define WORLDSNAPSHOT_H
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include "constants.hpp" // For EntityType
+
+class Grid;
+
+// Per-entity int32 columns of a snapshot. Plants have only ROW, COL and AGE.
+enum class SnapshotColumn
+{
+    ROW,
+    COL,
+    AGE,
+    ENERGY,
+    COOLDOWN,     // Months until the animal may reproduce again
+    GESTATION,    // Months of the current pregnancy so far
+    MEALS_MISSED, // Months since the last meal
+    COUNT
+};
+
+// Bits of a snapshot's per-entity flag column.
+const std::uint8_t SNAPSHOT_FEMALE = 1;
+const std::uint8_t SNAPSHOT_PREGNANT = 2;
+
+// Cell values of a snapshot besides entity references.
+const std::uint32_t SNAPSHOT_EMPTY_CELL = 0;
+const std::uint32_t SNAPSHOT_REMAINS_CELL = 0xFFFFFFFFu; // A dead entity still fills the cell
+
+// Where one species' columns lie in a snapshot file.
+struct SnapshotSpeciesTable
+{
+    std::uint64_t count;
+    std::uint64_t idsOffset;   // count uint64 entity ids
+    std::uint64_t flagsOffset; // count uint8 SNAPSHOT_* flags
+    std::uint64_t columnOffsets[static_cast<size_t>(SnapshotColumn::COUNT)]; // count int32 values each (0 = absent)
+};
+
+// Fixed-size header at the start of a snapshot file.
+struct SnapshotHeader
+{
+    char magic[8];           // "ECOSNAP" and a zero byte
+    std::uint32_t version;   // 1
+    std::uint32_t byteOrder; // 0x01020304 as written by the machine that wrote the file
+    std::int32_t height;     // Rows in the snapshot (a subdomain's owned rows)
+    std::int32_t width;
+    std::int32_t month;      // Months run when the snapshot was taken
+    std::int32_t firstRow;   // Grid row of the first row (0 unless a subdomain wrote it)
+    std::uint64_t cellsOffset; // height * width uint32 cells, row by row
+    std::uint64_t fileBytes;
+    SnapshotSpeciesTable species[3]; // Plants, herbivores, carnivores
+};
+
+// A world laid out to be used straight from a read-only memory mapping: a header with the
+// dimensions and the offset of every array, the cell array, then each species' entities as
+// one array per field (structure of arrays, in list order). Every array starts on a 64-byte
+// boundary and holds native-endian values, so opening a snapshot maps the file and checks
+// the header; cells and columns are paged in from the file only when they are first read.
+//
+// A cell holds SNAPSHOT_EMPTY_CELL, SNAPSHOT_REMAINS_CELL or 1 + the entity's position in the
+// plants, then herbivores, then carnivores (see getCellEntity). A plant an animal moved onto
+// stays listed with its position but the cell refers to the animal.
+//
+// Snapshots are for looking at a world; to carry a run on, use checkpoints (see checkpoint.hpp).
+class WorldSnapshot
+{
+private:
+    const unsigned char *mapping; // The whole file, mapped read-only (nullptr when closed)
+    size_t mappedBytes;
+
+    // Gets the header at the start of the mapping.
+    const SnapshotHeader &header() const { return *reinterpret_cast<const SnapshotHeader *>(mapping); }
+    // Gets the table of a species (PLANT, HERBIVORE or CARNIVORE).
+    const SnapshotSpeciesTable &table(EntityType species) const;
+    // Checks the header against the file size; on failure error explains why.
+    bool validate(std::string &error) const;
+
+public:
+    WorldSnapshot();
+    ~WorldSnapshot();
+    WorldSnapshot(const WorldSnapshot &) = delete;
+    WorldSnapshot &operator=(const WorldSnapshot &) = delete;
+
+    // Writes the owned rows of a grid, taken after month months, as a snapshot file (through a
+    // temporary file renamed into place); on failure error explains why.
+    static bool write(const Grid &grid, int month, const std::string &path, std::string &error);
+
+    // Maps a snapshot file read-only, replacing any snapshot open before; on failure error
+    // explains why and nothing is open.
+    bool open(const std::string &path, std::string &error);
+    // Unmaps the file.
+    void close();
+    // Checks whether a snapshot is open.
+    bool isOpen() const { return mapping != nullptr; }
+
+    int getHeight() const { return header().height; }
+    int getWidth() const { return header().width; }
+    int getMonth() const { return header().month; }
+    int getFirstRow() const { return header().firstRow; }
+    // Gets the number of entities of a species.
+    size_t getCount(EntityType species) const;
+    // Gets every cell, row by row.
+    const std::uint32_t *getCells() const;
+    // Gets the cell value at given grid coordinates (they must lie in the snapshot's rows).
+    std::uint32_t getCell(int r_coord, int c_coord) const
+    {
+        return getCells()[static_cast<size_t>(r_coord - getFirstRow()) * getWidth() + c_coord];
+    }
+    // Finds the species and column index of the entity a cell refers to; false for empty cells and remains.
+    bool getCellEntity(std::uint32_t cell, EntityType &species, size_t &index) const;
+    // Gets the ids of a species' entities.
+    const std::uint64_t *getIds(EntityType species) const;
+    // Gets the SNAPSHOT_* flags of a species' entities.
+    const std::uint8_t *getFlags(EntityType species) const;
+    // Gets one column of a species' entities (nullptr for columns plants do not have).
+    const std::int32_t *getColumn(EntityType species, SnapshotColumn column) const;
+};
+
+#endif // WORLDSNAPSHOT_H
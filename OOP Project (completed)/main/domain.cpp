@@ -0,0 +1,48 @@
+// domain.cpp (driver)
+#include "../headers/domain.hpp"
+
+#include <iostream>
+#include <string>
+
+// --- Domain Decomposition Driver ---
+// Splits one large world into horizontal stripes, each simulated by its own process.
+// Usage: domain [--processes N] [--years N] [--seed N] [--height N] [--width N]
+//               [--plants N] [--herbivores N] [--carnivores N] [--threads N]
+//               [--herbivore.maxAge N ...] (any SimulationConfig option)
+int main(int argc, char *argv[])
+{
+    SimulationConfig scenario;
+    int processes = 2;
+    std::string error;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string flag = argv[i];
+        if (i + 1 >= argc)
+        {
+            std::cerr << "Missing value for " << flag << "\n";
+            return 1;
+        }
+        std::string value = argv[++i];
+        bool applied = flag == "--processes" ? SimulationConfig::parseCount(flag, value, 1, processes, error)
+                     : flag.compare(0, 2, "--") == 0 && scenario.applyOption(flag.substr(2), value, error);
+        if (!applied)
+        {
+            std::cerr << "Error: " << (error.empty() ? "Unknown option " + flag : error) << "\n";
+            return 1;
+        }
+    }
+
+    DomainDecomposition decomposition(processes);
+    DomainRunResult result = decomposition.run(scenario, std::cout);
+    if (!result.succeeded)
+    {
+        std::cerr << "Error: " << result.error << "\n";
+        return 1;
+    }
+    if (!result.endReason.empty())
+        std::cout << "\nSimulation ended after " << result.monthsRun << " completed months.\nReason: " << result.endReason << "\n";
+    else
+        std::cout << "\nSimulation for " << scenario.years << " years (" << result.monthsRun << " months) finished.\n";
+    return 0;
+}
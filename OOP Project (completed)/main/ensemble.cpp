@@ -0,0 +1,65 @@
+// ensemble.cpp (driver)
+#include "../headers/ensemble.hpp"
+
+#include <iostream>
+#include <string>
+#include <thread>
+#include <algorithm>
+
+// --- Ensemble Driver ---
+// Runs the same scenario with many seeds and prints aggregated populations.
+// Usage: ensemble [--members N] [--threads N] [--years N] [--seed N] [--hemisphere N|S]
+//                 [--plants N] [--herbivores N] [--carnivores N] [--height N] [--width N] [--logs DIR]
+//                 [--history DIR] (binary month-by-month statistics of every member)
+//                 [--herbivore.maxAge N ...] (any SimulationConfig option)
+int main(int argc, char *argv[])
+{
+    SimulationConfig scenario;
+    int members = 100;
+    int threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::string logDirectory;
+    std::string historyDirectory;
+    std::string error;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string flag = argv[i];
+        if (i + 1 >= argc)
+        {
+            std::cerr << "Missing value for " << flag << "\n";
+            return 1;
+        }
+        std::string value = argv[++i];
+        bool applied = true;
+        if (flag == "--members") applied = SimulationConfig::parseCount(flag, value, 1, members, error);
+        else if (flag == "--threads") applied = SimulationConfig::parseCount(flag, value, 1, threads, error); // Members side by side, not inside a member
+        else if (flag == "--logs") logDirectory = value;
+        else if (flag == "--history") historyDirectory = value;
+        else applied = flag.compare(0, 2, "--") == 0 && scenario.applyOption(flag.substr(2), value, error);
+        if (!applied)
+        {
+            std::cerr << "Error: " << (error.empty() ? "Unknown option " + flag : error) << "\n";
+            return 1;
+        }
+    }
+
+    EnsembleRunner runner(scenario, members, threads);
+    if (!runner.validate(error))
+    {
+        std::cerr << "Error: " << error << "\n";
+        return 1;
+    }
+    if (!logDirectory.empty())
+        runner.setMemberLogDirectory(logDirectory);
+    if (!historyDirectory.empty())
+        runner.setMemberHistoryDirectory(historyDirectory);
+    EnsembleResult result = runner.run();
+    EnsembleRunner::report(result, std::cout);
+    if (result.membersNotWritten > 0)
+    {
+        std::cerr << "Error: " << result.firstWriteError << " (" << result.membersNotWritten << " of " << result.members
+                  << " members could not be written)\n";
+        return 1;
+    }
+    return 0;
+}
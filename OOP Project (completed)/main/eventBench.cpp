@@ -0,0 +1,133 @@
+// eventBench.cpp (driver)
+#include "../headers/simulation.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <vector>
+#include <streambuf>
+
+// --- Event Verbosity Benchmark ---
+// Runs the same world in three modes and prints the month throughput and output bytes of each:
+//   full           every event category recorded, months printed (to a stream that discards them)
+//   counters-only  no events recorded, months printed
+//   silent         no events recorded, nothing printed
+// The modes take turns --repeats times and the median throughput of each is printed.
+// Build with -DECOSIM_DISABLE_EVENTS to measure the update code with the event sites compiled out.
+// Usage: eventBench [--size N] [--months N] [--repeats N] [any SimulationConfig option]
+namespace
+{
+// Stream buffer that counts every character and keeps none.
+class DiscardBuffer : public std::streambuf
+{
+private:
+    long long bytes = 0;
+
+protected:
+    int_type overflow(int_type ch) override
+    {
+        if (!traits_type::eq_int_type(ch, traits_type::eof()))
+            bytes++;
+        return traits_type::not_eof(ch);
+    }
+    std::streamsize xsputn(const char *, std::streamsize count) override
+    {
+        bytes += count;
+        return count;
+    }
+
+public:
+    // Gets the number of characters discarded so far and starts counting again.
+    long long takeBytes()
+    {
+        long long taken = bytes;
+        bytes = 0;
+        return taken;
+    }
+};
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    SimulationConfig scenario;
+    int size = 200;
+    int months = 24;
+    int repeats = 5;
+    std::string error;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string flag = argv[i];
+        if (i + 1 >= argc)
+        {
+            std::cerr << "Missing value for " << flag << "\n";
+            return 1;
+        }
+        std::string value = argv[++i];
+        bool applied = true;
+        if (flag == "--size") applied = SimulationConfig::parseCount(flag, value, 1, size, error);
+        else if (flag == "--months") applied = SimulationConfig::parseCount(flag, value, 1, months, error);
+        else if (flag == "--repeats") applied = SimulationConfig::parseCount(flag, value, 1, repeats, error);
+        else applied = flag.compare(0, 2, "--") == 0 && scenario.applyOption(flag.substr(2), value, error);
+        if (!applied)
+        {
+            std::cerr << "Error: " << (error.empty() ? "Unknown option " + flag : error) << "\n";
+            return 1;
+        }
+    }
+    scenario.gridHeight = scenario.gridWidth = size;
+    scenario.initialPlants = size * size / 4;
+    scenario.initialHerbivores = size * size / 12;
+    scenario.initialCarnivores = size * size / 120;
+    scenario.years = std::max(1, (months + 11) / 12);
+    if (!scenario.validate(error))
+    {
+        std::cerr << "Error: " << error << "\n";
+        return 1;
+    }
+
+#ifdef ECOSIM_DISABLE_EVENTS
+    std::cout << "Event sites compiled out (ECOSIM_DISABLE_EVENTS)\n";
+#endif
+    std::cout << size << " x " << size << " grid, " << months << " months\n";
+    std::cout << std::left << std::setw(16) << "Mode" << std::setw(12) << "Months/s" << std::setw(16) << "Events recorded" << "Bytes printed\n";
+
+    DiscardBuffer sink;
+    std::ostream discard(&sink); // Formats everything, writes nothing
+    const char *modes[] = {"full", "counters-only", "silent"};
+    std::vector<double> throughputs[3];
+    size_t events[3] = {};
+    long long bytes[3] = {};
+    for (int repeat = 0; repeat < repeats; ++repeat)
+        for (int mode = 0; mode < 3; ++mode)
+        {
+            SimulationConfig config = scenario;
+            config.eventMask = mode == 0 ? EVENTS_ALL : EVENTS_NONE;
+            Simulation sim(config);
+            sim.setOutput(mode == 2 ? nullptr : &discard);
+            sink.takeBytes(); // Leaves out the setup messages
+
+            events[mode] = 0;
+            int monthsRun = 0;
+            auto start = std::chrono::steady_clock::now();
+            for (; monthsRun < months && sim.hasMonthsRemaining(); ++monthsRun)
+            {
+                sim.runMonth();
+                events[mode] += sim.getStats().getMonthlyEvents().size();
+            }
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            throughputs[mode].push_back(seconds > 0.0 ? monthsRun / seconds : 0.0);
+            bytes[mode] = sink.takeBytes();
+        }
+
+    for (int mode = 0; mode < 3; ++mode)
+    {
+        std::vector<double> &runs = throughputs[mode];
+        std::nth_element(runs.begin(), runs.begin() + repeats / 2, runs.end());
+        std::cout << std::left << std::setw(16) << modes[mode] << std::setw(12) << std::fixed << std::setprecision(2)
+                  << runs[repeats / 2] << std::setw(16) << events[mode] << bytes[mode] << "\n";
+    }
+    return 0;
+}
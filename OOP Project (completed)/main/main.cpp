@@ -1,11 +1,83 @@
 // main.cpp
 #include "../headers/simulation.hpp" // This will include other necessary headers like iostream, grid, etc.
 
+#include <fstream>
+
+// Runs a simulation set up entirely by command-line flags and config files, never reading
+// stdin or pausing. Options apply in order, so flags after --config override the file.
+static int runBatch(int argc, char *argv[])
+{
+    SimulationConfig config;
+    std::string outputPath;
+    std::string error;
+
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string flag = argv[i];
+        if (i + 1 >= argc)
+        {
+            std::cerr << "Missing value for " << flag << "\n";
+            return 1;
+        }
+        std::string value = argv[++i];
+        if (flag == "--config")
+        {
+            if (config.loadFile(value, error))
+                continue;
+        }
+        else if (flag == "--output")
+        {
+            outputPath = value;
+            continue;
+        }
+        else if (flag.compare(0, 2, "--") == 0 && config.applyOption(flag.substr(2), value, error))
+            continue;
+        std::cerr << "Error: " << (error.empty() ? "Unknown option " + flag : error) << "\n";
+        return 1;
+    }
+    if (!config.validate(error))
+    {
+        std::cerr << "Error: " << error << "\n";
+        return 1;
+    }
+
+    std::ofstream outputFile;
+    if (!outputPath.empty() && outputPath != "-" && outputPath != "none")
+    {
+        outputFile.open(outputPath);
+        if (!outputFile)
+        {
+            std::cerr << "Error: Could not open " << outputPath << " for writing.\n";
+            return 1;
+        }
+    }
+    Simulation sim(config);
+    sim.setOutput(outputPath == "none" ? nullptr : outputFile.is_open() ? &outputFile : &std::cout);
+    if (!config.restoreFile.empty() && !sim.loadCheckpoint(config.restoreFile, error))
+    {
+        std::cerr << "Error: " << error << "\n";
+        return 1;
+    }
+    sim.runToCompletion();
+    const std::vector<std::string> writeErrors = sim.getWriteErrors();
+    for (const std::string &writeError : writeErrors)
+        std::cerr << "Error: " << writeError << "\n";
+    return writeErrors.empty() ? 0 : 1;
+}
+
 // --- Main Function ---
 // Entry point of the simulation program.
-int main()
+// Usage: main                asks for the setup on stdin and pauses after every month
+//        main --ansi         the same, redrawing only the grid cells that change
+//        main --batch [--config FILE] [--output FILE|-|none] [--years N ...] (any SimulationConfig option)
+//                            runs unattended: no prompts, errors go to stderr with exit status 1
+//                            (--checkpoint FILE --checkpoint-every N saves the run state, --restore FILE carries on from it)
+int main(int argc, char *argv[])
 {
+    if (argc > 1 && std::string(argv[1]) == "--batch")
+        return runBatch(argc, argv);
     Simulation sim;
-    sim.start();
-    return 0;
+    if (argc > 1 && std::string(argv[1]) == "--ansi")
+        sim.setAnsiRendering(true);
+    return sim.start() ? 0 : 1;
 }
\ No newline at end of file
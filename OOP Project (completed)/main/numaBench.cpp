@@ -0,0 +1,87 @@
+// numaBench.cpp (driver)
+#include "../headers/simulation.hpp"
+#include "../headers/numaPlacement.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+
+// --- NUMA Placement Benchmark ---
+// Runs the same large world three times (free threads, pinned threads, pinned threads with
+// grid memory moved next to its workers) and prints the month throughput of each.
+// Usage: numaBench [--size N] [--months N] [--threads N] [any SimulationConfig option]
+// The default 8192 x 8192 world needs several GB of memory.
+int main(int argc, char *argv[])
+{
+    SimulationConfig scenario;
+    int size = 8192;
+    int months = 6;
+    std::string error;
+    scenario.workerThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    scenario.parallelPlantUpdate = true;
+    scenario.intentMovement = true;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string flag = argv[i];
+        if (i + 1 >= argc)
+        {
+            std::cerr << "Missing value for " << flag << "\n";
+            return 1;
+        }
+        std::string value = argv[++i];
+        bool applied = true;
+        if (flag == "--size") applied = SimulationConfig::parseCount(flag, value, 1, size, error);
+        else if (flag == "--months") applied = SimulationConfig::parseCount(flag, value, 1, months, error);
+        else applied = flag.compare(0, 2, "--") == 0 && scenario.applyOption(flag.substr(2), value, error);
+        if (!applied)
+        {
+            std::cerr << "Error: " << (error.empty() ? "Unknown option " + flag : error) << "\n";
+            return 1;
+        }
+    }
+    scenario.gridHeight = scenario.gridWidth = size;
+    scenario.initialPlants = size * size / 4;
+    scenario.initialHerbivores = size * size / 50;
+    scenario.initialCarnivores = size * size / 500;
+    scenario.years = std::max(1, (months + 11) / 12);
+    scenario.pinThreads = true;
+    scenario.numaPlacement = true;
+    if (!scenario.validate(error))
+    {
+        std::cerr << "Error: " << error << "\n";
+        return 1;
+    }
+
+    std::cout << size << " x " << size << " grid, " << months << " months, " << scenario.workerThreads
+              << " threads, " << numaNodeCount() << " NUMA node(s)\n";
+    std::cout << std::left << std::setw(22) << "Variant" << std::setw(14) << "Setup (s)" << "Months/s\n";
+
+    const char *variants[] = {"free threads", "pinned", "pinned + placement"};
+    for (int variant = 0; variant < 3; ++variant)
+    {
+        SimulationConfig config = scenario;
+        config.pinThreads = variant >= 1;
+        config.numaPlacement = variant == 2;
+
+        auto setupStart = std::chrono::steady_clock::now();
+        Simulation sim(config);
+        sim.setOutput(nullptr);
+        auto runStart = std::chrono::steady_clock::now();
+        int monthsRun = 0;
+        for (; monthsRun < months && sim.hasMonthsRemaining(); ++monthsRun)
+            sim.runMonth();
+        auto runEnd = std::chrono::steady_clock::now();
+
+        double setupSeconds = std::chrono::duration<double>(runStart - setupStart).count();
+        double runSeconds = std::chrono::duration<double>(runEnd - runStart).count();
+        std::cout << std::left << std::setw(22) << variants[variant] << std::setw(14) << std::fixed << std::setprecision(2)
+                  << setupSeconds << std::setprecision(3) << (runSeconds > 0.0 ? monthsRun / runSeconds : 0.0) << "\n";
+        if (variant == 2)
+            NumaPlacement::report(NumaPlacement::survey(sim.getGrid()), std::cout);
+    }
+    return 0;
+}
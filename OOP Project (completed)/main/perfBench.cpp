@@ -0,0 +1,66 @@
+// perfBench.cpp (driver)
+#include "../headers/simulation.hpp"
+
+#include <iostream>
+#include <string>
+#include <algorithm>
+
+// --- Hardware Counter Benchmark ---
+// Runs one world silently with phase timing and hardware counters on, then prints the time
+// and the cycles, instructions, cache misses and branch misses per entity update of each
+// phase. Run it before and after a layout change to Grid or Animal to see whether the
+// change removed misses or only moved work between phases.
+// Counters cover the simulation thread only, so the default is a single thread. Where
+// perf_event_open is not allowed (many containers) only the timings are printed.
+// Usage: perfBench [--size N] [--months N] [any SimulationConfig option]
+int main(int argc, char *argv[])
+{
+    SimulationConfig scenario;
+    int size = 200;
+    int months = 24;
+    std::string error;
+    scenario.phaseTiming = true;
+    scenario.hardwareCounters = true;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string flag = argv[i];
+        if (i + 1 >= argc)
+        {
+            std::cerr << "Missing value for " << flag << "\n";
+            return 1;
+        }
+        std::string value = argv[++i];
+        bool applied = true;
+        if (flag == "--size") applied = SimulationConfig::parseCount(flag, value, 1, size, error);
+        else if (flag == "--months") applied = SimulationConfig::parseCount(flag, value, 1, months, error);
+        else applied = flag.compare(0, 2, "--") == 0 && scenario.applyOption(flag.substr(2), value, error);
+        if (!applied)
+        {
+            std::cerr << "Error: " << (error.empty() ? "Unknown option " + flag : error) << "\n";
+            return 1;
+        }
+    }
+    scenario.gridHeight = scenario.gridWidth = size;
+    scenario.initialPlants = size * size / 4;
+    scenario.initialHerbivores = size * size / 12;
+    scenario.initialCarnivores = size * size / 120;
+    scenario.years = std::max(1, (months + 11) / 12);
+    if (!scenario.validate(error))
+    {
+        std::cerr << "Error: " << error << "\n";
+        return 1;
+    }
+
+    Simulation sim(scenario);
+    sim.setOutput(nullptr);
+    int monthsRun = 0;
+    for (; monthsRun < months && sim.hasMonthsRemaining(); ++monthsRun)
+        sim.runMonth();
+
+    std::cout << size << " x " << size << " grid, " << monthsRun << " months, " << scenario.workerThreads << " thread(s)\n";
+    if (!sim.getEndReason().empty())
+        std::cout << "Stopped early: " << sim.getEndReason() << "\n";
+    sim.getPhaseTimer().report(std::cout);
+    return 0;
+}
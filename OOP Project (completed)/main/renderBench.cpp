@@ -0,0 +1,132 @@
+// renderBench.cpp (driver)
+#include "../headers/simulation.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+
+// --- Grid Rendering Benchmark ---
+// Populates grids of 20 x 20, 200 x 200 and 1000 x 1000 cells and times printing one frame
+// to /dev/null two ways:
+//   streamed  the former Grid::display: a stream insertion per cell and std::endl per row
+//   buffered  Grid::display: the frame laid out in one reused buffer and written at once
+// Both are checked to print the same characters.
+// Usage: renderBench [--frames N] [--sizes 20,200,1000]
+namespace
+{
+// Prints symbols the way Grid::displaySymbols did before frames were buffered.
+void displayStreamed(std::ostream &out, const std::vector<char> &symbols, int firstRow, int width)
+{
+    out << std::setw(5) << " ";
+    for (int j = 0; j < width; ++j)
+        out << std::setw(2) << std::left << j;
+    out << std::endl;
+    out << std::setw(5) << " ";
+    for (int j = 0; j < width; ++j)
+        out << "--";
+    out << std::endl;
+
+    const int rows = width > 0 ? static_cast<int>(symbols.size()) / width : 0;
+    for (int i = 0; i < rows; ++i)
+    {
+        out << std::setw(2) << std::right << firstRow + i << " | ";
+        for (int j = 0; j < width; ++j)
+            out << symbols[static_cast<size_t>(i) * width + j] << " ";
+        out << std::endl;
+    }
+}
+
+// Gets the mean seconds per call of frame() over the given number of frames.
+template <class Frame>
+double secondsPerFrame(int frames, Frame frame)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; ++i)
+        frame();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / frames;
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    int frames = 0; // 0 = enough frames for about the same number of cells at every size
+    std::vector<int> sizes = {20, 200, 1000};
+    std::string error;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string flag = argv[i];
+        if (i + 1 >= argc)
+        {
+            std::cerr << "Missing value for " << flag << "\n";
+            return 1;
+        }
+        std::string value = argv[++i];
+        bool applied = true;
+        if (flag == "--frames") applied = SimulationConfig::parseCount(flag, value, 0, frames, error);
+        else if (flag == "--sizes")
+        {
+            sizes.clear();
+            std::stringstream list(value);
+            std::string item;
+            int size = 0;
+            while (applied && std::getline(list, item, ','))
+            {
+                applied = SimulationConfig::parseCount(flag, item, 1, size, error);
+                sizes.push_back(size);
+            }
+        }
+        else applied = false;
+        if (!applied)
+        {
+            std::cerr << "Error: " << (error.empty() ? "Unknown option " + flag : error) << "\n";
+            return 1;
+        }
+    }
+    if (sizes.empty())
+    {
+        std::cerr << "Error: --sizes needs at least one grid size.\n";
+        return 1;
+    }
+
+    std::ofstream sink("/dev/null");
+    if (!sink)
+    {
+        std::cerr << "Error: Could not open /dev/null.\n";
+        return 1;
+    }
+    std::cout << std::left << std::setw(12) << "Grid" << std::setw(10) << "Frames" << std::setw(14) << "Streamed ms"
+              << std::setw(14) << "Buffered ms" << std::setw(10) << "Speedup" << "Same output\n";
+    for (int size : sizes)
+    {
+        SimulationConfig config;
+        config.gridHeight = config.gridWidth = size;
+        config.initialPlants = size * size / 4;
+        config.initialHerbivores = size * size / 12;
+        config.initialCarnivores = size * size / 120;
+        Simulation sim(config);
+        sim.setOutput(nullptr);
+        const Grid &grid = sim.getGrid();
+        const std::vector<char> symbols = grid.symbolSnapshot();
+        const int count = frames > 0 ? frames : std::max(3, 20000000 / (size * size));
+
+        std::ostringstream streamed, buffered;
+        displayStreamed(streamed, symbols, 0, size);
+        grid.display(buffered);
+        const bool same = streamed.str() == buffered.str();
+
+        double streamedSeconds = secondsPerFrame(count, [&] { displayStreamed(sink, grid.symbolSnapshot(), 0, size); });
+        double bufferedSeconds = secondsPerFrame(count, [&] { grid.display(sink); });
+        std::cout << std::left << std::setw(12) << (std::to_string(size) + " x " + std::to_string(size))
+                  << std::setw(10) << count << std::fixed << std::setprecision(3) << std::setw(14)
+                  << streamedSeconds * 1000.0 << std::setw(14) << bufferedSeconds * 1000.0 << std::setprecision(1)
+                  << std::setw(10) << (bufferedSeconds > 0.0 ? streamedSeconds / bufferedSeconds : 0.0)
+                  << (same ? "yes" : "NO") << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,102 @@
+// snapshotStats.cpp (driver)
+#include "../headers/worldSnapshot.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+// --- World Snapshot Summary ---
+// Maps world snapshots read-only (see WorldSnapshot) and prints, for each, the occupied cells
+// and every species' count, sexes, pregnancies and mean column values, straight from the
+// mapped columns. Also checks that every cell refers to an entity listed at that cell.
+// Usage: snapshotStats FILE [FILE ...]
+namespace
+{
+// Prints the mean of one column of a species.
+void printMean(const WorldSnapshot &snapshot, EntityType species, SnapshotColumn column, const char *name)
+{
+    const std::int32_t *values = snapshot.getColumn(species, column);
+    const size_t count = snapshot.getCount(species);
+    if (!values || count == 0)
+        return;
+    long long sum = 0;
+    for (size_t i = 0; i < count; ++i)
+        sum += values[i];
+    std::cout << "  mean " << name << " " << std::fixed << std::setprecision(2) << static_cast<double>(sum) / count;
+}
+
+// Prints one species' line.
+void printSpecies(const WorldSnapshot &snapshot, EntityType species, const char *name)
+{
+    const size_t count = snapshot.getCount(species);
+    std::cout << std::left << std::setw(12) << name << std::right << std::setw(10) << count;
+    if (species != EntityType::PLANT)
+    {
+        const std::uint8_t *flags = snapshot.getFlags(species);
+        size_t females = 0, pregnant = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            females += (flags[i] & SNAPSHOT_FEMALE) != 0;
+            pregnant += (flags[i] & SNAPSHOT_PREGNANT) != 0;
+        }
+        std::cout << "  females " << females << "  pregnant " << pregnant;
+        printMean(snapshot, species, SnapshotColumn::ENERGY, "energy");
+        printMean(snapshot, species, SnapshotColumn::MEALS_MISSED, "meals missed");
+    }
+    printMean(snapshot, species, SnapshotColumn::AGE, "age");
+    std::cout << "\n";
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: snapshotStats FILE [FILE ...]\n";
+        return 1;
+    }
+    int status = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        WorldSnapshot snapshot;
+        std::string error;
+        if (!snapshot.open(argv[i], error))
+        {
+            std::cerr << "Error: " << error << "\n";
+            status = 1;
+            continue;
+        }
+        size_t occupied = 0, remains = 0, mismatched = 0;
+        for (int r = snapshot.getFirstRow(); r < snapshot.getFirstRow() + snapshot.getHeight(); ++r)
+            for (int c = 0; c < snapshot.getWidth(); ++c)
+            {
+                const std::uint32_t cell = snapshot.getCell(r, c);
+                EntityType species;
+                size_t index;
+                if (cell == SNAPSHOT_REMAINS_CELL)
+                    remains++;
+                else if (snapshot.getCellEntity(cell, species, index))
+                {
+                    occupied++;
+                    if (snapshot.getColumn(species, SnapshotColumn::ROW)[index] != r ||
+                        snapshot.getColumn(species, SnapshotColumn::COL)[index] != c)
+                        mismatched++;
+                }
+                else if (cell != SNAPSHOT_EMPTY_CELL)
+                    mismatched++;
+            }
+
+        std::cout << argv[i] << ": " << snapshot.getHeight() << " x " << snapshot.getWidth() << " cells from row "
+                  << snapshot.getFirstRow() << ", after month " << snapshot.getMonth() << "\n";
+        std::cout << "Occupied cells " << occupied << ", remains " << remains << "\n";
+        printSpecies(snapshot, EntityType::PLANT, "Plants");
+        printSpecies(snapshot, EntityType::HERBIVORE, "Herbivores");
+        printSpecies(snapshot, EntityType::CARNIVORE, "Carnivores");
+        if (mismatched > 0)
+        {
+            std::cout << mismatched << " cells refer to entities listed elsewhere.\n";
+            status = 1;
+        }
+    }
+    return status;
+}
@@ -0,0 +1,79 @@
+// sweep.cpp (driver)
+#include "../headers/parameterSweep.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <algorithm>
+
+// --- Parameter Sweep Driver ---
+// Runs every combination of the given axes with several replicates and writes one CSV table.
+// Usage: sweep --axis herbivore.maxAge=60:90:10 [--axis carnivore.visionRange=4,6,8 ...]
+//              [--replicates N] [--threads N] [--out FILE] [any SimulationConfig option, e.g. --years 5]
+int main(int argc, char *argv[])
+{
+    SimulationConfig baseConfig;
+    std::vector<SweepAxis> axes;
+    int replicates = 3;
+    int threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::string outPath;
+    std::string error;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string flag = argv[i];
+        if (i + 1 >= argc)
+        {
+            std::cerr << "Missing value for " << flag << "\n";
+            return 1;
+        }
+        std::string value = argv[++i];
+        bool applied = true;
+        if (flag == "--axis")
+        {
+            SweepAxis axis;
+            if (!ParameterSweep::parseAxis(value, axis, error))
+            {
+                std::cerr << "Error: " << error << "\n";
+                return 1;
+            }
+            axes.push_back(axis);
+        }
+        else if (flag == "--replicates") applied = SimulationConfig::parseCount(flag, value, 1, replicates, error);
+        else if (flag == "--threads") applied = SimulationConfig::parseCount(flag, value, 1, threads, error); // Runs side by side, not inside a run
+        else if (flag == "--out") outPath = value;
+        else applied = flag.compare(0, 2, "--") == 0 && baseConfig.applyOption(flag.substr(2), value, error);
+        if (!applied)
+        {
+            std::cerr << "Error: " << (error.empty() ? "Unknown option " + flag : error) << "\n";
+            return 1;
+        }
+    }
+
+    ParameterSweep sweep(baseConfig, replicates, threads);
+    for (const auto &axis : axes)
+        if (!sweep.addAxis(axis, error))
+        {
+            std::cerr << "Error: " << error << "\n";
+            return 1;
+        }
+    std::cerr << "Sweeping " << sweep.getPointCount() << " points x " << replicates << " replicates on " << threads << " threads\n";
+
+    std::ofstream outFile;
+    if (!outPath.empty())
+    {
+        outFile.open(outPath);
+        if (!outFile)
+        {
+            std::cerr << "Error: cannot open " << outPath << "\n";
+            return 1;
+        }
+    }
+    if (!sweep.run(outPath.empty() ? std::cout : outFile, error))
+    {
+        std::cerr << "Error: " << error << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -1,8 +1,9 @@
 // animal.cpp
 #include "../headers/animal.hpp"
 #include "../headers/grid.hpp"         // For Grid class (full definition needed for operations)
-#include "../headers/monthlyStats.hpp" // For MonthlyStats struct (full definition needed)
+#include "../headers/statsShard.hpp" // For StatsShard struct (full definition needed)
 #include "../headers/utils.hpp"        // For getRandomInt, getRandomDouble
+#include "../headers/traceRecorder.hpp"
 
 #include "../headers/herbivore.hpp"  
 #include "../headers/carnivore.hpp"
@@ -24,11 +25,15 @@ Animal::Animal(int r_coord, int c_coord, EntityType type_val, char maleSymbol, c
 Gender Animal::getGender() const { return animalGender; } // Call specific getter
 
 // Handles the death of an animal.
-void Animal::die(MonthlyStats &stats, bool eaten)
+void Animal::die(StatsShard &stats, bool eaten)
 {
     if (!isAlive()) // Use Entity's isAlive()
         return;
     kill(); // Use Entity's kill()
+    stats.recordAnimalDeath(*this);
+    stats.recordCell(eaten ? HeatmapLayer::EATEN
+                           : currentAge > maximumAge ? HeatmapLayer::DIED_OLD_AGE : HeatmapLayer::DIED_STARVATION,
+                     getR(), getC());
     if (!eaten)
     {
         if (getType() == EntityType::HERBIVORE) // Use Entity's getType()
@@ -39,7 +44,7 @@ void Animal::die(MonthlyStats &stats, bool eaten)
 }
 
 // Base update logic common to all animals.
-void Animal::baseUpdate(MonthlyStats &stats, Season currentSeason)
+void Animal::baseUpdate(StatsShard &stats, Season currentSeason)
 {
     if (!isAlive())
         return;
@@ -64,6 +69,12 @@ void Animal::baseUpdate(MonthlyStats &stats, Season currentSeason)
     }
     if (currentEnergy <= 0 || currentAge > maximumAge || mealsMissedTurns > maxTurnsWithoutFoodAllowed)
         die(stats);
+    else
+    {
+        stats.recordAnimalState(*this);
+        stats.recordCell(getType() == EntityType::HERBIVORE ? HeatmapLayer::HERBIVORE_OCCUPANCY : HeatmapLayer::CARNIVORE_OCCUPANCY,
+                         getR(), getC());
+    }
 }
 
 // Checks if the animal can currently reproduce.
@@ -74,24 +85,39 @@ bool Animal::canReproduceInternal() const
 }
 
 // Overridden update logic for animals.
-void Animal::update(Grid &grid, MonthlyStats &stats, Season currentSeason)
+void Animal::update(Grid &grid, StatsShard &stats, Season currentSeason)
 {
-    if (!isAlive())
+    if (!updateBeforeMove(grid, stats, currentSeason))
         return;
+    
+    move(grid, stats, currentSeason); // move() will deduct its own energy cost
+    
+    if (currentEnergy <= 0 && isAlive()) // Final check after all actions
+        die(stats);
+}
+
+// Runs everything in update() that comes before moving; returns true if the animal should still move.
+bool Animal::updateBeforeMove(Grid &grid, StatsShard &stats, Season currentSeason)
+{
+    if (!isAlive())
+        return false;
     baseUpdate(stats, currentSeason);
     if (!isAlive())
-        return;
+        return false;
     
     if (attemptEat(grid, stats, currentSeason))
     { 
         mealsMissedTurns = 0; // Reset if ate
     }
     if (!isAlive())
-        return;
+        return false;
 
     if (currentlyPregnant && currentGestationProgress >= periodOfGestation)
     {
-        giveBirth(grid, stats);
+        {
+            ECOSIM_TRACE_SCOPE("giveBirth", "entities", "id", static_cast<long long>(getId()));
+            giveBirth(grid, stats);
+        }
         currentlyPregnant = false;
         currentGestationProgress = 0;
         currentCooldownForReproduction = cooldownForReproduction; // Use base cooldown value
@@ -100,7 +126,7 @@ void Animal::update(Grid &grid, MonthlyStats &stats, Season currentSeason)
             die(stats);
     }
     if (!isAlive())
-        return;
+        return false;
 
     // Mate finding logic for females who can reproduce.
     if (animalGender == Gender::FEMALE && !currentlyPregnant && currentCooldownForReproduction == 0 && 
@@ -139,13 +165,29 @@ void Animal::update(Grid &grid, MonthlyStats &stats, Season currentSeason)
             attemptReproduce(grid, stats, mates_found, currentSeason);
     }
 
-    if (!isAlive())
-        return;
-    
-    move(grid, stats, currentSeason); // move() will deduct its own energy cost
-    
-    if (currentEnergy <= 0 && isAlive()) // Final check after all actions
+    return isAlive();
+}
+
+// Movement logic: plans a move and applies it straight away.
+void Animal::move(Grid &grid, StatsShard &stats, Season currentSeason)
+{
+    if (!isAlive()) return;
+
+    if (currentEnergy <= 0) { // Check before deducting potential move cost by other means
         die(stats);
+        return;
+    }
+
+    MoveIntent intent = planMove(grid, currentSeason);
+    if (intent.moves)
+        applyMove(grid, intent);
+}
+
+// Deducts the movement cost and applies a planned move on the grid (a refused move still costs the effort).
+void Animal::applyMove(Grid &grid, const MoveIntent &intent)
+{
+    grid.moveEntity(grid.getEntity(getR(), getC()), intent.targetR, intent.targetC);
+    setCurrentEnergy(currentEnergy - movementCostBase);
 }
 
 
@@ -167,9 +209,28 @@ int Animal::getEnergyRequiredToReproduce() const { return energyRequiredToReprod
 int Animal::getMealsMissedTurns() const { return mealsMissedTurns; }
 int Animal::getMaxTurnsWithoutFoodAllowed() const { return maxTurnsWithoutFoodAllowed; }
 double Animal::getAnimalSize() const { return animalSize; }
+AnimalParams Animal::getParams() const
+{
+    return {maximumAge, maximumEnergy, sightRange, movementCostBase, periodOfGestation, minimumBreedingAge,
+            energyRequiredToReproduce, maxTurnsWithoutFoodAllowed, animalSize};
+}
+AnimalState Animal::getState() const
+{
+    return {currentAge, currentEnergy, currentCooldownForReproduction, currentlyPregnant,
+            currentGestationProgress, mealsMissedTurns};
+}
 
 // Setters/Modifiers
 void Animal::setCurrentEnergy(int energy_val) { 
     currentEnergy = std::max(0, std::min(energy_val, maximumEnergy)); 
 }
-void Animal::setCurrentlyPregnant(bool is_pregnant_val) { currentlyPregnant = is_pregnant_val; }
\ No newline at end of file
+void Animal::setCurrentlyPregnant(bool is_pregnant_val) { currentlyPregnant = is_pregnant_val; }
+void Animal::setState(const AnimalState &state)
+{
+    currentAge = state.currentAge;
+    currentEnergy = state.currentEnergy;
+    currentCooldownForReproduction = state.currentCooldownForReproduction;
+    currentlyPregnant = state.currentlyPregnant;
+    currentGestationProgress = state.currentGestationProgress;
+    mealsMissedTurns = state.mealsMissedTurns;
+}
\ No newline at end of file
@@ -0,0 +1,97 @@
+// animalHistograms.cpp
+#include "../headers/animalHistograms.hpp"
+#include "../headers/animal.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+// Bins of each histogram, and where each one starts within a species' bins.
+static const size_t BIN_COUNTS[AnimalHistograms::HISTOGRAM_COUNT] = {10, 10, 8, 5, 10};
+static const size_t BIN_OFFSETS[AnimalHistograms::HISTOGRAM_COUNT] = {0, 10, 20, 28, 33};
+
+// Splits value / maximum into bins of equal width, clamping to the first and last bin.
+static size_t fractionBin(int value, int maximum, size_t bins)
+{
+    if (value <= 0 || maximum <= 0)
+        return 0;
+    return std::min(bins - 1, static_cast<size_t>(static_cast<long long>(value) * bins / maximum));
+}
+
+// Gets the position of one bin in the counts (species must be HERBIVORE or CARNIVORE).
+size_t AnimalHistograms::indexOf(EntityType species, AnimalHistogram histogram, size_t binIndex)
+{
+    size_t speciesIndex = species == EntityType::CARNIVORE ? 1 : 0;
+    return speciesIndex * BINS_PER_SPECIES + BIN_OFFSETS[static_cast<size_t>(histogram)] + binIndex;
+}
+
+// Adds an animal's current energy, age, meals missed and gestation state.
+void AnimalHistograms::recordState(const Animal &animal)
+{
+    const EntityType species = animal.getType();
+    counts[indexOf(species, AnimalHistogram::ENERGY, fractionBin(animal.getCurrentEnergy(), animal.getMaximumEnergy(), 10))]++;
+    counts[indexOf(species, AnimalHistogram::AGE, fractionBin(animal.getCurrentAge(), animal.getMaximumAge(), 10))]++;
+    counts[indexOf(species, AnimalHistogram::MEALS_MISSED, static_cast<size_t>(std::min(7, std::max(0, animal.getMealsMissedTurns()))))]++;
+    size_t gestation = animal.isCurrentlyPregnant()
+                           ? 1 + fractionBin(animal.getCurrentGestationProgress(), animal.getPeriodOfGestation(), 4)
+                           : 0;
+    counts[indexOf(species, AnimalHistogram::GESTATION, gestation)]++;
+    anyCounts = true;
+}
+
+// Adds the age an animal reached when it died.
+void AnimalHistograms::recordDeath(const Animal &animal)
+{
+    counts[indexOf(animal.getType(), AnimalHistogram::AGE_AT_DEATH, fractionBin(animal.getCurrentAge(), animal.getMaximumAge(), 10))]++;
+    anyCounts = true;
+}
+
+// Adds another month's (or tile's) counts; an empty one (e.g. a plant tile's) costs nothing.
+void AnimalHistograms::absorb(const AnimalHistograms &other)
+{
+    if (other.isEmpty())
+        return;
+    anyCounts = true;
+    for (size_t i = 0; i < counts.size(); ++i)
+        counts[i] += other.counts[i];
+}
+
+// Empties every bin.
+void AnimalHistograms::clear()
+{
+    counts.fill(0);
+    anyCounts = false;
+}
+
+// Gets the count of one bin.
+std::uint32_t AnimalHistograms::getCount(EntityType species, AnimalHistogram histogram, size_t binIndex) const
+{
+    return counts[indexOf(species, histogram, binIndex)];
+}
+
+// Gets the number of bins of a histogram.
+size_t AnimalHistograms::getBinCount(AnimalHistogram histogram)
+{
+    return BIN_COUNTS[static_cast<size_t>(histogram)];
+}
+
+// Gets the CSV name of a histogram.
+const char *AnimalHistograms::getHistogramName(AnimalHistogram histogram)
+{
+    static const char *const names[HISTOGRAM_COUNT] = {"energy", "age", "mealsMissed", "gestation", "ageAtDeath"};
+    return names[static_cast<size_t>(histogram)];
+}
+
+// Writes the CSV header line.
+void AnimalHistograms::writeCsvHeader(std::ostream &out) { out << "month,species,histogram,bin,count\n"; }
+
+// Writes the CSV rows of one month.
+void AnimalHistograms::writeCsvRows(std::ostream &out, size_t month) const
+{
+    const EntityType species[SPECIES_COUNT] = {EntityType::HERBIVORE, EntityType::CARNIVORE};
+    const char *const speciesNames[SPECIES_COUNT] = {"herbivore", "carnivore"};
+    for (size_t s = 0; s < SPECIES_COUNT; ++s)
+        for (size_t h = 0; h < HISTOGRAM_COUNT; ++h)
+            for (size_t b = 0; b < getBinCount(static_cast<AnimalHistogram>(h)); ++b)
+                out << month + 1 << ',' << speciesNames[s] << ',' << getHistogramName(static_cast<AnimalHistogram>(h))
+                    << ',' << b << ',' << getCount(species[s], static_cast<AnimalHistogram>(h), b) << '\n';
+}
@@ -0,0 +1,141 @@
+// ansiRenderer.cpp
+#include "../headers/ansiRenderer.hpp"
+#include "../headers/grid.hpp"
+
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <ostream>
+#include <charconv>
+#include <algorithm>
+
+// Appends a number in decimal.
+static void appendNumber(std::string &frame, int value)
+{
+    char digits[12];
+    frame.append(digits, std::to_chars(digits, digits + sizeof(digits), value).ptr);
+}
+
+// Appends the sequence that moves the cursor to a 1-based line and column.
+static void appendCursorMove(std::string &frame, int line, int column)
+{
+    frame += "\x1b[";
+    appendNumber(frame, line);
+    frame += ';';
+    appendNumber(frame, column);
+    frame += 'H';
+}
+
+// Gets the lines and columns of the terminal on standard output; false if it is not a terminal.
+static bool terminalSize(int &lines, int &columns)
+{
+    winsize size;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) != 0 || size.ws_row == 0 || size.ws_col == 0)
+        return false;
+    lines = size.ws_row;
+    columns = size.ws_col;
+    return true;
+}
+
+// Gets the columns of the widest line Grid::renderSymbols lays out (the column numbers or the last row).
+static size_t frameColumns(int firstRow, int rows, int width)
+{
+    size_t header = 5;
+    for (int j = 0; j < width; ++j)
+        header += Grid::getLabelWidth(j);
+    const size_t lastRow = Grid::getLabelWidth(firstRow + std::max(0, rows - 1)) + 3 + 2 * static_cast<size_t>(width);
+    return std::max(header, lastRow);
+}
+
+// AnsiRenderer constructor (the first frame is always drawn in full).
+AnsiRenderer::AnsiRenderer(double fullRedrawFraction_val)
+    : fullRedrawFraction(fullRedrawFraction_val), shownFirstRow(0), shownWidth(0), hasFrame(false),
+      fullRedraws(0), partialRedraws(0), cellsRedrawn(0), plainFrames(0) {}
+
+// Draws the grid's owned rows and leaves the cursor on the first line below it.
+void AnsiRenderer::render(std::ostream &out, const Grid &grid)
+{
+    grid.symbolSnapshot(next);
+    render(out, next, grid.getOwnedRowBegin(), grid.getWidth());
+}
+
+// Draws symbols taken with Grid::symbolSnapshot. Line 1 holds the column numbers, line 2
+// the rule and line 3 + i grid row i; cell j of a row starts after its row label and " | ".
+void AnsiRenderer::render(std::ostream &out, const std::vector<char> &symbols, int firstRow, int width)
+{
+    const int rows = width > 0 ? static_cast<int>(symbols.size()) / width : 0;
+    const int textLine = rows + 3; // First line of the scroll region below the grid
+    frame.clear();
+
+    int screenLines = 0, screenColumns = 0;
+    if (terminalSize(screenLines, screenColumns) &&
+        (textLine > screenLines || frameColumns(firstRow, rows, width) > static_cast<size_t>(screenColumns)))
+    {
+        finish(out); // Any scroll region goes; the next frame that fits is drawn in full
+        Grid::renderSymbols(layout, symbols, firstRow, width);
+        out.write(layout.data(), static_cast<std::streamsize>(layout.size()));
+        out.flush();
+        plainFrames++;
+        return;
+    }
+
+    size_t changed = 0;
+    const bool sameShape = hasFrame && firstRow == shownFirstRow && width == shownWidth && symbols.size() == shown.size();
+    if (sameShape)
+        for (size_t i = 0; i < symbols.size(); ++i)
+            changed += symbols[i] != shown[i];
+
+    if (!sameShape || changed > fullRedrawFraction * static_cast<double>(symbols.size()))
+    {
+        // Reset the scroll region, clear the screen, draw the grid, then scroll only the text below it.
+        frame += "\x1b[r\x1b[H\x1b[2J";
+        Grid::renderSymbols(layout, symbols, firstRow, width);
+        frame += layout;
+        frame += "\x1b[";
+        appendNumber(frame, textLine);
+        frame += 'r';
+        fullRedraws++;
+    }
+    else
+    {
+        for (int i = 0; i < rows; ++i)
+        {
+            const size_t rowStart = static_cast<size_t>(i) * width;
+            const int firstColumn = static_cast<int>(Grid::getLabelWidth(firstRow + i)) + 4;
+            int previous = -2; // Last cell written in this row
+            for (int j = 0; j < width; ++j)
+            {
+                const char symbol = symbols[rowStart + j];
+                if (symbol == shown[rowStart + j])
+                    continue;
+                if (previous == j - 1)
+                    frame += ' '; // The cursor already sits on the space after the previous cell
+                else
+                    appendCursorMove(frame, i + 3, firstColumn + 2 * j);
+                frame += symbol;
+                previous = j;
+            }
+        }
+        partialRedraws++;
+        cellsRedrawn += changed;
+    }
+    // Continue below the grid, replacing the text printed after the last frame.
+    appendCursorMove(frame, textLine, 1);
+    frame += "\x1b[J";
+
+    out.write(frame.data(), static_cast<std::streamsize>(frame.size()));
+    out.flush();
+    shown.assign(symbols.begin(), symbols.end());
+    shownFirstRow = firstRow;
+    shownWidth = width;
+    hasFrame = true;
+}
+
+// Releases the scroll region (keeping the cursor where it is); the next frame is drawn in full.
+void AnsiRenderer::finish(std::ostream &out)
+{
+    if (!hasFrame)
+        return;
+    out << "\x1b" "7" "\x1b[r" "\x1b" "8"; // Save cursor, reset region (which homes it), restore cursor
+    out.flush();
+    hasFrame = false;
+}
@@ -1,20 +1,21 @@
 // carnivore.cpp
 #include "../headers/carnivore.hpp"
 #include "../headers/grid.hpp"
-#include "../headers/monthlyStats.hpp"
+#include "../headers/statsShard.hpp"
 #include "../headers/herbivore.hpp" // For casting and type checking
 #include "../headers/utils.hpp"     // For getRandomInt
 
 // Carnivore constructor.
-Carnivore::Carnivore(int r_coord, int c_coord, Gender gender_val)
+Carnivore::Carnivore(int r_coord, int c_coord, Gender gender_val, const AnimalParams &params)
     : Animal(r_coord, c_coord, EntityType::CARNIVORE, 'C', 'c', gender_val,
-             100, 120, 6, 15, 4, 5, 50, 2, 1.5) {}
+             params.maxAge, params.maxEnergy, params.visionRange, params.moveCost, params.gestationPeriod,
+             params.minBreedingAge, params.energyToReproduce, params.maxTurnsWithoutFood, params.size) {}
 
 // Gets the species name ("Carnivore").
 std::string Carnivore::getSpeciesName() const { return "Carnivore"; }
 
 // Carnivore's attempt to eat.
-bool Carnivore::attemptEat(Grid &grid, MonthlyStats &stats, Season currentSeason)
+bool Carnivore::attemptEat(Grid &grid, StatsShard &stats, Season currentSeason)
 {
     if (!isAlive() || getCurrentEnergy() >= getMaximumEnergy() * 0.9) return false;
     
@@ -35,12 +36,13 @@ bool Carnivore::attemptEat(Grid &grid, MonthlyStats &stats, Season currentSeason
                         auto target = grid.getEntity(nr_scan, nc_scan);
                         if (target && target->getType() == EntityType::HERBIVORE && target->isAlive())
                         {
-                            auto herb = std::static_pointer_cast<Herbivore>(target);
-                            setCurrentEnergy(std::min(getMaximumEnergy(), getCurrentEnergy() + 45)); // Use Animal's setters/getters
-                            herb->die(stats, true); // Call die on the herbivore
-                            stats.incrementHerbivoresEaten();
-                            stats.addMonthlyEvent("Carnivore at (" + std::to_string(getR()) + "," + std::to_string(getC()) + ") ate herbivore at (" + std::to_string(nr_scan) + "," + std::to_string(nc_scan) + ")");
-                            grid.removeEntity(herb, stats);
+                            if (grid.isGhost(*target))
+                                grid.claimGhost(target, *this); // Eaten once the owning subdomain grants it
+                            else
+                            {
+                                eatPrey(*target, stats);
+                                grid.removeEntity(target, stats);
+                            }
                             // mealsMissedTurns = 0; // This is managed in Animal::update based on eat success
                             return true;
                         }
@@ -50,18 +52,18 @@ bool Carnivore::attemptEat(Grid &grid, MonthlyStats &stats, Season currentSeason
     return false;
 }
 
-// Carnivore's movement logic.
-void Carnivore::move(Grid &grid, MonthlyStats &stats, Season currentSeason)
+// Carnivore's meal: gains energy, kills the herbivore and counts it.
+void Carnivore::eatPrey(Entity &prey, StatsShard &stats)
 {
-    if (!isAlive()) return;
-    
-    int energyBeforeMove = getCurrentEnergy();
-
-    if (energyBeforeMove <= 0) { 
-        if (isAlive()) die(stats); 
-        return;
-    }
+    setCurrentEnergy(std::min(getMaximumEnergy(), getCurrentEnergy() + 45)); // Use Animal's setters/getters
+    static_cast<Animal &>(prey).die(stats, true); // Call die on the herbivore
+    stats.incrementHerbivoresEaten();
+    ECOSIM_RECORD_EVENT(stats, EventKind::ATE, EntityType::CARNIVORE, getR(), getC(), getId(), prey.getR(), prey.getC(), prey.getId());
+}
 
+// Carnivore's movement choice, computed without changing the grid.
+MoveIntent Carnivore::planMove(const Grid &grid, Season) const
+{
     if (getCurrentEnergy() < getMaximumEnergy() * 0.85) 
     {
         auto herbsNearby = grid.findNearbyEntities(getR(), getC(), EntityType::HERBIVORE, getSightRange());
@@ -86,11 +88,7 @@ void Carnivore::move(Grid &grid, MonthlyStats &stats, Season currentSeason)
                 if (grid.isValid(nr_move_herb, nc_move_herb) && 
                     (grid.isEmpty(nr_move_herb, nc_move_herb) || 
                      (grid.getEntity(nr_move_herb, nc_move_herb) && grid.getEntity(nr_move_herb, nc_move_herb)->getType() == EntityType::HERBIVORE)))
-                {
-                    grid.moveEntity(grid.getEntity(getR(), getC()), nr_move_herb, nc_move_herb);
-                    setCurrentEnergy(getCurrentEnergy() - getMovementCostBase()); 
-                    return;
-                }
+                    return {nr_move_herb, nc_move_herb, true};
             }
         }
     }
@@ -99,15 +97,13 @@ void Carnivore::move(Grid &grid, MonthlyStats &stats, Season currentSeason)
     {
         int ch_rand_carn = 0; 
         if(emptyC_rand_carn.size() > 1) ch_rand_carn = getRandomInt(0, emptyC_rand_carn.size() - 1);
-        else if (emptyC_rand_carn.empty()) return;
-
-        grid.moveEntity(grid.getEntity(getR(), getC()), emptyC_rand_carn[ch_rand_carn].first, emptyC_rand_carn[ch_rand_carn].second);
-        setCurrentEnergy(getCurrentEnergy() - getMovementCostBase());
+        return {emptyC_rand_carn[ch_rand_carn].first, emptyC_rand_carn[ch_rand_carn].second, true};
     }
+    return {getR(), getC(), false};
 }
 
 // Carnivore's attempt to reproduce.
-void Carnivore::attemptReproduce(Grid &grid, MonthlyStats &stats, const std::vector<std::shared_ptr<Animal>> &potentialMates, Season currentSeason)
+void Carnivore::attemptReproduce(Grid &grid, StatsShard &stats, const std::vector<std::shared_ptr<Animal>> &potentialMates, Season currentSeason)
 {
     if (!isAlive() || !canReproduceInternal()) return;
     double repMul = 1.0;
@@ -128,14 +124,14 @@ void Carnivore::attemptReproduce(Grid &grid, MonthlyStats &stats, const std::vec
             // currentGestationProgress is reset in Animal::update after birth
             setCurrentEnergy(getCurrentEnergy() - getEnergyRequiredToReproduce() / 2);
             if(mate->isAlive()) mate->setCurrentEnergy(mate->getCurrentEnergy() - mate->getEnergyRequiredToReproduce() / 4);
-            stats.addMonthlyEvent("Carnivore at (" + std::to_string(getR()) + "," + std::to_string(getC()) + ") mated.");
+            ECOSIM_RECORD_EVENT(stats, EventKind::MATED, EntityType::CARNIVORE, getR(), getC(), getId(), mate->getR(), mate->getC(), mate->getId());
             return;
         }
     }
 }
 
 // Carnivore's logic for giving birth.
-void Carnivore::giveBirth(Grid &grid, MonthlyStats &stats)
+void Carnivore::giveBirth(Grid &grid, StatsShard &stats)
 {
     if (!isAlive()) return;
     std::vector<std::pair<int, int>> birthLocs = grid.getAdjacentEmptyCells(getR(), getC());
@@ -159,11 +155,13 @@ void Carnivore::giveBirth(Grid &grid, MonthlyStats &stats)
         auto pos_birth_carn = birthLocs[idx_birth_carn]; 
         birthLocs.erase(birthLocs.begin() + idx_birth_carn);
         Gender g_birth_carn = (getRandomInt(0, 1) == 0) ? Gender::MALE : Gender::FEMALE; 
-        auto newC_birth = std::make_shared<Carnivore>(pos_birth_carn.first, pos_birth_carn.second, g_birth_carn); 
+        auto newC_birth = std::make_shared<Carnivore>(pos_birth_carn.first, pos_birth_carn.second, g_birth_carn, getParams()); 
         if (grid.addEntity(newC_birth))
         {
             stats.incrementCarnivoresSpawned();
-            stats.addMonthlyEvent("Carnivore born at (" + std::to_string(pos_birth_carn.first) + "," + std::to_string(pos_birth_carn.second) + ")");
+            stats.recordAnimalState(*newC_birth);
+            stats.recordCell(HeatmapLayer::BIRTHS, pos_birth_carn.first, pos_birth_carn.second);
+            ECOSIM_RECORD_EVENT(stats, EventKind::BORN, EntityType::CARNIVORE, pos_birth_carn.first, pos_birth_carn.second, newC_birth->getId(), getR(), getC(), getId());
         }
     }
 }
\ No newline at end of file
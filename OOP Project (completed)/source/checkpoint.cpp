@@ -0,0 +1,307 @@
+// checkpoint.cpp
+#include "../headers/checkpoint.hpp"
+
+#include <cstring>
+#include <climits>
+#include <utility> // For std::move
+#include <iostream>
+
+static const char CHECKPOINT_MAGIC[8] = {'E', 'C', 'O', 'C', 'H', 'K', 'P', 'T'};
+static const std::uint32_t CHECKPOINT_VERSION = 1;
+static const std::uint32_t MAX_GENERATOR_WORDS = 1024; // std::mt19937 writes 624 or 625
+static const std::uint32_t MAX_END_REASON_BYTES = 4096;
+
+// Writes an unsigned value little-endian in the given number of bytes.
+static void writeUnsigned(std::ostream &out, std::uint64_t value, int byteCount)
+{
+    unsigned char bytes[8];
+    for (int i = 0; i < byteCount; ++i)
+        bytes[i] = static_cast<unsigned char>(value >> (8 * i));
+    out.write(reinterpret_cast<const char *>(bytes), byteCount);
+}
+
+static void writeUint8(std::ostream &out, std::uint8_t value) { writeUnsigned(out, value, 1); }
+static void writeInt32(std::ostream &out, std::int32_t value) { writeUnsigned(out, static_cast<std::uint32_t>(value), 4); }
+static void writeUint32(std::ostream &out, std::uint32_t value) { writeUnsigned(out, value, 4); }
+static void writeUint64(std::ostream &out, std::uint64_t value) { writeUnsigned(out, value, 8); }
+
+// Writes a double as its IEEE-754 bits, so it reads back unchanged.
+static void writeDouble(std::ostream &out, double value)
+{
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    writeUint64(out, bits);
+}
+
+// Reads an unsigned little-endian value of the given number of bytes; returns false at the end of the stream.
+static bool readUnsigned(std::istream &in, std::uint64_t &value, int byteCount)
+{
+    unsigned char bytes[8];
+    if (!in.read(reinterpret_cast<char *>(bytes), byteCount))
+        return false;
+    value = 0;
+    for (int i = 0; i < byteCount; ++i)
+        value |= static_cast<std::uint64_t>(bytes[i]) << (8 * i);
+    return true;
+}
+
+static bool readUint8(std::istream &in, std::uint8_t &value)
+{
+    std::uint64_t raw;
+    if (!readUnsigned(in, raw, 1))
+        return false;
+    value = static_cast<std::uint8_t>(raw);
+    return true;
+}
+
+static bool readInt32(std::istream &in, int &value)
+{
+    std::uint64_t raw;
+    if (!readUnsigned(in, raw, 4))
+        return false;
+    value = static_cast<std::int32_t>(static_cast<std::uint32_t>(raw));
+    return true;
+}
+
+static bool readUint32(std::istream &in, std::uint32_t &value)
+{
+    std::uint64_t raw;
+    if (!readUnsigned(in, raw, 4))
+        return false;
+    value = static_cast<std::uint32_t>(raw);
+    return true;
+}
+
+static bool readUint64(std::istream &in, unsigned long long &value)
+{
+    std::uint64_t raw;
+    if (!readUnsigned(in, raw, 8))
+        return false;
+    value = raw;
+    return true;
+}
+
+static bool readDouble(std::istream &in, double &value)
+{
+    std::uint64_t bits;
+    if (!readUnsigned(in, bits, 8))
+        return false;
+    std::memcpy(&value, &bits, sizeof(value));
+    return true;
+}
+
+// Writes one animal species' parameters.
+static void writeAnimalParams(std::ostream &out, const AnimalParams &params)
+{
+    const int values[] = {params.maxAge, params.maxEnergy, params.visionRange, params.moveCost, params.gestationPeriod,
+                          params.minBreedingAge, params.energyToReproduce, params.maxTurnsWithoutFood};
+    for (int value : values)
+        writeInt32(out, value);
+    writeDouble(out, params.size);
+}
+
+// Reads one animal species' parameters; returns false at the end of the stream.
+static bool readAnimalParams(std::istream &in, AnimalParams &params)
+{
+    int *values[] = {&params.maxAge, &params.maxEnergy, &params.visionRange, &params.moveCost, &params.gestationPeriod,
+                     &params.minBreedingAge, &params.energyToReproduce, &params.maxTurnsWithoutFood};
+    for (int *value : values)
+        if (!readInt32(in, *value))
+            return false;
+    return readDouble(in, params.size);
+}
+
+// Writes the plant parameters.
+static void writePlantParams(std::ostream &out, const PlantParams &params)
+{
+    writeInt32(out, params.spreadChance);
+    writeInt32(out, params.maxAge);
+    writeInt32(out, params.winterDeathChance);
+    writeInt32(out, params.autumnDeathChance);
+}
+
+// Reads the plant parameters; returns false at the end of the stream.
+static bool readPlantParams(std::istream &in, PlantParams &params)
+{
+    return readInt32(in, params.spreadChance) && readInt32(in, params.maxAge) &&
+           readInt32(in, params.winterDeathChance) && readInt32(in, params.autumnDeathChance);
+}
+
+static const std::uint8_t ENTITY_LISTED = 1;
+static const std::uint8_t ENTITY_IN_CELL = 2;
+
+// Writes one entity: flags, id, position, type and gender, then the plant's or the animal's fields.
+static void writeEntity(std::ostream &out, const CheckpointEntity &entity)
+{
+    const EntityRecord &record = entity.record;
+    writeUint8(out, (entity.listed ? ENTITY_LISTED : 0) | (entity.inCell ? ENTITY_IN_CELL : 0));
+    writeUint64(out, record.id);
+    writeInt32(out, record.r);
+    writeInt32(out, record.c);
+    writeUint8(out, static_cast<std::uint8_t>(record.type));
+    writeUint8(out, static_cast<std::uint8_t>(record.gender));
+    if (record.type == EntityType::PLANT)
+    {
+        writePlantParams(out, record.plantParams);
+        writeInt32(out, record.plantAge);
+        return;
+    }
+    writeAnimalParams(out, record.animalParams);
+    const AnimalState &state = record.animalState;
+    writeInt32(out, state.currentAge);
+    writeInt32(out, state.currentEnergy);
+    writeInt32(out, state.currentCooldownForReproduction);
+    writeUint8(out, state.currentlyPregnant ? 1 : 0);
+    writeInt32(out, state.currentGestationProgress);
+    writeInt32(out, state.mealsMissedTurns);
+}
+
+// Reads one entity; on failure error explains why.
+static bool readEntity(std::istream &in, CheckpointEntity &entity, std::string &error)
+{
+    std::uint8_t flags = 0, type = 0, gender = 0;
+    EntityRecord &record = entity.record;
+    record = EntityRecord{};
+    if (!readUint8(in, flags) || !readUint64(in, record.id) || !readInt32(in, record.r) || !readInt32(in, record.c) ||
+        !readUint8(in, type) || !readUint8(in, gender))
+    {
+        error = "Truncated checkpoint entity.";
+        return false;
+    }
+    entity.listed = (flags & ENTITY_LISTED) != 0;
+    entity.inCell = (flags & ENTITY_IN_CELL) != 0;
+    record.type = static_cast<EntityType>(type);
+    record.gender = static_cast<Gender>(gender);
+    if (type > static_cast<std::uint8_t>(EntityType::CARNIVORE) || record.type == EntityType::EMPTY ||
+        gender > static_cast<std::uint8_t>(Gender::NONE) || flags > (ENTITY_LISTED | ENTITY_IN_CELL))
+    {
+        error = "Checkpoint entity " + std::to_string(record.id) + " has an unknown type, gender or placement.";
+        return false;
+    }
+    bool complete;
+    if (record.type == EntityType::PLANT)
+        complete = readPlantParams(in, record.plantParams) && readInt32(in, record.plantAge);
+    else
+    {
+        AnimalState &state = record.animalState;
+        std::uint8_t pregnant = 0;
+        complete = readAnimalParams(in, record.animalParams) && readInt32(in, state.currentAge) &&
+                   readInt32(in, state.currentEnergy) && readInt32(in, state.currentCooldownForReproduction) &&
+                   readUint8(in, pregnant) && readInt32(in, state.currentGestationProgress) &&
+                   readInt32(in, state.mealsMissedTurns);
+        state.currentlyPregnant = pregnant != 0;
+    }
+    if (!complete)
+        error = "Truncated checkpoint entity.";
+    return complete;
+}
+
+// Writes the binary format; returns false if the stream failed.
+bool SimulationCheckpoint::writeBinary(std::ostream &out) const
+{
+    out.write(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+    writeUint32(out, CHECKPOINT_VERSION);
+    writeInt32(out, gridHeight);
+    writeInt32(out, gridWidth);
+    writeUint64(out, nextEntityId);
+    writeUint64(out, entityIdStride);
+    writeInt32(out, totalMonths);
+    writeInt32(out, monthsRun);
+    writeInt32(out, monthIndexInYear);
+    writeUint8(out, static_cast<std::uint8_t>(season));
+    writeUint8(out, northernHemisphere ? 1 : 0);
+    writeUint8(out, carnivoresStarvedPreviousMonth ? 1 : 0);
+    writeUint32(out, static_cast<std::uint32_t>(endReason.size()));
+    out.write(endReason.data(), endReason.size());
+    writeUint32(out, static_cast<std::uint32_t>(generatorState.size()));
+    for (std::uint32_t word : generatorState)
+        writeUint32(out, word);
+    writeAnimalParams(out, herbivoreParams);
+    writeAnimalParams(out, carnivoreParams);
+    writePlantParams(out, plantParams);
+    writeUint64(out, entities.size());
+    for (const CheckpointEntity &entity : entities)
+        writeEntity(out, entity);
+    return history.writeBinary(out);
+}
+
+// Replaces this checkpoint with one read in the binary format; on failure error explains why.
+bool SimulationCheckpoint::readBinary(std::istream &in, std::string &error)
+{
+    char magic[sizeof(CHECKPOINT_MAGIC)];
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, CHECKPOINT_MAGIC, sizeof(magic)) != 0)
+    {
+        error = "Not a simulation checkpoint.";
+        return false;
+    }
+    SimulationCheckpoint loaded;
+    std::uint32_t version = 0, reasonBytes = 0, generatorWords = 0;
+    std::uint8_t season = 0, northern = 0, starved = 0;
+    if (!readUint32(in, version) || !readInt32(in, loaded.gridHeight) || !readInt32(in, loaded.gridWidth) ||
+        !readUint64(in, loaded.nextEntityId) || !readUint64(in, loaded.entityIdStride) ||
+        !readInt32(in, loaded.totalMonths) || !readInt32(in, loaded.monthsRun) || !readInt32(in, loaded.monthIndexInYear) ||
+        !readUint8(in, season) || !readUint8(in, northern) || !readUint8(in, starved) || !readUint32(in, reasonBytes))
+    {
+        error = "Truncated checkpoint header.";
+        return false;
+    }
+    if (version != CHECKPOINT_VERSION)
+    {
+        error = "Unsupported checkpoint version " + std::to_string(version) + ".";
+        return false;
+    }
+    if (loaded.gridHeight < 1 || loaded.gridWidth < 1 || loaded.gridHeight > INT_MAX / loaded.gridWidth ||
+        loaded.totalMonths < 0 || loaded.totalMonths > MAX_SIMULATION_YEARS * 12 || loaded.monthsRun < 0 ||
+        loaded.monthIndexInYear < 0 || loaded.monthIndexInYear > 11 || season > static_cast<std::uint8_t>(Season::NONE) ||
+        reasonBytes > MAX_END_REASON_BYTES)
+    {
+        error = "Checkpoint header is out of range.";
+        return false;
+    }
+    loaded.season = static_cast<Season>(season);
+    loaded.northernHemisphere = northern != 0;
+    loaded.carnivoresStarvedPreviousMonth = starved != 0;
+
+    loaded.endReason.resize(reasonBytes);
+    if (!in.read(&loaded.endReason[0], reasonBytes) || !readUint32(in, generatorWords))
+    {
+        error = "Truncated checkpoint header.";
+        return false;
+    }
+    if (generatorWords > MAX_GENERATOR_WORDS)
+    {
+        error = "Checkpoint generator state has " + std::to_string(generatorWords) + " words, more than any generator writes.";
+        return false;
+    }
+    loaded.generatorState.resize(generatorWords);
+    for (std::uint32_t &word : loaded.generatorState)
+        if (!readUint32(in, word))
+        {
+            error = "Truncated checkpoint generator state.";
+            return false;
+        }
+
+    unsigned long long entityCount = 0;
+    if (!readAnimalParams(in, loaded.herbivoreParams) || !readAnimalParams(in, loaded.carnivoreParams) ||
+        !readPlantParams(in, loaded.plantParams) || !readUint64(in, entityCount))
+    {
+        error = "Truncated checkpoint parameters.";
+        return false;
+    }
+    if (entityCount > 2ULL * loaded.gridHeight * loaded.gridWidth)
+    {
+        error = "Checkpoint claims " + std::to_string(entityCount) + " entities, more than its grid can hold.";
+        return false;
+    }
+    loaded.entities.resize(entityCount);
+    for (CheckpointEntity &entity : loaded.entities)
+        if (!readEntity(in, entity, error))
+            return false;
+    if (!loaded.history.readBinary(in, error))
+    {
+        error = "Checkpoint statistics: " + error;
+        return false;
+    }
+    *this = std::move(loaded);
+    return true;
+}
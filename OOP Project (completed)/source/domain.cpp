@@ -0,0 +1,546 @@
+// domain.cpp
+#include "../headers/domain.hpp"
+#include "../headers/grid.hpp"
+#include "../headers/monthlyStats.hpp"
+#include "../headers/statsShard.hpp"
+#include "../headers/simulation.hpp"
+#include "../headers/plants.hpp"
+#include "../headers/herbivore.hpp"
+#include "../headers/carnivore.hpp"
+#include "../headers/utils.hpp"
+
+#include <iostream>
+#include <algorithm>
+#include <unordered_set>
+#include <unordered_map>
+#include <array>
+#include <cstring>
+#include <cstdlib> // For std::abs
+#include <cstdint>
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace
+{
+    // Writes the whole buffer, retrying short writes.
+    bool writeAll(int fd, const void *data, size_t size)
+    {
+        const char *bytes = static_cast<const char *>(data);
+        while (size > 0)
+        {
+            ssize_t written = ::write(fd, bytes, size);
+            if (written < 0 && errno == EINTR)
+                continue;
+            if (written <= 0)
+                return false;
+            bytes += written;
+            size -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+
+    // Reads exactly size bytes, retrying short reads.
+    bool readAll(int fd, void *data, size_t size)
+    {
+        char *bytes = static_cast<char *>(data);
+        while (size > 0)
+        {
+            ssize_t got = ::read(fd, bytes, size);
+            if (got < 0 && errno == EINTR)
+                continue;
+            if (got <= 0)
+                return false;
+            bytes += got;
+            size -= static_cast<size_t>(got);
+        }
+        return true;
+    }
+
+    // Sends a length-prefixed message.
+    bool sendMessage(int fd, const std::vector<char> &payload)
+    {
+        std::uint64_t size = payload.size();
+        return writeAll(fd, &size, sizeof(size)) && writeAll(fd, payload.data(), payload.size());
+    }
+
+    // Receives a length-prefixed message.
+    bool receiveMessage(int fd, std::vector<char> &payload)
+    {
+        std::uint64_t size = 0;
+        if (!readAll(fd, &size, sizeof(size)))
+            return false;
+        payload.resize(size);
+        return readAll(fd, payload.data(), payload.size());
+    }
+
+    // Appends a counted array of trivially copyable items to a message.
+    template <typename T>
+    void appendItems(std::vector<char> &message, const std::vector<T> &items)
+    {
+        std::uint32_t count = static_cast<std::uint32_t>(items.size());
+        const char *countBytes = reinterpret_cast<const char *>(&count);
+        message.insert(message.end(), countBytes, countBytes + sizeof(count));
+        const char *itemBytes = reinterpret_cast<const char *>(items.data());
+        message.insert(message.end(), itemBytes, itemBytes + items.size() * sizeof(T));
+    }
+
+    // Reads a counted array written by appendItems; returns false on a truncated message.
+    template <typename T>
+    bool readItems(const std::vector<char> &message, size_t &offset, std::vector<T> &items)
+    {
+        std::uint32_t count = 0;
+        if (offset + sizeof(count) > message.size())
+            return false;
+        std::memcpy(&count, message.data() + offset, sizeof(count));
+        offset += sizeof(count);
+        if (offset + static_cast<size_t>(count) * sizeof(T) > message.size())
+            return false;
+        items.resize(count);
+        std::memcpy(items.data(), message.data() + offset, static_cast<size_t>(count) * sizeof(T));
+        offset += static_cast<size_t>(count) * sizeof(T);
+        return true;
+    }
+
+    // Everything a subdomain sends one neighbour before a phase, once claims are settled.
+    struct NeighbourMessage
+    {
+        std::vector<EntityRecord> emigrants;
+        std::vector<EntityRecord> boundary;
+    };
+
+    // Serializes a neighbour message.
+    std::vector<char> packMessage(const NeighbourMessage &message)
+    {
+        std::vector<char> bytes;
+        appendItems(bytes, message.emigrants);
+        appendItems(bytes, message.boundary);
+        return bytes;
+    }
+
+    // Deserializes a neighbour message.
+    bool unpackMessage(const std::vector<char> &bytes, NeighbourMessage &message)
+    {
+        size_t offset = 0;
+        return readItems(bytes, offset, message.emigrants) && readItems(bytes, offset, message.boundary);
+    }
+
+    // Serializes a list of entity ids (claims, or the claims granted).
+    std::vector<char> packIds(const std::vector<unsigned long long> &ids)
+    {
+        std::vector<char> bytes;
+        appendItems(bytes, ids);
+        return bytes;
+    }
+
+    // Deserializes a list of entity ids.
+    bool unpackIds(const std::vector<char> &bytes, std::vector<unsigned long long> &ids)
+    {
+        size_t offset = 0;
+        return readItems(bytes, offset, ids);
+    }
+
+    // Records the living entities of some rows (they become ghosts in the neighbour's halo).
+    void recordRows(const Grid &grid, int firstRow, int lastRow, std::vector<EntityRecord> &records)
+    {
+        for (int r_coord = firstRow; r_coord < lastRow; ++r_coord)
+            for (int c_coord = 0; c_coord < grid.getWidth(); ++c_coord)
+            {
+                std::shared_ptr<Entity> entity = grid.getEntity(r_coord, c_coord);
+                if (entity && entity->isAlive())
+                    records.push_back(makeEntityRecord(*entity));
+            }
+    }
+
+    // A subdomain cannot go on without its neighbours; the coordinator notices the closed socket.
+    [[noreturn]] void abandonSubdomain(int rank, const char *what)
+    {
+        std::cerr << "Subdomain " << rank << ": " << what << " failed; stopping.\n";
+        _exit(1);
+    }
+
+    // Splits a world-wide count over the stripes in proportion to their rows.
+    int shareOf(int total, int rowBegin, int rowEnd, int gridHeight)
+    {
+        long long upTo = static_cast<long long>(total) * rowEnd / gridHeight;
+        long long before = static_cast<long long>(total) * rowBegin / gridHeight;
+        return static_cast<int>(upTo - before);
+    }
+}
+
+// SubdomainExchange constructor.
+SubdomainExchange::SubdomainExchange(int rank, int rankCount, int upperFd, int lowerFd, int controlFd, int haloRows)
+    : rank(rank), rankCount(rankCount), upperFd(upperFd), lowerFd(lowerFd), controlFd(controlFd),
+      haloRows(haloRows), handedOff(0), refusedClaims(0) {}
+
+// Sends outgoing to a neighbour and receives its message, in the order agreed for the pair.
+void SubdomainExchange::swapWith(int fd, bool sendFirst, const std::vector<char> &outgoing, std::vector<char> &incoming)
+{
+    bool ok = sendFirst ? sendMessage(fd, outgoing) && receiveMessage(fd, incoming)
+                        : receiveMessage(fd, incoming) && sendMessage(fd, outgoing);
+    if (!ok)
+        abandonSubdomain(rank, "halo exchange");
+}
+
+// Sends one message to each neighbour and receives theirs.
+void SubdomainExchange::swapWithNeighbours(const std::vector<char> &toUpper, const std::vector<char> &toLower,
+                                           std::vector<char> &fromUpper, std::vector<char> &fromLower)
+{
+    // Pairs (0,1), (2,3), ... talk first, then pairs (1,2), (3,4), ...; within a pair the lower rank sends first.
+    for (int step = 0; step < 2; ++step)
+    {
+        bool talkDown = (rank % 2 == step);
+        if (talkDown && lowerFd >= 0)
+            swapWith(lowerFd, true, toLower, fromLower);
+        else if (!talkDown && upperFd >= 0)
+            swapWith(upperFd, false, toUpper, fromUpper);
+    }
+}
+
+// Removes the owned entities a neighbour claimed that are still alive; returns the ids removed.
+std::vector<unsigned long long> SubdomainExchange::grantClaims(Grid &grid, const std::vector<unsigned long long> &claims)
+{
+    std::vector<unsigned long long> granted;
+    if (claims.empty())
+        return granted;
+    std::unordered_set<unsigned long long> claimed(claims.begin(), claims.end());
+    std::vector<std::shared_ptr<Entity>> victims;
+    for (const auto &p : grid.getPlants())
+        if (p->isAlive() && claimed.count(p->getId())) victims.push_back(p);
+    for (const auto &h : grid.getHerbivores())
+        if (h->isAlive() && claimed.count(h->getId())) victims.push_back(h);
+    for (const auto &c : grid.getCarnivores())
+        if (c->isAlive() && claimed.count(c->getId())) victims.push_back(c);
+
+    StatsShard unused; // The eater's subdomain counts the death when it credits the meal
+    for (const auto &victim : victims)
+    {
+        granted.push_back(victim->getId());
+        grid.removeEntity(victim, unused);
+    }
+    return granted;
+}
+
+// Claims the ghosts eaten here, grants the neighbours' claims and credits the granted meals.
+void SubdomainExchange::settleClaims(Grid &grid, StatsShard &stats)
+{
+    std::vector<GhostClaim> claims = grid.takeGhostClaims();
+    std::vector<unsigned long long> toUpper, toLower;
+    for (const auto &claim : claims)
+        (claim.ghost->getR() < grid.getOwnedRowBegin() ? toUpper : toLower).push_back(claim.ghost->getId());
+
+    std::vector<char> fromUpper, fromLower;
+    swapWithNeighbours(packIds(toUpper), packIds(toLower), fromUpper, fromLower);
+    std::vector<unsigned long long> upperClaims, lowerClaims;
+    if ((upperFd >= 0 && !unpackIds(fromUpper, upperClaims)) || (lowerFd >= 0 && !unpackIds(fromLower, lowerClaims)))
+        abandonSubdomain(rank, "reading a neighbour's claims");
+
+    // An entity claimed by both neighbours (only possible in a stripe shorter than two halos) goes to the upper one.
+    std::vector<unsigned long long> grantedUpper = grantClaims(grid, upperClaims);
+    std::vector<unsigned long long> grantedLower = grantClaims(grid, lowerClaims);
+    swapWithNeighbours(packIds(grantedUpper), packIds(grantedLower), fromUpper, fromLower);
+    std::vector<unsigned long long> granted, grantedByLower;
+    if ((upperFd >= 0 && !unpackIds(fromUpper, granted)) || (lowerFd >= 0 && !unpackIds(fromLower, grantedByLower)))
+        abandonSubdomain(rank, "reading a neighbour's granted claims");
+    if (claims.empty())
+        return;
+
+    granted.insert(granted.end(), grantedByLower.begin(), grantedByLower.end());
+    std::unordered_set<unsigned long long> grantedIds(granted.begin(), granted.end());
+    for (const auto &claim : claims)
+    {
+        if (grantedIds.count(claim.ghost->getId()))
+            claim.eater->eatPrey(*claim.ghost, stats);
+        else
+            refusedClaims++;
+    }
+}
+
+// Lists an entity handed off by a neighbour in the nearest free owned cell.
+bool SubdomainExchange::landArrival(Grid &grid, const EntityRecord &record)
+{
+    std::shared_ptr<Entity> entity = rebuildEntity(record);
+    if (!entity)
+        return true; // Nothing that could ever land
+    for (int radius = 0; radius <= haloRows; ++radius)
+        for (int dr = -radius; dr <= radius; ++dr)
+            for (int dc = -radius; dc <= radius; ++dc)
+            {
+                if (std::abs(dr) != radius && std::abs(dc) != radius)
+                    continue;
+                int r_coord = record.r + dr, c_coord = record.c + dc;
+                if (!grid.isValid(r_coord, c_coord) || !grid.isOwnedRow(r_coord) || !grid.isEmpty(r_coord, c_coord))
+                    continue;
+                entity->setR(r_coord);
+                entity->setC(c_coord);
+                return grid.addEntity(entity); // Only fails when every owned cell is listed
+            }
+    return false;
+}
+
+// Lists entities handed off by a neighbour, holding those that cannot land yet.
+void SubdomainExchange::adoptEmigrants(Grid &grid, const std::vector<EntityRecord> &arrivals)
+{
+    for (const auto &record : arrivals)
+        if (!landArrival(grid, record))
+            heldArrivals.push_back(record);
+}
+
+// Settles last phase's claims, hands off entities that crossed into the halo and refreshes the halo.
+void SubdomainExchange::beforePhase(Grid &grid, StatsShard &stats)
+{
+    // Claims first: an entity granted to a neighbour must neither emigrate nor be sent back as a ghost.
+    settleClaims(grid, stats);
+
+    NeighbourMessage toUpper, toLower;
+    for (const auto &emigrant : grid.takeEmigrants())
+    {
+        (emigrant->getR() < grid.getOwnedRowBegin() ? toUpper : toLower).emigrants.push_back(makeEntityRecord(*emigrant));
+        handedOff++;
+    }
+    if (upperFd >= 0)
+        recordRows(grid, grid.getOwnedRowBegin(), std::min(grid.getOwnedRowBegin() + haloRows, grid.getOwnedRowEnd()), toUpper.boundary);
+    if (lowerFd >= 0)
+        recordRows(grid, std::max(grid.getOwnedRowEnd() - haloRows, grid.getOwnedRowBegin()), grid.getOwnedRowEnd(), toLower.boundary);
+
+    std::vector<char> fromUpper, fromLower;
+    swapWithNeighbours(packMessage(toUpper), packMessage(toLower), fromUpper, fromLower);
+    NeighbourMessage upper, lower;
+    if ((upperFd >= 0 && !unpackMessage(fromUpper, upper)) || (lowerFd >= 0 && !unpackMessage(fromLower, lower)))
+        abandonSubdomain(rank, "reading a neighbour message");
+
+    grid.clearHalo();
+    std::vector<EntityRecord> waiting;
+    waiting.swap(heldArrivals);
+    adoptEmigrants(grid, waiting); // Oldest first
+    adoptEmigrants(grid, upper.emigrants);
+    adoptEmigrants(grid, lower.emigrants);
+    for (const NeighbourMessage *message : {&upper, &lower})
+        for (const auto &record : message->boundary)
+            grid.placeGhost(rebuildEntity(record));
+}
+
+// Checks whether this subdomain handles migration in the given month.
+bool SubdomainExchange::runsMigration(int month) const { return (month - 1) % rankCount == rank; }
+
+// Reports the month's statistics and waits for the coordinator's decision.
+bool SubdomainExchange::finishMonth(const MonthlyStats &stats, std::string &endReason)
+{
+    DomainMonthReport report;
+    report.plants = stats.getCurrentPlants();
+    report.herbivores = stats.getCurrentHerbivores();
+    report.carnivores = stats.getCurrentCarnivores();
+    report.plantsEaten = stats.getPlantsEaten();
+    report.herbivoresEaten = stats.getHerbivoresEaten();
+    report.herbivoresSpawned = stats.getHerbivoresSpawned();
+    report.carnivoresSpawned = stats.getCarnivoresSpawned();
+    report.handedOff = handedOff;
+    report.heldHandoffs = static_cast<int>(heldArrivals.size());
+    report.refusedClaims = refusedClaims;
+    for (const auto &record : heldArrivals)
+    {
+        if (record.type == EntityType::PLANT) report.plants++;
+        else if (record.type == EntityType::HERBIVORE) report.herbivores++;
+        else if (record.type == EntityType::CARNIVORE) report.carnivores++;
+    }
+    handedOff = 0;
+    refusedClaims = 0;
+
+    DomainDecision decision;
+    if (!writeAll(controlFd, &report, sizeof(report)) || !readAll(controlFd, &decision, sizeof(decision)))
+        abandonSubdomain(rank, "reporting to the coordinator");
+    if (!decision.keepRunning)
+        endReason = decision.endReason;
+    return decision.keepRunning != 0;
+}
+
+// DomainDecomposition constructor.
+DomainDecomposition::DomainDecomposition(int processCount) : processCount(std::max(1, processCount)) {}
+
+// Halo depth: the widest neighbourhood read is a summer meal search at vision + 2.
+int DomainDecomposition::haloRowsFor(const SimulationConfig &config)
+{
+    return std::max(config.herbivoreParams.visionRange, config.carnivoreParams.visionRange) + 2;
+}
+
+// Gets the rows [first, second) owned by a rank.
+std::pair<int, int> DomainDecomposition::stripeRows(int rank, int gridHeight) const
+{
+    return {gridHeight * rank / processCount, gridHeight * (rank + 1) / processCount};
+}
+
+// Checks that every stripe is at least twice as tall as the halo and that no option writes one file per run.
+bool DomainDecomposition::validate(const SimulationConfig &config, std::string &error) const
+{
+    if (!config.validate(error) || !config.validateForManyRuns("domain stripes", error))
+        return false;
+    if (config.synchronousUpdate)
+    {
+        // Ghosts arrive between phases, after the month's frozen copy was taken.
+        error = "Synchronous updates are not supported with domain decomposition.";
+        return false;
+    }
+    int halo = haloRowsFor(config);
+    // Two halos deep, no row is a ghost in both neighbours, so no entity can be claimed twice.
+    if (processCount > 1 && config.gridHeight / processCount < 2 * halo)
+    {
+        error = "Each of the " + std::to_string(processCount) + " stripes needs at least " + std::to_string(2 * halo) +
+                " rows (twice the halo depth); use a taller grid or fewer processes.";
+        return false;
+    }
+    return true;
+}
+
+// Forks the subdomains, coordinates them month by month and prints world totals to out.
+DomainRunResult DomainDecomposition::run(const SimulationConfig &config, std::ostream &out)
+{
+    DomainRunResult result;
+    if (!validate(config, result.error))
+        return result;
+    const int halo = haloRowsFor(config);
+
+    // neighbourFds[i] joins rank i (end 0) with rank i + 1 (end 1); controlFds[i] joins the coordinator (end 0) with rank i.
+    std::vector<std::array<int, 2>> neighbourFds(processCount - 1), controlFds(processCount);
+    for (auto &pair : neighbourFds)
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair.data()) != 0)
+        {
+            result.error = "Could not create a neighbour socket pair.";
+            return result;
+        }
+    for (auto &pair : controlFds)
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair.data()) != 0)
+        {
+            result.error = "Could not create a control socket pair.";
+            return result;
+        }
+
+    out.flush(); // Children inherit unflushed output otherwise
+    std::vector<pid_t> children;
+    for (int rank = 0; rank < processCount; ++rank)
+    {
+        pid_t pid = fork();
+        if (pid < 0)
+        {
+            result.error = "fork() failed.";
+            break;
+        }
+        if (pid > 0)
+        {
+            children.push_back(pid);
+            continue;
+        }
+
+        // Subdomain process: keep only its own sockets.
+        int upperFd = rank > 0 ? neighbourFds[rank - 1][1] : -1;
+        int lowerFd = rank < processCount - 1 ? neighbourFds[rank][0] : -1;
+        int controlFd = controlFds[rank][1];
+        for (int i = 0; i < processCount - 1; ++i)
+        {
+            if (neighbourFds[i][0] != lowerFd) close(neighbourFds[i][0]);
+            if (neighbourFds[i][1] != upperFd) close(neighbourFds[i][1]);
+        }
+        for (int i = 0; i < processCount; ++i)
+        {
+            close(controlFds[i][0]);
+            if (i != rank) close(controlFds[i][1]);
+        }
+
+        std::pair<int, int> rows = stripeRows(rank, config.gridHeight);
+        SimulationConfig stripe = config;
+        stripe.seed = deriveSeed(config.seed, static_cast<unsigned long long>(rank));
+        stripe.initialPlants = shareOf(config.initialPlants, rows.first, rows.second, config.gridHeight);
+        stripe.initialHerbivores = shareOf(config.initialHerbivores, rows.first, rows.second, config.gridHeight);
+        stripe.initialCarnivores = shareOf(config.initialCarnivores, rows.first, rows.second, config.gridHeight);
+
+        Grid grid(config.gridHeight, config.gridWidth, rows.first, rows.second, halo);
+        grid.setEntityIdSequence(static_cast<unsigned long long>(rank) + 1, static_cast<unsigned long long>(processCount));
+        SubdomainExchange exchange(rank, processCount, upperFd, lowerFd, controlFd, halo);
+        Simulation simulation(stripe, std::move(grid));
+        simulation.setOutput(nullptr);
+        simulation.setDomainExchange(&exchange);
+        simulation.runToCompletion();
+        _exit(0);
+    }
+
+    for (auto &pair : neighbourFds)
+    {
+        close(pair[0]);
+        close(pair[1]);
+    }
+    for (auto &pair : controlFds)
+        close(pair[1]);
+
+    const int totalMonths = config.years * 12;
+    if (children.size() == static_cast<size_t>(processCount))
+    {
+        for (int month = 1; month <= totalMonths; ++month)
+        {
+            DomainMonthReport world;
+            bool allReported = true;
+            for (int rank = 0; rank < processCount; ++rank)
+            {
+                DomainMonthReport part;
+                if (!readAll(controlFds[rank][0], &part, sizeof(part)))
+                {
+                    allReported = false;
+                    break;
+                }
+                world.plants += part.plants;
+                world.herbivores += part.herbivores;
+                world.carnivores += part.carnivores;
+                world.plantsEaten += part.plantsEaten;
+                world.herbivoresEaten += part.herbivoresEaten;
+                world.herbivoresSpawned += part.herbivoresSpawned;
+                world.carnivoresSpawned += part.carnivoresSpawned;
+                world.handedOff += part.handedOff;
+                world.heldHandoffs += part.heldHandoffs;
+                world.refusedClaims += part.refusedClaims;
+            }
+            if (!allReported)
+            {
+                result.error = "A subdomain process stopped unexpectedly in month " + std::to_string(month) + ".";
+                break;
+            }
+            result.months.push_back(world);
+            result.monthsRun = month;
+            out << "Month " << month << ": Plants " << world.plants << ", Herbivores " << world.herbivores
+                << ", Carnivores " << world.carnivores << " | Handed off " << world.handedOff
+                << ", waiting " << world.heldHandoffs << ", refused claims " << world.refusedClaims << "\n";
+
+            // Same end conditions as a single-process Simulation, applied to the world totals.
+            std::string reason;
+            bool animalsLeft = world.herbivores > 0 || world.carnivores > 0;
+            if (month > 1)
+            {
+                if (!animalsLeft) reason = "All animals have died.";
+                else if (world.plants == 0) reason = "All plants have died. Remaining animals will likely starve.";
+                else if (world.herbivores == 0) reason = "All herbivores have died. Carnivores will starve.";
+            }
+            DomainDecision decision{};
+            decision.keepRunning = reason.empty() ? 1 : 0;
+            std::strncpy(decision.endReason, reason.c_str(), sizeof(decision.endReason) - 1);
+            for (int rank = 0; rank < processCount; ++rank)
+                writeAll(controlFds[rank][0], &decision, sizeof(decision));
+            if (!reason.empty())
+            {
+                result.endReason = reason;
+                break;
+            }
+        }
+    }
+
+    for (auto &pair : controlFds)
+        close(pair[0]);
+    bool childrenSucceeded = true;
+    for (pid_t child : children)
+    {
+        int status = 0;
+        if (waitpid(child, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+            childrenSucceeded = false;
+    }
+    if (result.error.empty() && !childrenSucceeded)
+        result.error = "A subdomain process exited with an error.";
+    result.succeeded = result.error.empty();
+    return result;
+}
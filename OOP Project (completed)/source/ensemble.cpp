@@ -0,0 +1,166 @@
+// ensemble.cpp
+#include "../headers/ensemble.hpp"
+#include "../headers/simulation.hpp"
+#include "../headers/threadPool.hpp"
+#include "../headers/utils.hpp" // For deriveSeed, ScopedRandomGenerator
+
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+
+// EnsembleRunner constructor.
+EnsembleRunner::EnsembleRunner(const SimulationConfig &scenario_val, int memberCount_val, int threadCount_val)
+    : scenario(scenario_val), memberCount(std::max(0, memberCount_val)), threadCount(std::max(1, threadCount_val)) {}
+
+// Writes each member's full output to <directory>/member_<i>.log instead of discarding it.
+void EnsembleRunner::setMemberLogDirectory(const std::string &directory) { memberLogDirectory = directory; }
+// Writes each member's month-by-month statistics to <directory>/member_<i>.stats.
+void EnsembleRunner::setMemberHistoryDirectory(const std::string &directory) { memberHistoryDirectory = directory; }
+
+// Gets the seed used for a member of an ensemble.
+unsigned int EnsembleRunner::memberSeed(unsigned int baseSeed, int memberIndex)
+{
+    return deriveSeed(baseSeed, static_cast<unsigned long long>(memberIndex));
+}
+
+// Runs one simulation to completion and records its monthly populations.
+MemberTrajectory EnsembleRunner::runMember(const SimulationConfig &config, std::ostream *output, const std::string &historyPath)
+{
+    // Bind a member generator first so nothing here touches the shared global one.
+    std::mt19937 memberRng(config.seed);
+    ScopedRandomGenerator bindRng(memberRng);
+
+    MemberTrajectory trajectory;
+    Simulation sim(config);
+    sim.setOutput(output);
+    trajectory.monthlyPopulations.reserve(config.years * 12);
+    while (sim.hasMonthsRemaining())
+    {
+        sim.runMonth();
+        const MonthlyStats &stats = sim.getStats();
+        trajectory.monthlyPopulations.push_back({stats.getCurrentPlants(), stats.getCurrentHerbivores(), stats.getCurrentCarnivores()});
+    }
+    trajectory.endReason = sim.getEndReason();
+    if (!historyPath.empty())
+    {
+        std::ofstream historyFile(historyPath, std::ios::binary);
+        if (!sim.getHistory().writeBinary(historyFile) || !historyFile.flush())
+            trajectory.writeError = "Could not write " + historyPath + ".";
+    }
+    return trajectory;
+}
+
+// Checks the scenario, including that no option writes one file all members would share.
+bool EnsembleRunner::validate(std::string &error) const
+{
+    return scenario.validate(error) && scenario.validateForManyRuns("ensemble members", error);
+}
+
+// Runs all members and aggregates their monthly populations.
+EnsembleResult EnsembleRunner::run() const
+{
+    EnsembleResult result;
+    result.members = memberCount;
+    std::vector<MemberTrajectory> trajectories(memberCount);
+
+    auto runStart = std::chrono::steady_clock::now();
+    ThreadPool pool(threadCount);
+    pool.parallelFor(trajectories.size(), [&](size_t member) {
+        SimulationConfig memberConfig = scenario;
+        memberConfig.seed = memberSeed(scenario.seed, static_cast<int>(member));
+        memberConfig.workerThreads = 1; // Parallelism comes from running members side by side.
+        // A single pinned worker would go to the first allowed CPU in every member, stacking them all on one core.
+        memberConfig.pinThreads = false;
+        memberConfig.numaPlacement = false;
+        std::string historyPath;
+        if (!memberHistoryDirectory.empty())
+            historyPath = memberHistoryDirectory + "/member_" + std::to_string(member) + ".stats";
+        if (memberLogDirectory.empty())
+        {
+            trajectories[member] = runMember(memberConfig, nullptr, historyPath);
+            return;
+        }
+        const std::string logPath = memberLogDirectory + "/member_" + std::to_string(member) + ".log";
+        std::ofstream memberLog(logPath);
+        trajectories[member] = runMember(memberConfig, memberLog ? &memberLog : nullptr, historyPath);
+        if (!memberLog.flush() && trajectories[member].writeError.empty())
+            trajectories[member].writeError = "Could not write " + logPath + ".";
+    });
+    result.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - runStart).count();
+    result.runsPerSecond = result.wallSeconds > 0.0 ? memberCount / result.wallSeconds : 0.0;
+
+    for (const auto &trajectory : trajectories)
+    {
+        if (!trajectory.endReason.empty())
+            result.membersEndedEarly++;
+        if (!trajectory.writeError.empty() && result.membersNotWritten++ == 0)
+            result.firstWriteError = trajectory.writeError;
+    }
+    result.months = aggregate(trajectories);
+    return result;
+}
+
+// Aggregates member trajectories month by month; a member that ended early
+// no longer counts towards the months after its last one.
+std::vector<EnsembleMonthSummary> EnsembleRunner::aggregate(const std::vector<MemberTrajectory> &trajectories)
+{
+    size_t monthCount = 0;
+    for (const auto &trajectory : trajectories)
+        monthCount = std::max(monthCount, trajectory.monthlyPopulations.size());
+
+    std::vector<EnsembleMonthSummary> months;
+    for (size_t month = 0; month < monthCount; ++month)
+    {
+        EnsembleMonthSummary summary;
+        summary.month = static_cast<int>(month) + 1;
+        summary.membersRunning = 0;
+        PopulationAggregate *aggregates[3] = {&summary.plants, &summary.herbivores, &summary.carnivores};
+        double sums[3] = {0.0, 0.0, 0.0}, squares[3] = {0.0, 0.0, 0.0};
+        for (const auto &trajectory : trajectories)
+        {
+            if (month >= trajectory.monthlyPopulations.size())
+                continue;
+            const auto &populations = trajectory.monthlyPopulations[month];
+            for (int k = 0; k < 3; ++k)
+            {
+                if (summary.membersRunning == 0 || populations[k] < aggregates[k]->min) aggregates[k]->min = populations[k];
+                if (summary.membersRunning == 0 || populations[k] > aggregates[k]->max) aggregates[k]->max = populations[k];
+                sums[k] += populations[k];
+                squares[k] += static_cast<double>(populations[k]) * populations[k];
+            }
+            summary.membersRunning++;
+        }
+        for (int k = 0; k < 3; ++k)
+        {
+            aggregates[k]->mean = sums[k] / summary.membersRunning;
+            double variance = squares[k] / summary.membersRunning - aggregates[k]->mean * aggregates[k]->mean;
+            aggregates[k]->stdDev = std::sqrt(std::max(0.0, variance));
+        }
+        months.push_back(summary);
+    }
+    return months;
+}
+
+// Prints the per-month table and the throughput summary.
+void EnsembleRunner::report(const EnsembleResult &result, std::ostream &out)
+{
+    out << "\n--- Ensemble Populations (mean +- std dev [min, max]) ---\n";
+    out << std::left << std::setw(7) << "Month" << std::setw(9) << "Members"
+        << std::setw(28) << "Plants" << std::setw(28) << "Herbivores" << "Carnivores\n";
+    auto cell = [](const PopulationAggregate &a) {
+        std::ostringstream text;
+        text << std::fixed << std::setprecision(1) << a.mean << " +- " << a.stdDev << " [" << a.min << ", " << a.max << "]";
+        return text.str();
+    };
+    for (const auto &month : result.months)
+        out << std::left << std::setw(7) << month.month << std::setw(9) << month.membersRunning
+            << std::setw(28) << cell(month.plants) << std::setw(28) << cell(month.herbivores) << cell(month.carnivores) << "\n";
+    out << std::right;
+    out << "\nMembers: " << result.members << " (" << result.membersEndedEarly << " ended early)\n";
+    out << "Wall time: " << std::fixed << std::setprecision(3) << result.wallSeconds << " s\n";
+    out << "Throughput: " << std::setprecision(2) << result.runsPerSecond << " runs/s\n" << std::defaultfloat;
+}
@@ -1,10 +1,10 @@
 // entity.cpp
 #include "../headers/entity.hpp"
-// No other includes needed here as Grid and MonthlyStats are forward declared for pointer/reference use in header.
+// No other includes needed here as Grid and StatsShard are forward declared for pointer/reference use in header.
 
 // Entity constructor.
 Entity::Entity(int r_val, int c_val, EntityType type_val, char symbol_val)
-    : r_coord(r_val), c_coord(c_val), entityType(type_val), displaySymbol(symbol_val), is_alive(true) {}
+    : r_coord(r_val), c_coord(c_val), entityType(type_val), displaySymbol(symbol_val), is_alive(true), entityId(0) {}
 
 // Getters
 // Gets the row coordinate of the entity.
@@ -17,6 +17,8 @@ EntityType Entity::getType() const { return entityType; }
 char Entity::getSymbol() const { return displaySymbol; }
 // Checks if the entity is alive.
 bool Entity::isAlive() const { return is_alive; }
+// Gets the grid-assigned identifier of the entity (0 if never placed).
+unsigned long long Entity::getId() const { return entityId; }
 
 // Setters/Modifiers
 // Sets the row coordinate of the entity.
@@ -25,6 +27,8 @@ void Entity::setR(int r_val) { r_coord = r_val; }
 void Entity::setC(int c_val) { c_coord = c_val; }
 // Marks the entity as not alive.
 void Entity::kill() { is_alive = false; }
+// Sets the identifier of the entity.
+void Entity::setId(unsigned long long id_val) { entityId = id_val; }
 
 // Gets the gender of the entity (default for non-animals).
 Gender Entity::getGender() const { return Gender::NONE; }
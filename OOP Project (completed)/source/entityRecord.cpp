@@ -0,0 +1,54 @@
+// entityRecord.cpp
+#include "../headers/entityRecord.hpp"
+#include "../headers/plants.hpp"
+#include "../headers/herbivore.hpp"
+#include "../headers/carnivore.hpp"
+
+// Captures the full state of an entity.
+EntityRecord makeEntityRecord(const Entity &entity)
+{
+    EntityRecord record{};
+    record.id = entity.getId();
+    record.r = entity.getR();
+    record.c = entity.getC();
+    record.type = entity.getType();
+    record.gender = entity.getGender();
+    if (entity.getType() == EntityType::PLANT)
+    {
+        const Plant &plant = static_cast<const Plant &>(entity);
+        record.plantParams = plant.getParams();
+        record.plantAge = plant.getCurrentAgePlant();
+    }
+    else
+    {
+        const Animal &animal = static_cast<const Animal &>(entity);
+        record.animalParams = animal.getParams();
+        record.animalState = animal.getState();
+    }
+    return record;
+}
+
+// Rebuilds a living entity from a record.
+std::shared_ptr<Entity> rebuildEntity(const EntityRecord &record)
+{
+    std::shared_ptr<Entity> entity;
+    if (record.type == EntityType::PLANT)
+    {
+        auto plant = std::make_shared<Plant>(record.r, record.c, record.plantParams);
+        plant->setCurrentAgePlant(record.plantAge);
+        entity = plant;
+    }
+    else if (record.type == EntityType::HERBIVORE || record.type == EntityType::CARNIVORE)
+    {
+        std::shared_ptr<Animal> animal;
+        if (record.type == EntityType::HERBIVORE)
+            animal = std::make_shared<Herbivore>(record.r, record.c, record.gender, record.animalParams);
+        else
+            animal = std::make_shared<Carnivore>(record.r, record.c, record.gender, record.animalParams);
+        animal->setState(record.animalState);
+        entity = animal;
+    }
+    if (entity)
+        entity->setId(record.id);
+    return entity;
+}
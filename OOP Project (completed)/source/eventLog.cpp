@@ -0,0 +1,65 @@
+// eventLog.cpp
+#include "../headers/eventLog.hpp"
+
+// Gets the name a species is reported under.
+static const char *speciesName(EntityType species)
+{
+    switch (species)
+    {
+    case EntityType::PLANT: return "Plant";
+    case EntityType::HERBIVORE: return "Herbivore";
+    case EntityType::CARNIVORE: return "Carnivore";
+    default: return "Entity";
+    }
+}
+
+// Formats a position as "(r,c)".
+static std::string position(int r_coord, int c_coord)
+{
+    return "(" + std::to_string(r_coord) + "," + std::to_string(c_coord) + ")";
+}
+
+// Builds the display text of an event.
+std::string formatEvent(const EventRecord &event)
+{
+    const std::string subject = speciesName(event.species);
+    switch (event.kind)
+    {
+    case EventKind::ATE:
+        return subject + " at " + position(event.r, event.c) + " ate " +
+               (event.species == EntityType::CARNIVORE ? "herbivore" : "plant") + " at " + position(event.otherR, event.otherC);
+    case EventKind::MATED:
+        return subject + " at " + position(event.r, event.c) + " mated.";
+    case EventKind::BORN:
+        return subject + " born at " + position(event.r, event.c);
+    case EventKind::IMMIGRATED:
+        return subject + " immigrated to " + position(event.r, event.c) + ".";
+    case EventKind::EMIGRATED:
+        return subject + " at " + position(event.r, event.c) + " emigrated.";
+    }
+    return subject + " event at " + position(event.r, event.c);
+}
+
+// Parses "all", "none" or a comma-separated list of feeding, births, mating and migration.
+bool parseEventMask(const std::string &text, unsigned int &mask)
+{
+    if (text == "all") { mask = EVENTS_ALL; return true; }
+    if (text == "none") { mask = EVENTS_NONE; return true; }
+    unsigned int parsed = EVENTS_NONE;
+    size_t start = 0;
+    while (true)
+    {
+        size_t comma = text.find(',', start);
+        std::string name = text.substr(start, comma == std::string::npos ? std::string::npos : comma - start);
+        if (name == "feeding") parsed |= EVENTS_FEEDING;
+        else if (name == "births") parsed |= EVENTS_BIRTHS;
+        else if (name == "mating") parsed |= EVENTS_MATING;
+        else if (name == "migration") parsed |= EVENTS_MIGRATION;
+        else return false;
+        if (comma == std::string::npos)
+            break;
+        start = comma + 1;
+    }
+    mask = parsed;
+    return true;
+}
@@ -6,28 +6,76 @@
 #include "../headers/carnivore.hpp"
 #include "../headers/animal.hpp"
 #include "../headers/utils.hpp"
-#include "../headers/monthlyStats.hpp"
+#include "../headers/statsShard.hpp"
+#include "../headers/traceRecorder.hpp"
+
+#include <cstring> // For std::memcpy
 
 // Grid constructor.
-Grid::Grid() : cells_grid(GRID_HEIGHT, std::vector<std::shared_ptr<Entity>>(GRID_WIDTH, nullptr)) {}
+Grid::Grid(int height_val, int width_val) : Grid(height_val, width_val, 0, height_val, 0) {}
+
+// Subdomain constructor: owns rows [rowBegin, rowEnd) and also stores haloRows rows on either side.
+Grid::Grid(int height_val, int width_val, int rowBegin, int rowEnd, int haloRows)
+    : gridHeight(height_val), gridWidth(width_val), ownedRowBegin(rowBegin), ownedRowEnd(rowEnd),
+      storedRowBegin(std::max(0, rowBegin - haloRows)), storedRowEnd(std::min(height_val, rowEnd + haloRows)),
+      cells_grid(static_cast<size_t>(storedRowEnd - storedRowBegin) * width_val, nullptr), synchronousReads(false),
+      nextEntityId(1), entityIdStride(1) {}
+
+// Gets the number of rows in the grid.
+int Grid::getHeight() const { return gridHeight; }
+// Gets the number of columns in the grid.
+int Grid::getWidth() const { return gridWidth; }
+// Gets the maximum number of entities the grid can hold (one per cell).
+int Grid::getMaxPopulation() const { return gridHeight * gridWidth; }
+// Gets the first row owned by this grid.
+int Grid::getOwnedRowBegin() const { return ownedRowBegin; }
+// Gets one past the last row owned by this grid.
+int Grid::getOwnedRowEnd() const { return ownedRowEnd; }
+// Gets the first row stored by this grid, including the halo.
+int Grid::getStoredRowBegin() const { return storedRowBegin; }
+// Gets one past the last stored row, including the halo.
+int Grid::getStoredRowEnd() const { return storedRowEnd; }
+// Gets the number of cells in the owned rows.
+int Grid::getOwnedCellCount() const { return (ownedRowEnd - ownedRowBegin) * gridWidth; }
+// Checks if a row is owned (updated) by this grid rather than being halo.
+bool Grid::isOwnedRow(int r_coord) const { return r_coord >= ownedRowBegin && r_coord < ownedRowEnd; }
+// Gets the bytes reserved for the cells (and their synchronous-month copy).
+size_t Grid::getCellStorageBytes() const
+{
+    return (cells_grid.capacity() + frozen_cells.capacity()) * sizeof(std::shared_ptr<Entity>);
+}
+// Gets the bytes reserved by the plant, herbivore and carnivore lists.
+size_t Grid::getListStorageBytes() const
+{
+    return plants_list.capacity() * sizeof(std::shared_ptr<Plant>) + herbivores_list.capacity() * sizeof(std::shared_ptr<Herbivore>) +
+           carnivores_list.capacity() * sizeof(std::shared_ptr<Carnivore>);
+}
+// Gets the first cell of a stored row, for placing the row's memory.
+const std::shared_ptr<Entity> *Grid::storedRow(int r_coord) const { return &cells_grid[cellIndex(r_coord, 0)]; }
 
 // Checks if given coordinates are within grid boundaries.
 bool Grid::isValid(int r_coord, int c_coord) const
 {
-    return r_coord >= 0 && r_coord < GRID_HEIGHT && c_coord >= 0 && c_coord < GRID_WIDTH;
+    return r_coord >= 0 && r_coord < gridHeight && c_coord >= 0 && c_coord < gridWidth;
 }
 
 // Checks if a cell at given coordinates is empty.
 bool Grid::isEmpty(int r_coord, int c_coord) const
 {
-    return isValid(r_coord, c_coord) && cells_grid[r_coord][c_coord] == nullptr;
+    return isStored(r_coord, c_coord) && readCells()[cellIndex(r_coord, c_coord)] == nullptr;
+}
+
+// Checks if a cell is empty both for reads and in the live cells.
+bool Grid::isFreeForWrite(int r_coord, int c_coord) const
+{
+    return isEmpty(r_coord, c_coord) && cells_grid[cellIndex(r_coord, c_coord)] == nullptr;
 }
 
 // Retrieves the entity at given coordinates.
 std::shared_ptr<Entity> Grid::getEntity(int r_coord, int c_coord) const
 {
-    if (isValid(r_coord, c_coord))
-        return cells_grid[r_coord][c_coord];
+    if (isStored(r_coord, c_coord))
+        return readCells()[cellIndex(r_coord, c_coord)];
     return nullptr;
 }
 
@@ -36,13 +84,18 @@ bool Grid::addEntity(const std::shared_ptr<Entity> &entity)
 {
     if (!entity)
         return false;
-    // Check against MAX_POPULATION using the sum of current list sizes
-    if (plants_list.size() + herbivores_list.size() + carnivores_list.size() >= (size_t)MAX_POPULATION) 
+    // Check against the grid's capacity using the sum of current list sizes
+    if (plants_list.size() + herbivores_list.size() + carnivores_list.size() >= (size_t)getOwnedCellCount()) 
         return false; 
     
-    if (isValid(entity->getR(), entity->getC()) && isEmpty(entity->getR(), entity->getC()))
+    if (isValid(entity->getR(), entity->getC()) && isFreeForWrite(entity->getR(), entity->getC()))
     {
-        cells_grid[entity->getR()][entity->getC()] = entity;
+        cells_grid[cellIndex(entity->getR(), entity->getC())] = entity;
+        if (entity->getId() == 0)
+        {
+            entity->setId(nextEntityId);
+            nextEntityId += entityIdStride;
+        }
         if (entity->getType() == EntityType::PLANT)
             plants_list.push_back(std::static_pointer_cast<Plant>(entity));
         else if (entity->getType() == EntityType::HERBIVORE)
@@ -57,13 +110,13 @@ bool Grid::addEntity(const std::shared_ptr<Entity> &entity)
 // Adds a migrating animal to a random empty cell.
 bool Grid::addMigratingAnimal(const std::shared_ptr<Animal> &animal_ptr)
 {
-    if (plants_list.size() + herbivores_list.size() + carnivores_list.size() >= (size_t)MAX_POPULATION)
+    if (plants_list.size() + herbivores_list.size() + carnivores_list.size() >= (size_t)getOwnedCellCount())
         return false;
-    for (int attempts = 0; attempts < GRID_WIDTH * GRID_HEIGHT; ++attempts)
+    for (int attempts = 0; attempts < getOwnedCellCount(); ++attempts)
     {
-        int r_coord = getRandomInt(0, GRID_HEIGHT - 1);
-        int c_coord = getRandomInt(0, GRID_WIDTH - 1);
-        if (isEmpty(r_coord, c_coord))
+        int r_coord = getRandomInt(ownedRowBegin, ownedRowEnd - 1);
+        int c_coord = getRandomInt(0, gridWidth - 1);
+        if (isFreeForWrite(r_coord, c_coord))
         {
             animal_ptr->setR(r_coord); // Use setter
             animal_ptr->setC(c_coord); // Use setter
@@ -74,15 +127,20 @@ bool Grid::addMigratingAnimal(const std::shared_ptr<Animal> &animal_ptr)
 }
 
 // Removes an entity from the grid and lists.
-void Grid::removeEntity(const std::shared_ptr<Entity> &entity_ptr, MonthlyStats &stats)
+void Grid::removeEntity(const std::shared_ptr<Entity> &entity_ptr, StatsShard &stats)
 {
-    if (!entity_ptr || !isValid(entity_ptr->getR(), entity_ptr->getC()))
+    if (!entity_ptr || !isStored(entity_ptr->getR(), entity_ptr->getC()))
         return;
+    ECOSIM_TRACE_SCOPE("removeEntity", "entities", "id", static_cast<long long>(entity_ptr->getId()));
     
-    if (cells_grid[entity_ptr->getR()][entity_ptr->getC()] == entity_ptr)
-        cells_grid[entity_ptr->getR()][entity_ptr->getC()] = nullptr;
+    if (cells_grid[cellIndex(entity_ptr->getR(), entity_ptr->getC())] == entity_ptr)
+        cells_grid[cellIndex(entity_ptr->getR(), entity_ptr->getC())] = nullptr;
     
     entity_ptr->kill(); 
+
+    // A ghost belongs to a neighbour, which keeps the real entity (eating one goes through claimGhost).
+    if (!ghostIds.empty() && ghostIds.erase(entity_ptr->getId()) > 0)
+        return;
     
     if (entity_ptr->getType() == EntityType::PLANT)
     {
@@ -108,54 +166,302 @@ void Grid::removeEntity(const std::shared_ptr<Entity> &entity_ptr, MonthlyStats
 }
 
 // Moves an entity from its current position to new coordinates.
-void Grid::moveEntity(const std::shared_ptr<Entity> &entity_ptr, int newR, int newC)
+bool Grid::moveEntity(const std::shared_ptr<Entity> &entity_ptr, int newR, int newC)
 {
     if (!entity_ptr)
-        return;
-    if (isValid(entity_ptr->getR(), entity_ptr->getC()) && cells_grid[entity_ptr->getR()][entity_ptr->getC()] == entity_ptr)
+        return false;
+    if (synchronousReads && isStored(newR, newC))
     {
-        cells_grid[entity_ptr->getR()][entity_ptr->getC()] = nullptr;
+        // Plants may still be trampled as before, but two animals never end up in one live cell.
+        const std::shared_ptr<Entity> &claimed = cells_grid[cellIndex(newR, newC)];
+        if (claimed && claimed != entity_ptr && claimed->isAlive() && claimed->getType() != EntityType::PLANT)
+            return false;
+    }
+    if (isStored(entity_ptr->getR(), entity_ptr->getC()) && cells_grid[cellIndex(entity_ptr->getR(), entity_ptr->getC())] == entity_ptr)
+    {
+        cells_grid[cellIndex(entity_ptr->getR(), entity_ptr->getC())] = nullptr;
     }
     entity_ptr->setR(newR); // Use setter
     entity_ptr->setC(newC); // Use setter
     
-    if (isValid(newR, newC))
-        cells_grid[newR][newC] = entity_ptr;
+    if (isStored(newR, newC))
+        cells_grid[cellIndex(newR, newC)] = entity_ptr;
     else
         entity_ptr->kill();
+    return true;
 }
 
-// Displays the current state of the grid.
-void Grid::display() const
-{
-    std::cout << std::setw(5) << " "; 
-    for (int j = 0; j < GRID_WIDTH; ++j)
-        std::cout << std::setw(2) << std::left << j;
-    std::cout << std::endl;
-    std::cout << std::setw(5) << " ";
-    for (int j = 0; j < GRID_WIDTH; ++j)
-        std::cout << "--";
-    std::cout << std::endl;
-
-    for (int i = 0; i < GRID_HEIGHT; ++i)
+// Places an entity in its empty cell without listing it (used by parallel phases).
+bool Grid::placeInCell(const std::shared_ptr<Entity> &entity)
+{
+    if (!entity || !isFreeForWrite(entity->getR(), entity->getC()))
+        return false;
+    cells_grid[cellIndex(entity->getR(), entity->getC())] = entity;
+    return true;
+}
+
+// Lists plants that were already placed with placeInCell.
+void Grid::adoptPlacedPlants(const std::vector<std::shared_ptr<Plant>> &placed)
+{
+    for (const auto &plant : placed)
+        if (plant->getId() == 0)
+        {
+            plant->setId(nextEntityId);
+            nextEntityId += entityIdStride;
+        }
+    plants_list.insert(plants_list.end(), placed.begin(), placed.end());
+}
+
+// Puts back an entity read from a checkpoint with its id.
+bool Grid::restoreEntity(const std::shared_ptr<Entity> &entity, bool listed, bool inCell)
+{
+    if (!entity || !isStored(entity->getR(), entity->getC()) || (inCell && !isFreeForWrite(entity->getR(), entity->getC())))
+        return false;
+    if (inCell)
+        cells_grid[cellIndex(entity->getR(), entity->getC())] = entity;
+    if (!listed)
+        return true;
+    if (entity->getType() == EntityType::PLANT)
+        plants_list.push_back(std::static_pointer_cast<Plant>(entity));
+    else if (entity->getType() == EntityType::HERBIVORE)
+        herbivores_list.push_back(std::static_pointer_cast<Herbivore>(entity));
+    else if (entity->getType() == EntityType::CARNIVORE)
+        carnivores_list.push_back(std::static_pointer_cast<Carnivore>(entity));
+    return true;
+}
+
+// Starts a synchronous month: reads see a frozen copy of the current cells, writes go to the live cells.
+void Grid::beginSynchronousMonth()
+{
+    if (frozen_cells.size() != cells_grid.size())
+        frozen_cells = cells_grid; // First synchronous month
+    else
+        syncFrozenCells(); // Cells changed between the months (migration, cleanup)
+    synchronousReads = true;
+}
+
+// Ends a synchronous month: reads see the live cells again.
+void Grid::endSynchronousMonth()
+{
+    synchronousReads = false;
+    syncFrozenCells(); // Lets go of the entities removed this month now rather than next month
+}
+
+// Copies the live cells that differ from the frozen copy into it. Unchanged cells cost a
+// comparison, not a reference count increment and decrement.
+void Grid::syncFrozenCells()
+{
+    for (size_t i = 0; i < cells_grid.size(); ++i)
+        if (frozen_cells[i] != cells_grid[i])
+            frozen_cells[i] = cells_grid[i];
+}
+
+// Checks whether reads currently come from the frozen copy.
+bool Grid::isSynchronous() const { return synchronousReads; }
+
+// Makes newly listed entities take ids first, first + stride, first + 2 * stride, ...
+void Grid::setEntityIdSequence(unsigned long long first, unsigned long long stride)
+{
+    nextEntityId = first;
+    entityIdStride = std::max(1ULL, stride);
+}
+
+// Gets the id the next newly listed entity takes.
+unsigned long long Grid::getNextEntityId() const { return nextEntityId; }
+// Gets the step between identifiers.
+unsigned long long Grid::getEntityIdStride() const { return entityIdStride; }
+
+// Places a read-only copy of a neighbour's entity in a halo cell.
+bool Grid::placeGhost(const std::shared_ptr<Entity> &ghost)
+{
+    if (!ghost || isOwnedRow(ghost->getR()) || !isEmpty(ghost->getR(), ghost->getC()))
+        return false;
+    cells_grid[cellIndex(ghost->getR(), ghost->getC())] = ghost;
+    ghostIds.insert(ghost->getId());
+    return true;
+}
+
+// Unlists and returns the living entities of this grid that moved or were born into halo rows.
+std::vector<std::shared_ptr<Entity>> Grid::takeEmigrants()
+{
+    std::vector<std::shared_ptr<Entity>> emigrants;
+    for (int r_coord = storedRowBegin; r_coord < storedRowEnd; ++r_coord)
     {
-        std::cout << std::setw(2) << std::right << i << " | ";
-        for (int j = 0; j < GRID_WIDTH; ++j)
+        if (isOwnedRow(r_coord))
+            continue;
+        for (int c_coord = 0; c_coord < gridWidth; ++c_coord)
         {
-            char displaySymbolToPrint = '*'; 
-            if (cells_grid[i][j])
+            std::shared_ptr<Entity> &cell = cells_grid[cellIndex(r_coord, c_coord)];
+            if (cell && cell->isAlive() && ghostIds.count(cell->getId()) == 0)
             {
-                // Use getters to access entity properties
-                if (cells_grid[i][j]->getType() == EntityType::PLANT)
-                    displaySymbolToPrint = cells_grid[i][j]->getSymbol(); // Or just 'P'
-                else if (cells_grid[i][j]->getType() == EntityType::HERBIVORE)
-                    displaySymbolToPrint = cells_grid[i][j]->getSymbol(); // Symbol is set based on gender in constructor
-                else if (cells_grid[i][j]->getType() == EntityType::CARNIVORE)
-                    displaySymbolToPrint = cells_grid[i][j]->getSymbol();
+                emigrants.push_back(cell);
+                cell->kill(); // The neighbour rebuilds it; this copy must not be updated again
+                cell = nullptr;
             }
-            std::cout << displaySymbolToPrint << " ";
         }
-        std::cout << std::endl;
+    }
+    if (emigrants.empty())
+        return emigrants;
+
+    // Entities that died this phase stay listed for the month-end cleanup, so only emigrants are unlisted.
+    std::unordered_set<const Entity *> leaving;
+    for (const auto &e : emigrants)
+        leaving.insert(e.get());
+    auto isLeaving = [&](const auto &e) { return leaving.count(e.get()) > 0; };
+    plants_list.erase(std::remove_if(plants_list.begin(), plants_list.end(), isLeaving), plants_list.end());
+    herbivores_list.erase(std::remove_if(herbivores_list.begin(), herbivores_list.end(), isLeaving), herbivores_list.end());
+    carnivores_list.erase(std::remove_if(carnivores_list.begin(), carnivores_list.end(), isLeaving), carnivores_list.end());
+    return emigrants;
+}
+
+// Empties every halo cell and forgets all ghosts.
+void Grid::clearHalo()
+{
+    for (int r_coord = storedRowBegin; r_coord < storedRowEnd; ++r_coord)
+    {
+        if (isOwnedRow(r_coord))
+            continue;
+        std::fill(cells_grid.begin() + cellIndex(r_coord, 0), cells_grid.begin() + cellIndex(r_coord, 0) + gridWidth, nullptr);
+    }
+    ghostIds.clear();
+}
+
+// Checks whether an entity is a halo copy of a neighbour's entity.
+bool Grid::isGhost(const Entity &entity) const { return !ghostIds.empty() && ghostIds.count(entity.getId()) > 0; }
+
+// Takes a ghost off its halo cell and queues the claim for its owner.
+void Grid::claimGhost(const std::shared_ptr<Entity> &ghost, Animal &eater)
+{
+    if (!ghost || !isStored(ghost->getR(), ghost->getC()) || ghostIds.erase(ghost->getId()) == 0)
+        return;
+    if (cells_grid[cellIndex(ghost->getR(), ghost->getC())] == ghost)
+        cells_grid[cellIndex(ghost->getR(), ghost->getC())] = nullptr;
+    ghostClaims.push_back({ghost, &eater});
+}
+
+// Returns the ghosts claimed since the last call.
+std::vector<GhostClaim> Grid::takeGhostClaims()
+{
+    std::vector<GhostClaim> taken;
+    taken.swap(ghostClaims);
+    return taken;
+}
+
+// Displays the current state of the grid.
+void Grid::display(std::ostream &out) const
+{
+    thread_local std::vector<char> symbols; // Reused by every frame this thread prints
+    symbolSnapshot(symbols);
+    displaySymbols(out, symbols, ownedRowBegin, gridWidth);
+}
+
+// Copies the display symbol of every owned cell, row-major ('*' for empty cells).
+std::vector<char> Grid::symbolSnapshot() const
+{
+    std::vector<char> symbols;
+    symbolSnapshot(symbols);
+    return symbols;
+}
+
+// Copies the display symbol of every owned cell into symbols, reusing its storage.
+void Grid::symbolSnapshot(std::vector<char> &symbols) const
+{
+    symbols.resize(static_cast<size_t>(getOwnedCellCount()));
+    char *next = symbols.data();
+    for (int i = ownedRowBegin; i < ownedRowEnd; ++i)
+    {
+        const std::shared_ptr<Entity> *cell = &cells_grid[cellIndex(i, 0)];
+        // Plants show 'P', animals their gender-specific symbol set in the constructor
+        for (int j = 0; j < gridWidth; ++j)
+            *next++ = cell[j] ? cell[j]->getSymbol() : '*';
+    }
+}
+
+// Prints symbols taken with symbolSnapshot in the same layout as display, as one write.
+void Grid::displaySymbols(std::ostream &out, const std::vector<char> &symbols, int firstRow, int width)
+{
+    thread_local std::string frame; // Reused by every frame this thread prints
+    renderSymbols(frame, symbols, firstRow, width);
+    out.write(frame.data(), static_cast<std::streamsize>(frame.size()));
+    out.flush(); // The rows used to end with std::endl; keep interactive output appearing per frame
+}
+
+// Gets the characters display takes for a row or column number (at least 2, like std::setw(2)).
+size_t Grid::getLabelWidth(int value)
+{
+    size_t digits = 1;
+    for (; value >= 10; value /= 10)
+        ++digits;
+    return std::max<size_t>(2, digits);
+}
+
+// Writes a label padded to two characters (on the right for column labels, on the left for
+// row labels) and returns the position after it.
+static char *putLabel(char *next, int value, bool padRight)
+{
+    static const char DIGIT_PAIRS[] = "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+                                      "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+                                      "8081828384858687888990919293949596979899";
+    char digits[12];
+    char *end = digits + sizeof(digits);
+    char *first = end;
+    while (value >= 100)
+    {
+        first -= 2;
+        std::memcpy(first, DIGIT_PAIRS + 2 * (value % 100), 2);
+        value /= 100;
+    }
+    if (value >= 10)
+    {
+        first -= 2;
+        std::memcpy(first, DIGIT_PAIRS + 2 * value, 2);
+    }
+    else
+        *--first = static_cast<char>('0' + value);
+    const size_t length = static_cast<size_t>(end - first);
+    if (length == 1 && !padRight)
+        *next++ = ' ';
+    std::memcpy(next, first, length);
+    next += length;
+    if (length == 1 && padRight)
+        *next++ = ' ';
+    return next;
+}
+
+// Lays symbols out as display prints them: a column number row, a rule, then each row's
+// number and its symbols. The frame is sized once and filled in place.
+void Grid::renderSymbols(std::string &frame, const std::vector<char> &symbols, int firstRow, int width)
+{
+    const int rows = width > 0 ? static_cast<int>(symbols.size()) / width : 0;
+    const size_t cellsWidth = 2 * static_cast<size_t>(std::max(0, width)); // Symbol and space per cell
+    size_t size = 5 + 1 + 5 + cellsWidth + 1;
+    for (int j = 0; j < width; ++j)
+        size += getLabelWidth(j);
+    for (int i = 0; i < rows; ++i)
+        size += getLabelWidth(firstRow + i) + 3 + cellsWidth + 1;
+    frame.resize(size);
+
+    char *next = &frame[0];
+    next = std::fill_n(next, 5, ' ');
+    for (int j = 0; j < width; ++j)
+        next = putLabel(next, j, true);
+    *next++ = '\n';
+    next = std::fill_n(next, 5, ' ');
+    next = std::fill_n(next, cellsWidth, '-');
+    *next++ = '\n';
+
+    const char *symbol = symbols.data();
+    for (int i = 0; i < rows; ++i)
+    {
+        next = putLabel(next, firstRow + i, false);
+        std::memcpy(next, " | ", 3);
+        next += 3;
+        for (int j = 0; j < width; ++j)
+        {
+            *next++ = *symbol++;
+            *next++ = ' ';
+        }
+        *next++ = '\n';
     }
 }
 
@@ -1,20 +1,21 @@
 // herbivore.cpp
 #include "../headers/herbivore.hpp"
 #include "../headers/grid.hpp"
-#include "../headers/monthlyStats.hpp"
+#include "../headers/statsShard.hpp"
 #include "../headers/plants.hpp" // For type checking when eating
 #include "../headers/utils.hpp" // For getRandomInt
 
 // Herbivore constructor.
-Herbivore::Herbivore(int r_coord, int c_coord, Gender gender_val)
+Herbivore::Herbivore(int r_coord, int c_coord, Gender gender_val, const AnimalParams &params)
     : Animal(r_coord, c_coord, EntityType::HERBIVORE, 'H', 'h', gender_val, 
-             70, 120, 5, 10, 3, 2, 40, 3, 1.0) {}
+             params.maxAge, params.maxEnergy, params.visionRange, params.moveCost, params.gestationPeriod,
+             params.minBreedingAge, params.energyToReproduce, params.maxTurnsWithoutFood, params.size) {}
 
 // Gets the species name ("Herbivore").
 std::string Herbivore::getSpeciesName() const { return "Herbivore"; }
 
 // Herbivore's attempt to eat.
-bool Herbivore::attemptEat(Grid &grid, MonthlyStats &stats, Season currentSeason)
+bool Herbivore::attemptEat(Grid &grid, StatsShard &stats, Season currentSeason)
 {
     if (!isAlive() || getCurrentEnergy() >= getMaximumEnergy() * 0.95)
         return false;
@@ -43,11 +44,13 @@ bool Herbivore::attemptEat(Grid &grid, MonthlyStats &stats, Season currentSeason
                         auto plantEntity = grid.getEntity(nr_eat, nc_eat);
                         if (plantEntity && plantEntity->getType() == EntityType::PLANT && plantEntity->isAlive())
                         {
-                            setCurrentEnergy(std::min(getMaximumEnergy(), getCurrentEnergy() + 35));
-                            plantEntity->kill();
-                            stats.incrementPlantsEaten();
-                            stats.addMonthlyEvent("Herbivore at (" + std::to_string(getR()) + "," + std::to_string(getC()) + ") ate plant at (" + std::to_string(nr_eat) + "," + std::to_string(nc_eat) + ")");
-                            grid.removeEntity(plantEntity, stats);
+                            if (grid.isGhost(*plantEntity))
+                                grid.claimGhost(plantEntity, *this); // Eaten once the owning subdomain grants it
+                            else
+                            {
+                                eatPrey(*plantEntity, stats);
+                                grid.removeEntity(plantEntity, stats);
+                            }
                             // mealsMissedTurns = 0; // This is managed in Animal::update based on eat success
                             return true;
                         }
@@ -59,18 +62,19 @@ bool Herbivore::attemptEat(Grid &grid, MonthlyStats &stats, Season currentSeason
     return false;
 }
 
-// Herbivore's movement logic.
-void Herbivore::move(Grid &grid, MonthlyStats &stats, Season currentSeason)
+// Herbivore's meal: gains energy, kills the plant and counts it.
+void Herbivore::eatPrey(Entity &prey, StatsShard &stats)
 {
-    if (!isAlive()) return;
-    
-    int energyBeforeMove = getCurrentEnergy();
-
-    if (energyBeforeMove <= 0) { // Check before deducting potential move cost by other means
-        if (isAlive()) die(stats);
-        return;
-    }
+    setCurrentEnergy(std::min(getMaximumEnergy(), getCurrentEnergy() + 35));
+    prey.kill();
+    stats.incrementPlantsEaten();
+    stats.recordCell(HeatmapLayer::PLANTS_EATEN, prey.getR(), prey.getC());
+    ECOSIM_RECORD_EVENT(stats, EventKind::ATE, EntityType::HERBIVORE, getR(), getC(), getId(), prey.getR(), prey.getC(), prey.getId());
+}
 
+// Herbivore's movement choice, computed without changing the grid.
+MoveIntent Herbivore::planMove(const Grid &grid, Season currentSeason) const
+{
     auto carnivoresNearby = grid.findNearbyEntities(getR(), getC(), EntityType::CARNIVORE, getSightRange() + (currentSeason == Season::SUMMER ? 1:0) - (currentSeason == Season::WINTER ? 1:0) );
     if (!carnivoresNearby.empty())
     {
@@ -101,11 +105,7 @@ void Herbivore::move(Grid &grid, MonthlyStats &stats, Season currentSeason)
                 }
             }
         if (bestR_flee != getR() || bestC_flee != getC())
-        {
-            grid.moveEntity(grid.getEntity(getR(), getC()), bestR_flee, bestC_flee);
-            setCurrentEnergy(getCurrentEnergy() - getMovementCostBase()); 
-            return;
-        }
+            return {bestR_flee, bestC_flee, true};
     }
 
     if (getCurrentEnergy() < getMaximumEnergy() * 0.9) 
@@ -132,11 +132,7 @@ void Herbivore::move(Grid &grid, MonthlyStats &stats, Season currentSeason)
                 if (grid.isValid(nr_move_plant, nc_move_plant) && 
                     (grid.isEmpty(nr_move_plant, nc_move_plant) || 
                      (grid.getEntity(nr_move_plant, nc_move_plant) && grid.getEntity(nr_move_plant, nc_move_plant)->getType() == EntityType::PLANT)))
-                {
-                    grid.moveEntity(grid.getEntity(getR(), getC()), nr_move_plant, nc_move_plant);
-                    setCurrentEnergy(getCurrentEnergy() - getMovementCostBase());
-                    return;
-                }
+                    return {nr_move_plant, nc_move_plant, true};
             }
         }
     }
@@ -145,15 +141,13 @@ void Herbivore::move(Grid &grid, MonthlyStats &stats, Season currentSeason)
     {
         int ch_rand = 0; 
         if (emptyC_rand.size() > 1) ch_rand = getRandomInt(0, emptyC_rand.size() - 1);
-        else if (emptyC_rand.empty()) return; // Should not be reachable due to !emptyC_rand.empty()
-
-        grid.moveEntity(grid.getEntity(getR(), getC()), emptyC_rand[ch_rand].first, emptyC_rand[ch_rand].second);
-        setCurrentEnergy(getCurrentEnergy() - getMovementCostBase());
+        return {emptyC_rand[ch_rand].first, emptyC_rand[ch_rand].second, true};
     }
+    return {getR(), getC(), false};
 }
 
 // Herbivore's attempt to reproduce.
-void Herbivore::attemptReproduce(Grid &grid, MonthlyStats &stats, const std::vector<std::shared_ptr<Animal>> &potentialMates, Season currentSeason)
+void Herbivore::attemptReproduce(Grid &grid, StatsShard &stats, const std::vector<std::shared_ptr<Animal>> &potentialMates, Season currentSeason)
 {
     if (!isAlive() || !canReproduceInternal()) return;
     double repMul = 1.0;
@@ -174,14 +168,14 @@ void Herbivore::attemptReproduce(Grid &grid, MonthlyStats &stats, const std::vec
             // currentGestationProgress is reset in Animal::update after birth
             setCurrentEnergy(getCurrentEnergy() - getEnergyRequiredToReproduce() / 2);
             if(mate->isAlive()) mate->setCurrentEnergy(mate->getCurrentEnergy() - mate->getEnergyRequiredToReproduce() / 4);
-            stats.addMonthlyEvent("Herbivore at (" + std::to_string(getR()) + "," + std::to_string(getC()) + ") mated.");
+            ECOSIM_RECORD_EVENT(stats, EventKind::MATED, EntityType::HERBIVORE, getR(), getC(), getId(), mate->getR(), mate->getC(), mate->getId());
             return;
         }
     }
 }
 
 // Herbivore's logic for giving birth.
-void Herbivore::giveBirth(Grid &grid, MonthlyStats &stats)
+void Herbivore::giveBirth(Grid &grid, StatsShard &stats)
 {
     if (!isAlive()) return; // Should be caught by Animal::update, but good to have
     std::vector<std::pair<int, int>> birthLocs = grid.getAdjacentEmptyCells(getR(), getC());
@@ -205,11 +199,13 @@ void Herbivore::giveBirth(Grid &grid, MonthlyStats &stats)
         auto pos_birth = birthLocs[idx_birth]; 
         birthLocs.erase(birthLocs.begin() + idx_birth);
         Gender g_birth = (getRandomInt(0, 1) == 0) ? Gender::MALE : Gender::FEMALE; 
-        auto newH_birth = std::make_shared<Herbivore>(pos_birth.first, pos_birth.second, g_birth); 
+        auto newH_birth = std::make_shared<Herbivore>(pos_birth.first, pos_birth.second, g_birth, getParams()); 
         if (grid.addEntity(newH_birth))
         {
             stats.incrementHerbivoresSpawned();
-            stats.addMonthlyEvent("Herbivore born at (" + std::to_string(pos_birth.first) + "," + std::to_string(pos_birth.second) + ")");
+            stats.recordAnimalState(*newH_birth);
+            stats.recordCell(HeatmapLayer::BIRTHS, pos_birth.first, pos_birth.second);
+            ECOSIM_RECORD_EVENT(stats, EventKind::BORN, EntityType::HERBIVORE, pos_birth.first, pos_birth.second, newH_birth->getId(), getR(), getC(), getId());
         }
     }
 }
\ No newline at end of file
@@ -0,0 +1,225 @@
+// memoryReport.cpp
+#include "../headers/memoryReport.hpp"
+#include "../headers/plants.hpp"
+#include "../headers/herbivore.hpp"
+#include "../headers/carnivore.hpp"
+
+#include <sys/resource.h>
+#include <atomic>
+#include <memory>
+#include <new>
+#include <cstdlib>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+
+#ifdef ECOSIM_COUNT_ALLOCATIONS
+// Counting replacements of the global allocation functions; the array forms forward to these.
+static std::atomic<unsigned long long> heapAllocations(0);
+static std::atomic<unsigned long long> heapBytes(0);
+
+// Allocates with malloc (or posix_memalign) after counting the request, like the default operator new.
+static void *countedAllocate(std::size_t size, std::size_t alignment)
+{
+    heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    heapBytes.fetch_add(size, std::memory_order_relaxed);
+    if (size == 0)
+        size = 1;
+    while (true)
+    {
+        void *memory = nullptr;
+        if (alignment <= alignof(std::max_align_t))
+            memory = std::malloc(size);
+        else if (posix_memalign(&memory, alignment, size) != 0)
+            memory = nullptr;
+        if (memory)
+            return memory;
+        std::new_handler handler = std::get_new_handler();
+        if (!handler)
+            throw std::bad_alloc();
+        handler();
+    }
+}
+
+void *operator new(std::size_t size) { return countedAllocate(size, 0); }
+void *operator new(std::size_t size, std::align_val_t alignment) { return countedAllocate(size, static_cast<std::size_t>(alignment)); }
+void operator delete(void *memory) noexcept { std::free(memory); }
+void operator delete(void *memory, std::size_t) noexcept { std::free(memory); }
+void operator delete(void *memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete(void *memory, std::size_t, std::align_val_t) noexcept { std::free(memory); }
+
+bool allocationCountingEnabled() { return true; }
+unsigned long long heapAllocationCount() { return heapAllocations.load(std::memory_order_relaxed); }
+unsigned long long heapAllocatedBytes() { return heapBytes.load(std::memory_order_relaxed); }
+#else
+bool allocationCountingEnabled() { return false; }
+unsigned long long heapAllocationCount() { return 0; }
+unsigned long long heapAllocatedBytes() { return 0; }
+#endif
+
+namespace
+{
+// Thrown by ProbeAllocator once it has seen the size of the allocation.
+struct AllocationProbed
+{
+};
+
+// Allocator that records the bytes std::allocate_shared asks for and then aborts the
+// allocation, so nothing is constructed (make_shared requests the same block).
+template <class T>
+struct ProbeAllocator
+{
+    using value_type = T;
+    size_t *bytes;
+
+    explicit ProbeAllocator(size_t *bytes_val) : bytes(bytes_val) {}
+    template <class U>
+    ProbeAllocator(const ProbeAllocator<U> &other) : bytes(other.bytes) {}
+
+    T *allocate(size_t n)
+    {
+        *bytes = n * sizeof(T);
+        throw AllocationProbed();
+    }
+    void deallocate(T *, size_t) {}
+    template <class U>
+    bool operator==(const ProbeAllocator<U> &other) const { return bytes == other.bytes; }
+    template <class U>
+    bool operator!=(const ProbeAllocator<U> &other) const { return bytes != other.bytes; }
+};
+
+// Gets the size of the block std::make_shared<T>(args...) allocates.
+template <class T, class... Args>
+size_t sharedAllocationBytes(const Args &...args)
+{
+    size_t bytes = 0;
+    try
+    {
+        std::allocate_shared<T>(ProbeAllocator<T>(&bytes), args...);
+    }
+    catch (const AllocationProbed &)
+    {
+    }
+    return bytes;
+}
+} // namespace
+
+// Gets the heap bytes one entity of a type takes when made with std::make_shared.
+size_t sharedEntityBytes(EntityType type)
+{
+    switch (type)
+    {
+    case EntityType::PLANT:
+        return sharedAllocationBytes<Plant>(0, 0, PLANT_DEFAULTS);
+    case EntityType::HERBIVORE:
+        return sharedAllocationBytes<Herbivore>(0, 0, Gender::MALE, HERBIVORE_DEFAULTS);
+    case EntityType::CARNIVORE:
+        return sharedAllocationBytes<Carnivore>(0, 0, Gender::MALE, CARNIVORE_DEFAULTS);
+    default:
+        return 0;
+    }
+}
+
+// Gets the peak resident set size of the process.
+size_t peakResidentBytes()
+{
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+    return static_cast<size_t>(usage.ru_maxrss) * 1024; // Linux reports kilobytes
+}
+
+// Gets the bytes of every live entity.
+size_t MemoryReport::getEntityBytes() const
+{
+    size_t bytes = 0;
+    for (const SpeciesMemory &entry : species)
+        bytes += entry.count * entry.bytesEach;
+    return bytes;
+}
+
+// Gets the bytes of every structure listed in the report.
+size_t MemoryReport::getTrackedBytes() const
+{
+    return getEntityBytes() + cellStorageBytes + listStorageBytes + eventStorageBytes + historyStorageBytes;
+}
+
+// Gets the bytes that do not grow with the grid (events and history).
+size_t MemoryReport::getFixedBytes() const { return eventStorageBytes + historyStorageBytes; }
+
+// Gets the bytes that grow with the grid (cells, entities and lists) per grid cell.
+double MemoryReport::getBytesPerCell() const
+{
+    return gridCells > 0 ? static_cast<double>(getTrackedBytes() - getFixedBytes()) / gridCells : 0.0;
+}
+
+// Gets the tracked bytes of a world of the given size at the same density.
+double MemoryReport::getProjectedBytes(long long cells) const
+{
+    return getBytesPerCell() * cells + getFixedBytes();
+}
+
+// Formats a byte count with a binary unit.
+static std::string formatBytes(double bytes)
+{
+    static const char *const units[] = {"B", "KB", "MB", "GB", "TB"};
+    size_t unit = 0;
+    while (bytes >= 1024.0 && unit < 4)
+    {
+        bytes /= 1024.0;
+        ++unit;
+    }
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(unit == 0 ? 0 : 1) << bytes << " " << units[unit];
+    return text.str();
+}
+
+// Prints the report, with a projection to a 10^8-cell world at the same density.
+void MemoryReport::print(std::ostream &out) const
+{
+    const long long projectedCells = 100000000;
+    out << "\n--- Memory Report ---\n";
+    for (const SpeciesMemory &entry : species)
+        out << std::left << std::setw(14) << entry.species << entry.count << " x " << entry.bytesEach << " B = "
+            << formatBytes(static_cast<double>(entry.count * entry.bytesEach)) << "\n";
+    out << std::setw(14) << "Grid cells" << gridCells << " cells, " << formatBytes(cellStorageBytes) << "\n";
+    out << std::setw(14) << "Entity lists" << formatBytes(listStorageBytes) << "\n";
+    out << std::setw(14) << "Events" << formatBytes(eventStorageBytes) << "\n";
+    out << std::setw(14) << "History" << formatBytes(historyStorageBytes) << "\n";
+    out << std::setw(14) << "Tracked" << formatBytes(getTrackedBytes()) << " (" << std::fixed << std::setprecision(1)
+        << getBytesPerCell() << " B per cell, " << formatBytes(getFixedBytes()) << " fixed)\n";
+    out << std::setw(14) << "Peak RSS" << formatBytes(peakRssBytes) << "\n";
+    out << "Projected for " << projectedCells << " cells at this density: "
+        << formatBytes(getProjectedBytes(projectedCells)) << " tracked\n";
+    if (!allocationsCounted)
+        out << "Heap allocations: not counted (build with -DECOSIM_COUNT_ALLOCATIONS)\n";
+    else if (!monthlyAllocations.empty())
+    {
+        unsigned long long total = 0;
+        for (unsigned long long count : monthlyAllocations)
+            total += count;
+        out << "Heap allocations per month: min " << *std::min_element(monthlyAllocations.begin(), monthlyAllocations.end())
+            << ", mean " << total / monthlyAllocations.size() << ", max "
+            << *std::max_element(monthlyAllocations.begin(), monthlyAllocations.end()) << "\n";
+    }
+    out << std::defaultfloat << std::right;
+}
+
+// Writes the report as one JSON object.
+void MemoryReport::writeJson(std::ostream &out) const
+{
+    out << "{\n  \"gridCells\": " << gridCells << ",\n  \"species\": [";
+    for (size_t i = 0; i < species.size(); ++i)
+        out << (i ? ", " : "") << "{\"name\": \"" << species[i].species << "\", \"count\": " << species[i].count
+            << ", \"bytesEach\": " << species[i].bytesEach << "}";
+    out << "],\n  \"entityBytes\": " << getEntityBytes() << ",\n  \"cellStorageBytes\": " << cellStorageBytes
+        << ",\n  \"listStorageBytes\": " << listStorageBytes << ",\n  \"eventStorageBytes\": " << eventStorageBytes
+        << ",\n  \"historyStorageBytes\": " << historyStorageBytes << ",\n  \"trackedBytes\": " << getTrackedBytes()
+        << ",\n  \"fixedBytes\": " << getFixedBytes() << ",\n  \"bytesPerCell\": " << std::fixed << std::setprecision(3) << getBytesPerCell() << std::defaultfloat
+        << ",\n  \"peakRssBytes\": " << peakRssBytes << ",\n  \"allocationsCounted\": " << (allocationsCounted ? "true" : "false")
+        << ",\n  \"monthlyAllocations\": [";
+    for (size_t i = 0; i < monthlyAllocations.size(); ++i)
+        out << (i ? ", " : "") << monthlyAllocations[i];
+    out << "]\n}\n";
+}
@@ -27,39 +27,63 @@ void MonthlyStats::reset()
     animalsImmigrated = 0;
     animalsEmigrated = 0;
     monthlyEvents.clear();
+    animalHistograms.clear();
 }
 
 // Displays all current monthly statistics.
-void MonthlyStats::display() const
+void MonthlyStats::display(std::ostream &out) const
 {
-    std::cout << "\n--- Monthly Statistics for " << currentMonthName << " (" << currentSeasonName << ") ---\n";
-    std::cout << "Plants Eaten by Herbivores: " << plantsEaten << "\n";
-    std::cout << "Plants Died (Old Age): " << plantsDiedNaturalAge << "\n";
-    std::cout << "Plants Died (Weather): " << plantsDiedWeather << "\n";
-    std::cout << "New Plants (Spread): " << plantsSpread << "\n\n";
-    std::cout << "Herbivores Eaten by Carnivores: " << herbivoresEaten << "\n";
-    std::cout << "Herbivores Died (Natural Causes/Starvation): " << herbivoresDiedNatural << "\n";
-    std::cout << "New Herbivores (Born): " << herbivoresSpawned << "\n\n";
-    std::cout << "Carnivores Died (Natural Causes/Starvation): " << carnivoresDiedNatural << "\n";
-    std::cout << "New Carnivores (Born): " << carnivoresSpawned << "\n\n";
-    std::cout << "Animals Immigrated: " << animalsImmigrated << "\n";
-    std::cout << "Animals Emigrated: " << animalsEmigrated << "\n\n";
-    std::cout << "Current Population:\n";
-    std::cout << "Plants: " << currentPlants << "\n";
-    std::cout << "Herbivores: " << currentHerbivores << "\n";
-    std::cout << "Carnivores: " << currentCarnivores << "\n\n";
-    std::cout << "Monthly Events:\n";
-    if (monthlyEvents.empty())
+    out << "\n--- Monthly Statistics for " << currentMonthName << " (" << currentSeasonName << ") ---\n";
+    out << "Plants Eaten by Herbivores: " << plantsEaten << "\n";
+    out << "Plants Died (Old Age): " << plantsDiedNaturalAge << "\n";
+    out << "Plants Died (Weather): " << plantsDiedWeather << "\n";
+    out << "New Plants (Spread): " << plantsSpread << "\n\n";
+    out << "Herbivores Eaten by Carnivores: " << herbivoresEaten << "\n";
+    out << "Herbivores Died (Natural Causes/Starvation): " << herbivoresDiedNatural << "\n";
+    out << "New Herbivores (Born): " << herbivoresSpawned << "\n\n";
+    out << "Carnivores Died (Natural Causes/Starvation): " << carnivoresDiedNatural << "\n";
+    out << "New Carnivores (Born): " << carnivoresSpawned << "\n\n";
+    out << "Animals Immigrated: " << animalsImmigrated << "\n";
+    out << "Animals Emigrated: " << animalsEmigrated << "\n\n";
+    out << "Current Population:\n";
+    out << "Plants: " << currentPlants << "\n";
+    out << "Herbivores: " << currentHerbivores << "\n";
+    out << "Carnivores: " << currentCarnivores << "\n\n";
+    out << "Monthly Events:\n";
+    if (monthlyEvents.empty() && monthlyEvents.getDroppedCount() == 0)
     {
-        std::cout << "No specific events this month.\n";
+        out << "No specific events this month.\n";
     }
     else
     {
         for (const auto &event : monthlyEvents)
         {
-            std::cout << "- " << event << "\n";
+            out << "- " << formatEvent(event) << "\n";
         }
     }
+    if (monthlyEvents.getDroppedCount() > 0)
+        out << "(" << monthlyEvents.getDroppedCount() << " more events not recorded: the event log holds "
+            << monthlyEvents.getCapacity() << " per month.)\n";
+}
+
+// Adds the counters and events gathered in a shard during the month.
+// Current population counts and month/season names are left untouched.
+void MonthlyStats::mergeShard(const StatsShard &shard)
+{
+    plantsEaten += shard.getPlantsEaten();
+    plantsDiedNaturalAge += shard.getPlantsDiedNaturalAge();
+    plantsDiedWeather += shard.getPlantsDiedWeather();
+    plantsSpread += shard.getPlantsSpread();
+    herbivoresEaten += shard.getHerbivoresEaten();
+    herbivoresDiedNatural += shard.getHerbivoresDiedNatural();
+    herbivoresSpawned += shard.getHerbivoresSpawned();
+    carnivoresEaten += shard.getCarnivoresEaten();
+    carnivoresDiedNatural += shard.getCarnivoresDiedNatural();
+    carnivoresSpawned += shard.getCarnivoresSpawned();
+    animalsImmigrated += shard.getAnimalsImmigrated();
+    animalsEmigrated += shard.getAnimalsEmigrated();
+    monthlyEvents.appendAll(shard.getMonthlyEvents());
+    animalHistograms.absorb(shard.getAnimalHistograms());
 }
 
 // Getters
@@ -80,24 +104,13 @@ int MonthlyStats::getAnimalsImmigrated() const { return animalsImmigrated; }
 int MonthlyStats::getAnimalsEmigrated() const { return animalsEmigrated; }
 std::string MonthlyStats::getCurrentMonthName() const { return currentMonthName; }
 std::string MonthlyStats::getCurrentSeasonName() const { return currentSeasonName; }
-const std::vector<std::string>& MonthlyStats::getMonthlyEvents() const { return monthlyEvents; }
+const EventLog& MonthlyStats::getMonthlyEvents() const { return monthlyEvents; }
+const AnimalHistograms& MonthlyStats::getAnimalHistograms() const { return animalHistograms; }
 
 // Setters / Modifiers
-void MonthlyStats::incrementPlantsEaten() { plantsEaten++; }
-void MonthlyStats::incrementPlantsDiedNaturalAge() { plantsDiedNaturalAge++; }
-void MonthlyStats::incrementPlantsDiedWeather() { plantsDiedWeather++; }
-void MonthlyStats::incrementPlantsSpread() { plantsSpread++; }
 void MonthlyStats::setCurrentPlants(int count) { currentPlants = count; }
-void MonthlyStats::incrementHerbivoresEaten() { herbivoresEaten++; }
-void MonthlyStats::incrementHerbivoresDiedNatural() { herbivoresDiedNatural++; }
-void MonthlyStats::incrementHerbivoresSpawned() { herbivoresSpawned++; }
 void MonthlyStats::setCurrentHerbivores(int count) { currentHerbivores = count; }
-void MonthlyStats::incrementCarnivoresEaten() { carnivoresEaten++; }
-void MonthlyStats::incrementCarnivoresDiedNatural() { carnivoresDiedNatural++; }
-void MonthlyStats::incrementCarnivoresSpawned() { carnivoresSpawned++; }
 void MonthlyStats::setCurrentCarnivores(int count) { currentCarnivores = count; }
-void MonthlyStats::incrementAnimalsImmigrated() { animalsImmigrated++; }
-void MonthlyStats::incrementAnimalsEmigrated() { animalsEmigrated++; }
+void MonthlyStats::setEventCapacity(size_t capacity) { monthlyEvents.setCapacity(capacity); }
 void MonthlyStats::setCurrentMonthName(const std::string& name) { currentMonthName = name; }
-void MonthlyStats::setCurrentSeasonName(const std::string& name) { currentSeasonName = name; }
-void MonthlyStats::addMonthlyEvent(const std::string& event) { monthlyEvents.push_back(event); }
\ No newline at end of file
+void MonthlyStats::setCurrentSeasonName(const std::string& name) { currentSeasonName = name; }
\ No newline at end of file
@@ -0,0 +1,86 @@
+// movePhase.cpp
+#include "../headers/movePhase.hpp"
+#include "../headers/grid.hpp"
+#include "../headers/statsShard.hpp"
+#include "../headers/threadPool.hpp"
+#include "../headers/utils.hpp" // For ScopedRandomGenerator, deriveSeed
+#include "../headers/traceRecorder.hpp"
+
+#include <algorithm> // For std::sort, std::max
+
+// IntentMovePhase constructor.
+IntentMovePhase::IntentMovePhase(int planChunkSize_val) : planChunkSize(std::max(1, planChunkSize_val)) {}
+
+// Gets the deterministic priority of an animal's move in the given month.
+unsigned int IntentMovePhase::movePriority(unsigned long long entityId, int month)
+{
+    return deriveSeed(entityId, static_cast<unsigned long long>(month));
+}
+
+// Runs the update of the given animals for one month.
+void IntentMovePhase::run(Grid &grid, StatsShard &stats, Season currentSeason, ThreadPool &pool,
+                          const std::vector<std::shared_ptr<Animal>> &animals, int month, unsigned int monthSeed) const
+{
+    // Phase 1: everything before moving still mutates the grid, so it stays in order.
+    std::vector<PlannedMove> moves;
+    moves.reserve(animals.size());
+    for (const auto &animal : animals)
+    {
+        if (!animal->isAlive())
+            continue;
+        if (!animal->updateBeforeMove(grid, stats, currentSeason))
+            continue;
+        if (animal->getCurrentEnergy() <= 0)
+        {
+            animal->die(stats);
+            continue;
+        }
+        moves.push_back({animal, {animal->getR(), animal->getC(), false}, movePriority(animal->getId(), month)});
+    }
+
+    // Phase 2: plan from the now read-only grid, one generator per fixed-size chunk.
+    const size_t chunkCount = (moves.size() + planChunkSize - 1) / planChunkSize;
+    pool.parallelFor(chunkCount, [&](size_t chunk) {
+        ECOSIM_TRACE_SCOPE("Plan chunk", "movement", "chunk", static_cast<long long>(chunk));
+        std::mt19937 chunkRng(deriveSeed(monthSeed, chunk));
+        ScopedRandomGenerator bindRng(chunkRng);
+        const size_t end = std::min(moves.size(), (chunk + 1) * planChunkSize);
+        for (size_t i = chunk * planChunkSize; i < end; ++i)
+            moves[i].intent = moves[i].animal->planMove(grid, currentSeason);
+    });
+
+    // Phase 3: resolve collisions and move.
+    ECOSIM_TRACE_SCOPE("Resolve moves", "movement", "moves", static_cast<long long>(moves.size()));
+    resolveAndApply(grid, moves);
+    for (const auto &move : moves)
+        if (move.animal->isAlive() && move.animal->getCurrentEnergy() <= 0) // Final check after all actions
+            move.animal->die(stats);
+}
+
+// Settles collisions so at most one animal enters each cell and applies the winning moves.
+void IntentMovePhase::resolveAndApply(Grid &grid, std::vector<PlannedMove> &moves)
+{
+    std::vector<PlannedMove *> contenders;
+    contenders.reserve(moves.size());
+    for (auto &move : moves)
+        if (move.intent.moves)
+            contenders.push_back(&move);
+
+    // Group by target cell; inside a group the highest priority (then lowest id) wins.
+    std::sort(contenders.begin(), contenders.end(), [](const PlannedMove *a, const PlannedMove *b) {
+        if (a->intent.targetR != b->intent.targetR) return a->intent.targetR < b->intent.targetR;
+        if (a->intent.targetC != b->intent.targetC) return a->intent.targetC < b->intent.targetC;
+        if (a->priority != b->priority) return a->priority > b->priority;
+        return a->animal->getId() < b->animal->getId();
+    });
+
+    for (size_t i = 0; i < contenders.size(); ++i)
+    {
+        bool wonCell = i == 0 || contenders[i]->intent.targetR != contenders[i - 1]->intent.targetR ||
+                       contenders[i]->intent.targetC != contenders[i - 1]->intent.targetC;
+        if (wonCell)
+            contenders[i]->animal->applyMove(grid, contenders[i]->intent);
+        else
+            contenders[i]->intent.moves = false;
+    }
+}
@@ -0,0 +1,234 @@
+// numaPlacement.cpp
+#include "../headers/numaPlacement.hpp"
+#include "../headers/grid.hpp"
+#include "../headers/entity.hpp"
+#include "../headers/plants.hpp"
+#include "../headers/herbivore.hpp"
+#include "../headers/carnivore.hpp"
+#include "../headers/threadPool.hpp"
+
+#include <sched.h>
+#include <pthread.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h> // For MPOL_MF_MOVE
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <map>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+
+// Finds the number in the first "node<N>" entry of a sysfs directory; returns -1 if there is none.
+static int firstNodeEntry(const std::string &directory, int *count = nullptr)
+{
+    DIR *dir = opendir(directory.c_str());
+    if (!dir)
+        return -1;
+    int first = -1;
+    while (dirent *entry = readdir(dir))
+    {
+        if (std::strncmp(entry->d_name, "node", 4) != 0 || entry->d_name[4] < '0' || entry->d_name[4] > '9')
+            continue;
+        if (first < 0)
+            first = std::atoi(entry->d_name + 4);
+        if (count)
+            (*count)++;
+    }
+    closedir(dir);
+    return first;
+}
+
+// Gets the number of NUMA nodes the kernel reports (1 if it reports none).
+int numaNodeCount()
+{
+    int count = 0;
+    firstNodeEntry("/sys/devices/system/node", &count);
+    return std::max(1, count);
+}
+
+// Gets the NUMA node a CPU belongs to (0 if unknown).
+int numaNodeOfCpu(int cpu)
+{
+    return std::max(0, firstNodeEntry("/sys/devices/system/cpu/cpu" + std::to_string(cpu)));
+}
+
+// Gets the CPUs the calling thread may run on, spread round-robin over the NUMA nodes,
+// so consecutive workers alternate between sockets and use the memory bandwidth of all of them.
+std::vector<int> allowedCpusByNode()
+{
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    std::map<int, std::vector<int>> cpusOfNode;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0)
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+            if (CPU_ISSET(cpu, &allowed))
+                cpusOfNode[numaNodeOfCpu(cpu)].push_back(cpu);
+
+    std::vector<int> result;
+    for (size_t round = 0; ; ++round)
+    {
+        bool any = false;
+        for (const auto &node : cpusOfNode)
+            if (round < node.second.size())
+            {
+                result.push_back(node.second[round]);
+                any = true;
+            }
+        if (!any)
+            break;
+    }
+    return result;
+}
+
+// Restricts the calling thread to the given CPUs; returns false if the kernel refused.
+bool pinCurrentThread(const std::vector<int> &cpus)
+{
+    cpu_set_t target;
+    CPU_ZERO(&target);
+    for (int cpu : cpus)
+        CPU_SET(cpu, &target);
+    return pthread_setaffinity_np(pthread_self(), sizeof(target), &target) == 0;
+}
+
+// Adds the start of every page overlapping [begin, begin + bytes) to pages.
+static void addPages(std::vector<void *> &pages, const void *begin, size_t bytes)
+{
+    static const uintptr_t pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    uintptr_t first = reinterpret_cast<uintptr_t>(begin) & ~(pageSize - 1);
+    uintptr_t last = (reinterpret_cast<uintptr_t>(begin) + std::max<size_t>(bytes, 1) - 1) & ~(pageSize - 1);
+    for (uintptr_t page = first; page <= last; page += pageSize)
+        pages.push_back(reinterpret_cast<void *>(page));
+}
+
+// Sorts pages and drops duplicates (neighbouring rows and entities often share a page).
+static void uniquePages(std::vector<void *> &pages)
+{
+    std::sort(pages.begin(), pages.end());
+    pages.erase(std::unique(pages.begin(), pages.end()), pages.end());
+}
+
+// Calls move_pages for this process: with nodes it moves the pages, without it only reports
+// their nodes in status. Returns false if the kernel does not support the call.
+static bool movePages(std::vector<void *> &pages, const int *nodes, std::vector<int> &status)
+{
+    status.assign(pages.size(), -1);
+    if (pages.empty())
+        return true;
+    return syscall(SYS_move_pages, 0, pages.size(), pages.data(), nodes, status.data(), nodes ? MPOL_MF_MOVE : 0) >= 0;
+}
+
+// Calls add(row, object address) for every listed entity of the grid.
+template <typename AddEntity>
+static void forEachListedEntity(const Grid &grid, AddEntity add)
+{
+    for (const auto &plant : grid.getPlants())
+        add(plant->getR(), static_cast<const void *>(plant.get()));
+    for (const auto &herbivore : grid.getHerbivores())
+        add(herbivore->getR(), static_cast<const void *>(herbivore.get()));
+    for (const auto &carnivore : grid.getCarnivores())
+        add(carnivore->getR(), static_cast<const void *>(carnivore.get()));
+}
+
+// NumaPlacement constructor.
+NumaPlacement::NumaPlacement(int tileSize_val) : tileSize(std::max(2, tileSize_val)) {}
+
+// Migrates the cell rows and entities of every stripe to its worker's node; returns the pages moved.
+size_t NumaPlacement::apply(const Grid &grid, const ThreadPool &pool) const
+{
+    const int nodeCount = numaNodeCount();
+    const int threads = pool.getThreadCount();
+    if (nodeCount < 2)
+        return 0;
+    std::vector<int> workerNode(threads);
+    for (int i = 0; i < threads; ++i)
+    {
+        int cpu = pool.getWorkerCpu(i);
+        if (cpu < 0)
+            return 0; // Unpinned workers wander between nodes, so no placement would stay local.
+        workerNode[i] = std::min(numaNodeOfCpu(cpu), nodeCount - 1);
+    }
+
+    // Same stripe-to-worker rule the plant phase uses to pick the starting worker of a task.
+    const int tilesDown = (grid.getHeight() + tileSize - 1) / tileSize;
+    auto nodeOfRow = [&](int r_coord) { return workerNode[(r_coord / tileSize) * threads / tilesDown]; };
+
+    std::vector<std::vector<void *>> pagesOfNode(nodeCount);
+    const size_t rowBytes = sizeof(std::shared_ptr<Entity>) * grid.getWidth();
+    for (int r = grid.getStoredRowBegin(); r < grid.getStoredRowEnd(); ++r)
+        addPages(pagesOfNode[nodeOfRow(r)], grid.storedRow(r), rowBytes);
+    forEachListedEntity(grid, [&](int r_coord, const void *object) { addPages(pagesOfNode[nodeOfRow(r_coord)], object, 1); });
+
+    size_t moved = 0;
+    std::vector<int> status;
+    for (int node = 0; node < nodeCount; ++node)
+    {
+        uniquePages(pagesOfNode[node]);
+        std::vector<int> targets(pagesOfNode[node].size(), node);
+        if (!movePages(pagesOfNode[node], targets.data(), status))
+            return moved;
+        moved += std::count(status.begin(), status.end(), node);
+    }
+    return moved;
+}
+
+// Asks the kernel where the grid's cells and entities currently live.
+MemoryPlacement NumaPlacement::survey(const Grid &grid)
+{
+    MemoryPlacement placement;
+    std::vector<void *> cellPages, entityPages;
+    const size_t rowBytes = sizeof(std::shared_ptr<Entity>) * grid.getWidth();
+    for (int r = grid.getStoredRowBegin(); r < grid.getStoredRowEnd(); ++r)
+        addPages(cellPages, grid.storedRow(r), rowBytes);
+    forEachListedEntity(grid, [&](int, const void *object) { addPages(entityPages, object, 1); });
+    uniquePages(cellPages);
+    uniquePages(entityPages);
+
+    std::vector<int> status;
+    auto tally = [&](std::vector<void *> &pages, std::vector<size_t> &perNode) {
+        if (!movePages(pages, nullptr, status))
+            return false;
+        for (int node : status)
+        {
+            if (node < 0)
+            {
+                placement.unplacedPages++;
+                continue;
+            }
+            if (static_cast<size_t>(node) >= perNode.size())
+                perNode.resize(node + 1, 0);
+            perNode[node]++;
+        }
+        return true;
+    };
+    const int nodeCount = numaNodeCount();
+    placement.cellPagesPerNode.assign(nodeCount, 0);
+    placement.entityPagesPerNode.assign(nodeCount, 0);
+    placement.supported = tally(cellPages, placement.cellPagesPerNode) && tally(entityPages, placement.entityPagesPerNode);
+    return placement;
+}
+
+// Prints a survey as a per-node table.
+void NumaPlacement::report(const MemoryPlacement &placement, std::ostream &out)
+{
+    out << "\n--- Memory Placement ---\n";
+    if (!placement.supported)
+    {
+        out << "The kernel does not report page locations on this system.\n";
+        return;
+    }
+    const size_t nodes = std::max(placement.cellPagesPerNode.size(), placement.entityPagesPerNode.size());
+    out << std::left << std::setw(8) << "Node" << std::setw(14) << "Cell pages" << "Entity pages\n";
+    for (size_t node = 0; node < nodes; ++node)
+    {
+        size_t cells = node < placement.cellPagesPerNode.size() ? placement.cellPagesPerNode[node] : 0;
+        size_t entities = node < placement.entityPagesPerNode.size() ? placement.entityPagesPerNode[node] : 0;
+        out << std::left << std::setw(8) << node << std::setw(14) << cells << entities << "\n";
+    }
+    if (placement.unplacedPages > 0)
+        out << "Unplaced pages: " << placement.unplacedPages << "\n";
+    out << std::right;
+}
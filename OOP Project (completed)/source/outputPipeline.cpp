@@ -0,0 +1,110 @@
+// outputPipeline.cpp
+#include "../headers/outputPipeline.hpp"
+#include "../headers/grid.hpp"
+#include "../headers/ansiRenderer.hpp"
+
+#include <ostream>
+#include <algorithm>
+
+// OutputPipeline constructor (starts the output thread).
+OutputPipeline::OutputPipeline(std::ostream &out_val, size_t capacity_val, OutputBackpressure policy_val,
+                               AnsiRenderer *ansiRenderer_val)
+    : out(out_val), capacity(std::max<size_t>(1, capacity_val)), policy(policy_val), ansiRenderer(ansiRenderer_val), stopping(false),
+      rendering(false), framesWritten(0), framesDropped(0)
+{
+    consumer = std::thread([this] { consume(); });
+}
+
+// Prints everything still queued, then stops the output thread.
+OutputPipeline::~OutputPipeline()
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueChanged.notify_all();
+    consumer.join();
+    out.flush();
+}
+
+// Output thread: prints snapshots in order until stopped and drained.
+void OutputPipeline::consume()
+{
+    std::unique_lock<std::mutex> lock(queueMutex);
+    while (true)
+    {
+        queueChanged.wait(lock, [this] { return stopping || !queue.empty(); });
+        if (queue.empty())
+            return; // Stopping and nothing left
+        MonthSnapshot snapshot = std::move(queue.front());
+        queue.pop_front();
+        rendering = true;
+        queueChanged.notify_all(); // Room for a blocked producer
+
+        lock.unlock();
+        render(out, snapshot, ansiRenderer);
+        lock.lock();
+
+        rendering = false;
+        framesWritten++;
+        queueChanged.notify_all(); // Wakes flush()
+    }
+}
+
+// Queues a month for printing, applying the backpressure policy if the queue is full.
+void OutputPipeline::submit(MonthSnapshot snapshot)
+{
+    {
+        std::unique_lock<std::mutex> lock(queueMutex);
+        if (queue.size() >= capacity)
+        {
+            if (policy == OutputBackpressure::BLOCK)
+                queueChanged.wait(lock, [this] { return queue.size() < capacity; });
+            else
+            {
+                queue.pop_front();
+                framesDropped++;
+            }
+        }
+        queue.push_back(std::move(snapshot));
+    }
+    queueChanged.notify_all();
+}
+
+// Waits until every queued month has been printed.
+void OutputPipeline::flush()
+{
+    std::unique_lock<std::mutex> lock(queueMutex);
+    queueChanged.wait(lock, [this] { return queue.empty() && !rendering; });
+    out.flush();
+}
+
+// Prints one snapshot the way Simulation::runMonth prints a month.
+void OutputPipeline::render(std::ostream &out, const MonthSnapshot &snapshot, AnsiRenderer *ansiRenderer)
+{
+    if (ansiRenderer)
+    {
+        ansiRenderer->render(out, snapshot.cellSymbols, snapshot.firstRow, snapshot.width);
+        out << snapshot.header;
+    }
+    else
+    {
+        out << snapshot.header;
+        Grid::displaySymbols(out, snapshot.cellSymbols, snapshot.firstRow, snapshot.width);
+    }
+    snapshot.stats.display(out);
+}
+
+// Gets the number of months printed so far.
+size_t OutputPipeline::getFramesWritten()
+{
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return framesWritten;
+}
+
+// Gets the number of months dropped because the queue was full.
+size_t OutputPipeline::getFramesDropped()
+{
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return framesDropped;
+}
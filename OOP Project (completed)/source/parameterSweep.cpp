@@ -0,0 +1,168 @@
+// parameterSweep.cpp
+#include "../headers/parameterSweep.hpp"
+#include "../headers/ensemble.hpp"   // For EnsembleRunner::runMember
+#include "../headers/threadPool.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+
+// ParameterSweep constructor.
+ParameterSweep::ParameterSweep(const SimulationConfig &baseConfig_val, int replicates_val, int threadCount_val)
+    : baseConfig(baseConfig_val), replicates(std::max(1, replicates_val)), threadCount(std::max(1, threadCount_val)) {}
+
+// Parses "option=a,b,c" (a list) or "option=start:stop:step" (an inclusive range) into an axis.
+bool ParameterSweep::parseAxis(const std::string &spec, SweepAxis &axis, std::string &error)
+{
+    size_t equals = spec.find('=');
+    if (equals == std::string::npos || equals == 0 || equals + 1 == spec.size())
+    {
+        error = "Axis '" + spec + "' must look like option=a,b,c or option=start:stop:step.";
+        return false;
+    }
+    axis.option = spec.substr(0, equals);
+    axis.values.clear();
+    std::string values = spec.substr(equals + 1);
+
+    if (values.find(':') == std::string::npos)
+    {
+        std::stringstream list(values);
+        std::string item;
+        while (std::getline(list, item, ','))
+            if (!item.empty())
+                axis.values.push_back(item);
+        return true;
+    }
+
+    double start, stop, step;
+    char colon1, colon2;
+    std::istringstream range(values);
+    if (!(range >> start >> colon1 >> stop >> colon2 >> step) || colon1 != ':' || colon2 != ':' || step <= 0.0 || stop < start)
+    {
+        error = "Range '" + values + "' must be start:stop:step with step > 0 and stop >= start.";
+        return false;
+    }
+    // Integer ranges stay integers so they can be applied to integer options.
+    bool integral = start == std::floor(start) && step == std::floor(step);
+    for (int i = 0; start + i * step <= stop + 1e-9; ++i)
+    {
+        std::ostringstream value;
+        if (integral) value << static_cast<long long>(start + i * step);
+        else value << start + i * step;
+        axis.values.push_back(value.str());
+    }
+    return true;
+}
+
+// Adds an axis after checking that every value is accepted by SimulationConfig.
+bool ParameterSweep::addAxis(const SweepAxis &axis, std::string &error)
+{
+    if (axis.values.empty())
+    {
+        error = "Axis " + axis.option + " has no values.";
+        return false;
+    }
+    for (const auto &value : axis.values)
+    {
+        SimulationConfig probe = baseConfig;
+        if (!probe.applyOption(axis.option, value, error))
+            return false;
+    }
+    axes.push_back(axis);
+    return true;
+}
+
+// Gets the number of parameter combinations.
+size_t ParameterSweep::getPointCount() const
+{
+    size_t points = 1;
+    for (const auto &axis : axes)
+        points *= axis.values.size();
+    return points;
+}
+
+// Builds the configuration of one grid point (the last axis varies fastest).
+bool ParameterSweep::configForPoint(size_t point, SimulationConfig &config, std::string &error) const
+{
+    config = baseConfig;
+    for (size_t a = axes.size(); a-- > 0;)
+    {
+        const SweepAxis &axis = axes[a];
+        if (!config.applyOption(axis.option, axis.values[point % axis.values.size()], error))
+            return false;
+        point /= axis.values.size();
+    }
+    return config.validate(error) && config.validateForManyRuns("the sweep's runs", error);
+}
+
+// Runs all points and replicates and writes the results table.
+bool ParameterSweep::run(std::ostream &table, std::string &error) const
+{
+    const size_t pointCount = getPointCount();
+    std::vector<SimulationConfig> pointConfigs(pointCount);
+    for (size_t point = 0; point < pointCount; ++point)
+        if (!configForPoint(point, pointConfigs[point], error))
+        {
+            error = "Point " + std::to_string(point) + ": " + error;
+            return false;
+        }
+
+    const size_t runCount = pointCount * replicates;
+    std::vector<MemberTrajectory> trajectories(runCount);
+    ThreadPool pool(threadCount);
+    pool.parallelFor(runCount, [&](size_t run) {
+        SimulationConfig runConfig = pointConfigs[run / replicates];
+        runConfig.seed = EnsembleRunner::memberSeed(baseConfig.seed, static_cast<int>(run % replicates));
+        runConfig.workerThreads = 1;
+        runConfig.pinThreads = false; // See EnsembleRunner::run
+        runConfig.numaPlacement = false;
+        trajectories[run] = EnsembleRunner::runMember(runConfig, nullptr);
+    });
+
+    int monthColumns = 0; // Enough for the longest run ("years" may itself be swept)
+    for (const auto &config : pointConfigs)
+        monthColumns = std::max(monthColumns, config.years * 12);
+
+    table << "point,replicate,seed";
+    for (const auto &axis : axes)
+        table << "," << axis.option;
+    table << ",months,end_reason,final_plants,final_herbivores,final_carnivores";
+    for (int month = 1; month <= monthColumns; ++month)
+        table << ",m" << month << "_plants,m" << month << "_herbivores,m" << month << "_carnivores";
+    table << "\n";
+
+    for (size_t run = 0; run < runCount; ++run)
+    {
+        const size_t point = run / replicates;
+        const MemberTrajectory &trajectory = trajectories[run];
+        table << point << "," << run % replicates << "," << EnsembleRunner::memberSeed(baseConfig.seed, static_cast<int>(run % replicates));
+        size_t remainder = point;
+        std::vector<std::string> pointValues(axes.size());
+        for (size_t a = axes.size(); a-- > 0;)
+        {
+            pointValues[a] = axes[a].values[remainder % axes[a].values.size()];
+            remainder /= axes[a].values.size();
+        }
+        for (const auto &value : pointValues)
+            table << "," << value;
+
+        std::array<int, 3> finalPopulations = {0, 0, 0};
+        if (!trajectory.monthlyPopulations.empty())
+            finalPopulations = trajectory.monthlyPopulations.back();
+        table << "," << trajectory.monthlyPopulations.size() << ",\"" << trajectory.endReason << "\","
+              << finalPopulations[0] << "," << finalPopulations[1] << "," << finalPopulations[2];
+        for (int month = 0; month < monthColumns; ++month)
+        {
+            if (month < static_cast<int>(trajectory.monthlyPopulations.size()))
+            {
+                const auto &populations = trajectory.monthlyPopulations[month];
+                table << "," << populations[0] << "," << populations[1] << "," << populations[2];
+            }
+            else
+                table << ",,,"; // The run ended before this month.
+        }
+        table << "\n";
+    }
+    return true;
+}
@@ -0,0 +1,121 @@
+// perfCounters.cpp
+#include "../headers/perfCounters.hpp"
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <cstdint>
+
+// Opens one counter of the calling thread (in the group of groupFd, or as a new leader if -1).
+static int openCounter(uint32_t type, uint64_t config, int groupFd)
+{
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = groupFd == -1 ? 1 : 0; // The leader starts the whole group once every member is in
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0));
+}
+
+// Opens every counter it can on the calling thread and starts counting.
+PerfCounterGroup::PerfCounterGroup() : leaderFd(-1), openedCount(0)
+{
+    fds.fill(-1);
+    groupSlots.fill(-1);
+    const uint64_t cacheMiss = (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    const struct
+    {
+        uint32_t type;
+        uint64_t config;
+    } events[HARDWARE_COUNTER_COUNT] = {
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | cacheMiss},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    };
+
+    std::string missing;
+    int firstErrno = 0;
+    for (size_t i = 0; i < HARDWARE_COUNTER_COUNT; ++i)
+    {
+        int fd = openCounter(events[i].type, events[i].config, leaderFd);
+        if (fd < 0)
+        {
+            if (!firstErrno)
+                firstErrno = errno;
+            missing += std::string(missing.empty() ? "" : ", ") + getCounterName(static_cast<HardwareCounter>(i));
+            continue;
+        }
+        if (leaderFd == -1)
+            leaderFd = fd;
+        fds[i] = fd;
+        groupSlots[i] = openedCount++;
+    }
+
+    if (leaderFd == -1)
+    {
+        unavailableReason = std::string("perf_event_open failed (") + std::strerror(firstErrno) + ")";
+        if (firstErrno == EACCES || firstErrno == EPERM)
+            unavailableReason += "; check /proc/sys/kernel/perf_event_paranoid or the container's seccomp profile";
+        return;
+    }
+    if (!missing.empty())
+        unavailableReason = "not counted: " + missing + " (" + std::strerror(firstErrno) + ")";
+    ioctl(leaderFd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(leaderFd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+// Closes the counters.
+PerfCounterGroup::~PerfCounterGroup()
+{
+    for (int fd : fds)
+        if (fd >= 0)
+            close(fd);
+}
+
+// Whether at least one counter is counting.
+bool PerfCounterGroup::isAvailable() const { return leaderFd >= 0; }
+// Whether a particular counter is counting.
+bool PerfCounterGroup::hasCounter(HardwareCounter counter) const { return fds[static_cast<size_t>(counter)] >= 0; }
+// Gets why no counter (or not every counter) could be opened; empty if all are counting.
+const std::string &PerfCounterGroup::getUnavailableReason() const { return unavailableReason; }
+
+// Reads the running totals, scaled up if the kernel had to multiplex the group; false if unavailable.
+bool PerfCounterGroup::read(CounterValues &values) const
+{
+    values.fill(0);
+    if (leaderFd < 0)
+        return false;
+    // Layout of a PERF_FORMAT_GROUP read: nr, time_enabled, time_running, then one value per member.
+    uint64_t buffer[3 + HARDWARE_COUNTER_COUNT];
+    ssize_t bytes = ::read(leaderFd, buffer, sizeof(buffer));
+    if (bytes < static_cast<ssize_t>(3 * sizeof(uint64_t)) || buffer[0] != static_cast<uint64_t>(openedCount))
+        return false;
+    const uint64_t enabled = buffer[1], running = buffer[2];
+    for (size_t i = 0; i < HARDWARE_COUNTER_COUNT; ++i)
+    {
+        if (groupSlots[i] < 0)
+            continue;
+        uint64_t raw = buffer[3 + groupSlots[i]];
+        values[i] = (running > 0 && running < enabled)
+                        ? static_cast<unsigned long long>(static_cast<double>(raw) * enabled / running)
+                        : raw;
+    }
+    return true;
+}
+
+// Gets the display name of a counter.
+const char *PerfCounterGroup::getCounterName(HardwareCounter counter)
+{
+    static const char *const names[HARDWARE_COUNTER_COUNT] = {"cycles", "instructions", "L1D misses", "LLC misses",
+                                                              "branch misses"};
+    return names[static_cast<size_t>(counter)];
+}
@@ -0,0 +1,176 @@
+// phaseTimer.cpp
+#include "../headers/phaseTimer.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+
+// PhaseTimer constructor (disabled).
+PhaseTimer::PhaseTimer() : enabled(false), traceRecorder(nullptr), month(0)
+{
+    reset();
+}
+
+// Turns timing on or off.
+void PhaseTimer::setEnabled(bool enabled_val) { enabled = enabled_val; }
+
+// Also records every phase and month as a trace span (nullptr stops it).
+void PhaseTimer::setTraceRecorder(TraceRecorder *recorder) { traceRecorder = recorder; }
+
+// Forgets every sample.
+void PhaseTimer::reset()
+{
+    monthSeconds.fill(0.0);
+    monthUpdates.fill(0);
+    totalUpdates.fill(0);
+    lapCounters.fill(0);
+    for (auto &phaseCounters : totalCounters)
+        phaseCounters.fill(0);
+    for (auto &phaseSamples : samples)
+        phaseSamples.clear();
+}
+
+// Also counts cycles, instructions, cache and branch misses of each phase on the calling thread.
+bool PhaseTimer::setHardwareCounters(bool enabled_val)
+{
+    hardwareCounters.reset(); // Close the old group before opening a new one
+    if (enabled_val)
+        hardwareCounters.reset(new PerfCounterGroup());
+    return !enabled_val || hardwareCounters->isAvailable();
+}
+
+// Charges the counter deltas since the last lap to a phase.
+void PhaseTimer::chargeCounters(SimPhase phase)
+{
+    CounterValues now;
+    if (!hardwareCounters->read(now))
+        return;
+    CounterValues &phaseCounters = totalCounters[static_cast<size_t>(phase)];
+    for (size_t i = 0; i < HARDWARE_COUNTER_COUNT; ++i)
+        if (now[i] > lapCounters[i]) // Multiplexing estimates can step back slightly
+            phaseCounters[i] += now[i] - lapCounters[i];
+    lapCounters = now;
+}
+
+// Stores this month's time of every phase as one sample.
+void PhaseTimer::endMonth()
+{
+    if (traceRecorder)
+        traceRecorder->addSpan("Month", "month", monthStart, Clock::now(), "month", month);
+    if (!enabled)
+    {
+        monthSeconds.fill(0.0); // Only laps for the trace were taken
+        monthUpdates.fill(0);
+        return;
+    }
+    for (size_t phase = 0; phase < PHASE_COUNT; ++phase)
+    {
+        samples[phase].push_back(monthSeconds[phase]);
+        totalUpdates[phase] += monthUpdates[phase];
+    }
+    monthSeconds.fill(0.0);
+    monthUpdates.fill(0);
+}
+
+// Gets the number of months timed.
+size_t PhaseTimer::getMonthCount() const { return samples[0].size(); }
+// Gets the time of a phase in every month timed.
+const std::vector<double> &PhaseTimer::getSamples(SimPhase phase) const { return samples[static_cast<size_t>(phase)]; }
+// Gets the counter deltas of a phase over the run (zero without hardware counters).
+const CounterValues &PhaseTimer::getCounterTotals(SimPhase phase) const { return totalCounters[static_cast<size_t>(phase)]; }
+
+// Gets the display name of a phase.
+const char *PhaseTimer::getPhaseName(SimPhase phase)
+{
+    static const char *const names[PHASE_COUNT] = {"Setup", "Exchange", "Carnivores", "Herbivores",
+                                                   "Plants", "Migration", "Cleanup", "Display"};
+    return names[static_cast<size_t>(phase)];
+}
+
+// Gets a percentile (nearest rank) of sorted samples.
+static double percentile(const std::vector<double> &sorted, double fraction)
+{
+    if (sorted.empty())
+        return 0.0;
+    size_t rank = static_cast<size_t>(fraction * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+// Prints total, mean, p50 and p99 time and entity updates per second of every phase that ran.
+void PhaseTimer::report(std::ostream &out) const
+{
+    const size_t months = getMonthCount();
+    out << "\n--- Phase Timing (" << months << " months) ---\n";
+    out << std::left << std::setw(12) << "Phase" << std::setw(12) << "Total (ms)" << std::setw(11) << "Mean (ms)"
+        << std::setw(10) << "p50 (ms)" << std::setw(10) << "p99 (ms)" << "Updates/s\n";
+    for (size_t phase = 0; phase < PHASE_COUNT && months > 0; ++phase)
+    {
+        std::vector<double> sorted = samples[phase];
+        std::sort(sorted.begin(), sorted.end());
+        double total = 0.0;
+        for (double seconds : sorted)
+            total += seconds;
+        if (total == 0.0 && totalUpdates[phase] == 0)
+            continue; // Phase never ran (e.g. exchanges outside a decomposed run)
+        out << std::left << std::setw(12) << getPhaseName(static_cast<SimPhase>(phase)) << std::fixed << std::setprecision(3)
+            << std::setw(12) << total * 1000.0 << std::setw(11) << total * 1000.0 / months
+            << std::setw(10) << percentile(sorted, 0.5) * 1000.0 << std::setw(10) << percentile(sorted, 0.99) * 1000.0;
+        if (totalUpdates[phase] > 0 && total > 0.0)
+            out << std::setprecision(0) << totalUpdates[phase] / total;
+        else
+            out << "-";
+        out << "\n";
+    }
+    out << std::defaultfloat << std::right;
+    if (hardwareCounters)
+        reportCounters(out);
+}
+
+// Prints the counters of every phase per entity update (per month for phases without updates).
+void PhaseTimer::reportCounters(std::ostream &out) const
+{
+    if (!hardwareCounters->isAvailable())
+    {
+        out << "\nHardware counters unavailable: " << hardwareCounters->getUnavailableReason() << "\n";
+        return;
+    }
+    const size_t months = getMonthCount();
+    out << "\n--- Hardware Counters (simulation thread) ---\n";
+    out << std::left << std::setw(12) << "Phase" << std::setw(7) << "Per" << std::setw(12) << "Cycles"
+        << std::setw(14) << "Instructions" << std::setw(7) << "IPC" << std::setw(12) << "L1D misses"
+        << std::setw(12) << "LLC misses" << "Branch misses\n";
+    for (size_t phase = 0; phase < PHASE_COUNT && months > 0; ++phase)
+    {
+        const CounterValues &counters = totalCounters[phase];
+        if (counters[static_cast<size_t>(HardwareCounter::CYCLES)] == 0 &&
+            counters[static_cast<size_t>(HardwareCounter::INSTRUCTIONS)] == 0)
+            continue; // Phase never ran
+        const bool perUpdate = totalUpdates[phase] > 0;
+        const double divisor = perUpdate ? static_cast<double>(totalUpdates[phase]) : static_cast<double>(months);
+        out << std::left << std::setw(12) << getPhaseName(static_cast<SimPhase>(phase)) << std::setw(7)
+            << (perUpdate ? "update" : "month") << std::fixed << std::setprecision(1);
+        const int widths[HARDWARE_COUNTER_COUNT] = {12, 14, 12, 12, 0};
+        for (size_t i = 0; i < HARDWARE_COUNTER_COUNT; ++i)
+        {
+            if (i == static_cast<size_t>(HardwareCounter::L1D_MISSES)) // IPC goes between instructions and misses
+            {
+                const double cycles = static_cast<double>(counters[static_cast<size_t>(HardwareCounter::CYCLES)]);
+                out << std::setw(7);
+                if (cycles > 0.0 && hardwareCounters->hasCounter(HardwareCounter::INSTRUCTIONS))
+                    out << std::setprecision(2) << counters[static_cast<size_t>(HardwareCounter::INSTRUCTIONS)] / cycles
+                        << std::setprecision(1);
+                else
+                    out << "-";
+            }
+            out << std::setw(widths[i]);
+            if (hardwareCounters->hasCounter(static_cast<HardwareCounter>(i)))
+                out << counters[i] / divisor;
+            else
+                out << "-";
+        }
+        out << "\n";
+    }
+    out << std::defaultfloat << std::right;
+    if (!hardwareCounters->getUnavailableReason().empty())
+        out << "Some counters are missing: " << hardwareCounters->getUnavailableReason() << "\n";
+}
@@ -0,0 +1,88 @@
+// plantPhase.cpp
+#include "../headers/plantPhase.hpp"
+#include "../headers/plants.hpp"
+#include "../headers/grid.hpp"
+#include "../headers/threadPool.hpp"
+#include "../headers/utils.hpp" // For ScopedRandomGenerator, deriveSeed
+#include "../headers/traceRecorder.hpp"
+
+#include <algorithm> // For std::max
+
+// ParallelPlantPhase constructor.
+ParallelPlantPhase::ParallelPlantPhase(int tileSize_val) : tileSize(std::max(2, tileSize_val)) {}
+
+// Gets the tile edge length in cells.
+int ParallelPlantPhase::getTileSize() const { return tileSize; }
+
+// Runs the plant update for one month and merges every tile into stats.
+void ParallelPlantPhase::run(Grid &grid, StatsShard &stats, Season currentSeason, ThreadPool &pool, unsigned int monthSeed) const
+{
+    const int tilesDown = (grid.getHeight() + tileSize - 1) / tileSize;
+    const int tilesAcross = (grid.getWidth() + tileSize - 1) / tileSize;
+    const size_t tileCount = static_cast<size_t>(tilesDown) * tilesAcross;
+
+    // Bucket the plants alive at the start of the phase by tile. New plants are
+    // only listed during the merge, so the grid's list stays stable meanwhile.
+    std::vector<std::vector<Plant *>> tilePlants(tileCount);
+    for (const auto &p_ptr : grid.getPlants())
+        if (p_ptr->isAlive())
+            tilePlants[static_cast<size_t>(p_ptr->getR() / tileSize) * tilesAcross + p_ptr->getC() / tileSize].push_back(p_ptr.get());
+
+    // Tasks are sized by plant count, not area: consecutive tiles of one color
+    // are grouped until they hold about targetPopulation plants, so sparse
+    // regions do not turn into a swarm of near-empty tasks. Each task starts on
+    // the worker owning the row stripe of its first tile; idle workers steal.
+    const int threads = pool.getThreadCount();
+    const size_t targetPopulation = std::max<size_t>(256, grid.getPlants().size() / (static_cast<size_t>(threads) * 8));
+
+    std::vector<PlantTileBuffer> buffers(tileCount);
+    for (int color = 0; color < 4; ++color)
+    {
+        std::vector<size_t> colorTiles;
+        std::vector<size_t> taskStarts; // Index into colorTiles where each task begins
+        size_t taskPopulation = targetPopulation;
+        for (int tr = color / 2; tr < tilesDown; tr += 2)
+            for (int tc = color % 2; tc < tilesAcross; tc += 2)
+            {
+                size_t tile = static_cast<size_t>(tr) * tilesAcross + tc;
+                if (tilePlants[tile].empty())
+                    continue;
+                if (taskPopulation >= targetPopulation)
+                {
+                    taskStarts.push_back(colorTiles.size());
+                    taskPopulation = 0;
+                }
+                colorTiles.push_back(tile);
+                taskPopulation += tilePlants[tile].size();
+            }
+        taskStarts.push_back(colorTiles.size());
+
+        pool.runTasks(taskStarts.size() - 1, [&](size_t task) {
+            for (size_t i = taskStarts[task]; i < taskStarts[task + 1]; ++i)
+            {
+                size_t tile = colorTiles[i];
+                ECOSIM_TRACE_SCOPE("Tile", "plants", "tile", static_cast<long long>(tile));
+                std::mt19937 tileRng(deriveSeed(monthSeed, tile));
+                ScopedRandomGenerator bindRng(tileRng);
+                for (Plant *plant : tilePlants[tile])
+                    if (plant->isAlive())
+                        plant->updateInTile(grid, buffers[tile].stats, currentSeason, buffers[tile]);
+            }
+        }, [&](size_t task) {
+            int tileRow = static_cast<int>(colorTiles[taskStarts[task]] / tilesAcross);
+            return tileRow * threads / tilesDown;
+        });
+    }
+
+    // Merge step, in tile order on the calling thread: list spread plants,
+    // fold in the tile counters and place the deferred random seedings.
+    ECOSIM_TRACE_SCOPE("Merge tiles", "plants");
+    for (auto &buffer : buffers)
+    {
+        grid.adoptPlacedPlants(buffer.spreadPlants);
+        stats.absorb(buffer.stats);
+        for (const auto &seedParams : buffer.pendingSeeds)
+            if (Plant::seedRandomCell(grid, seedParams))
+                stats.incrementPlantsSpread();
+    }
+}
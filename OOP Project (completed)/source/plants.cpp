@@ -1,20 +1,50 @@
 // plant.cpp
 #include "../headers/plants.hpp"
 #include "../headers/grid.hpp"
-#include "../headers/monthlyStats.hpp"
+#include "../headers/statsShard.hpp"
 #include "../headers/utils.hpp" // For getRandomInt
+#include "../headers/plantPhase.hpp" // For PlantTileBuffer
 
 // Plant constructor.
-Plant::Plant(int r_coord, int c_coord)
+Plant::Plant(int r_coord, int c_coord, const PlantParams &params)
     : Entity(r_coord, c_coord, EntityType::PLANT, 'P'), 
-      baseSpreadChanceValue(35), maximumAge(40), currentAge(0),
-      winterDeathChanceRate(20), autumnDeathChanceRate(10) {}
+      baseSpreadChanceValue(params.spreadChance), maximumAge(params.maxAge), currentAge(0),
+      winterDeathChanceRate(params.winterDeathChance), autumnDeathChanceRate(params.autumnDeathChance) {}
 
 // Gets the species name ("Plant").
 std::string Plant::getSpeciesName() const { return "Plant"; }
 
 // Updates the plant's state for the current month.
-void Plant::update(Grid &grid, MonthlyStats &stats, Season currentSeason) {
+void Plant::update(Grid &grid, StatsShard &stats, Season currentSeason) {
+    grow(grid, stats, currentSeason, nullptr);
+}
+
+// Updates the plant inside a tile of the parallel plant phase.
+void Plant::updateInTile(Grid &grid, StatsShard &stats, Season currentSeason, PlantTileBuffer &tileBuffer) {
+    grow(grid, stats, currentSeason, &tileBuffer);
+}
+
+// Seeds a new plant with the given parameters into a random empty cell among the grid's owned rows.
+bool Plant::seedRandomCell(Grid &grid, const PlantParams &params) {
+    int newR_plant, newC_plant;
+    int attempts = 0;
+    do {
+        newR_plant = getRandomInt(grid.getOwnedRowBegin(), grid.getOwnedRowEnd() - 1);
+        newC_plant = getRandomInt(0, grid.getWidth() - 1);
+        attempts++;
+        if (attempts > grid.getOwnedCellCount() * 2) break; 
+    } while (!grid.isEmpty(newR_plant, newC_plant));
+
+    if (grid.isEmpty(newR_plant, newC_plant)) {
+        auto newPlant = std::make_shared<Plant>(newR_plant, newC_plant, params);
+        return grid.addEntity(newPlant);
+    }
+    return false;
+}
+
+// Shared update logic. Inside a tile, spread plants only claim their cell and
+// random seedings are counted so the merge step can place them afterwards.
+void Plant::grow(Grid &grid, StatsShard &stats, Season currentSeason, PlantTileBuffer *tileBuffer) {
     if (!isAlive())
         return;
     currentAge++;
@@ -58,8 +88,13 @@ void Plant::update(Grid &grid, MonthlyStats &stats, Season currentSeason) {
             if (localEmptyCells.size() > 1) choice = getRandomInt(0, localEmptyCells.size() - 1);
             else if (localEmptyCells.empty()) return;
 
-            auto newPlant = std::make_shared<Plant>(localEmptyCells[choice].first, localEmptyCells[choice].second);
-            if (grid.addEntity(newPlant))
+            auto newPlant = std::make_shared<Plant>(localEmptyCells[choice].first, localEmptyCells[choice].second, getParams());
+            if (tileBuffer) {
+                if (grid.placeInCell(newPlant)) {
+                    tileBuffer->spreadPlants.push_back(newPlant);
+                    stats.incrementPlantsSpread();
+                }
+            } else if (grid.addEntity(newPlant))
                 stats.incrementPlantsSpread();
         }
     }
@@ -74,20 +109,10 @@ void Plant::update(Grid &grid, MonthlyStats &stats, Season currentSeason) {
     if (newPlantChance > 0) {
         for (int i = 0; i < 2; ++i) { 
             if (getRandomInt(1, 100) <= newPlantChance) {
-                int newR_plant, newC_plant;
-                int attempts = 0;
-                do {
-                    newR_plant = getRandomInt(0, GRID_HEIGHT - 1);
-                    newC_plant = getRandomInt(0, GRID_WIDTH - 1);
-                    attempts++;
-                    if (attempts > GRID_WIDTH * GRID_HEIGHT * 2) break; 
-                } while (!grid.isEmpty(newR_plant, newC_plant));
-
-                if (grid.isEmpty(newR_plant, newC_plant)) {
-                    auto newPlant = std::make_shared<Plant>(newR_plant, newC_plant);
-                    if (grid.addEntity(newPlant))
-                        stats.incrementPlantsSpread();
-                }
+                if (tileBuffer)
+                    tileBuffer->pendingSeeds.push_back(getParams());
+                else if (seedRandomCell(grid, getParams()))
+                    stats.incrementPlantsSpread();
             }
         }
     }
@@ -99,4 +124,11 @@ int Plant::getBaseSpreadChance() const { return baseSpreadChanceValue; }
 // Gets the maximum age of the plant.
 int Plant::getMaxAgePlant() const { return maximumAge; }
 // Gets the current age of the plant.
-int Plant::getCurrentAgePlant() const { return currentAge; }
\ No newline at end of file
+int Plant::getCurrentAgePlant() const { return currentAge; }
+// Restores the age of a plant handed over from another process.
+void Plant::setCurrentAgePlant(int age_val) { currentAge = age_val; }
+// Gets the parameters passed on to spread and seeded plants.
+PlantParams Plant::getParams() const
+{
+    return {baseSpreadChanceValue, maximumAge, winterDeathChanceRate, autumnDeathChanceRate};
+}
\ No newline at end of file
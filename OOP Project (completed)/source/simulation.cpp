@@ -5,18 +5,264 @@
 #include "../headers/carnivore.hpp"
 #include "../headers/utils.hpp"
 #include "../headers/grid.hpp"
+#include "../headers/plantPhase.hpp"
+#include "../headers/movePhase.hpp"
+#include "../headers/domain.hpp"
+#include "../headers/numaPlacement.hpp"
+#include "../headers/statsSink.hpp"
+#include "../headers/entityRecord.hpp"
+#include "../headers/worldSnapshot.hpp"
 
 #include <iostream>     // For std::cout, std::cin
+#include <fstream>      // For the trace file and checkpoints
+#include <sstream>      // For the generator state
+#include <cstdio>       // For std::rename, std::remove
 #include <algorithm>    // For std::min, std::remove_if
 #include <cctype>        // For toupper
+#include <unordered_set> // For the entities saved from the lists
 
 // Simulation constructor.
-Simulation::Simulation() 
-    : totalMonthsDuration(0), currentMonthCounter(0), carnivoresStarvedPreviousMonth(false), 
+Simulation::Simulation(int gridHeight, int gridWidth) : Simulation(Grid(gridHeight, gridWidth)) {}
+
+// Builds a simulation around an already constructed (possibly subdomain) grid.
+Simulation::Simulation(Grid grid)
+    : sim_grid(std::move(grid)), totalMonthsDuration(0), currentMonthCounter(0), carnivoresStarvedPreviousMonth(false), 
       isNorthernHemisphereSelected(true), current_Season_sim(Season::NONE), currentMonthIndexInYear(0),
       month_Names_sim{"January", "February", "March", "April", "May", "June", 
                       "July", "August", "September", "October", "November", "December"},
-      simulationEndReason("") {}
+      simulationEndReason(""), sim_rng(activeRandomGenerator()()), workerPool(new ThreadPool(1)),
+      parallelPlantUpdate(false), plantTileSize(64), intentMovement(false), synchronousUpdate(false),
+      pinWorkerThreads(false), numaPlacement(false), pagesPlaced(0),
+      outputStream(&std::cout), interactivePrompts(true), outputQueueCapacity(0), outputBackpressure(OutputBackpressure::BLOCK),
+      herbivoreParams(HERBIVORE_DEFAULTS), carnivoreParams(CARNIVORE_DEFAULTS), plantParams(PLANT_DEFAULTS),
+      domainExchange(nullptr), printMemoryReport(false), heatmapFormat(HeatmapFormat::PGM), heatmapMonths(0), heatmapYear(1),
+      checkpointInterval(0), snapshotInterval(0) {}
+
+// Builds and populates a non-interactive simulation from a validated configuration.
+Simulation::Simulation(const SimulationConfig &config) : Simulation(config, Grid(config.gridHeight, config.gridWidth)) {}
+
+// Same as above, but simulating only the owned rows of a subdomain grid.
+Simulation::Simulation(const SimulationConfig &config, Grid grid) : Simulation(std::move(grid))
+{
+    interactivePrompts = false;
+    setSeed(config.seed);
+    setWorkerThreads(config.workerThreads, config.pinThreads);
+    setParallelPlantUpdate(config.parallelPlantUpdate, config.plantTileSize);
+    setIntentMovement(config.intentMovement);
+    setSynchronousUpdate(config.synchronousUpdate);
+    setEventMask(config.eventMask);
+    setEventCapacity(static_cast<size_t>(config.eventCapacity));
+    setPhaseTiming(config.phaseTiming);
+    setHardwareCounters(config.hardwareCounters);
+    setTraceFile(config.traceFile);
+    setMemoryReport(config.memoryReport, config.memoryReportFile);
+    setHeatmaps(config.heatmapDirectory, config.heatmapFormat);
+    setCheckpointing(config.checkpointFile, config.checkpointInterval);
+    setSnapshots(config.snapshotDirectory, config.snapshotInterval);
+    setAnsiRendering(config.ansiRendering);
+    setBackgroundOutput(static_cast<size_t>(config.outputQueueCapacity),
+                        config.dropOutputWhenBehind ? OutputBackpressure::DROP_OLDEST : OutputBackpressure::BLOCK);
+    herbivoreParams = config.herbivoreParams;
+    carnivoreParams = config.carnivoreParams;
+    plantParams = config.plantParams;
+    isNorthernHemisphereSelected = config.northernHemisphere;
+    totalMonthsDuration = config.years * 12;
+    sim_history.reserve(totalMonthsDuration);
+    if (!config.restoreFile.empty())
+    {
+        numaPlacement = config.numaPlacement; // Applied once the checkpoint's grid is in place
+        return; // The grid and run state come from the checkpoint (see loadCheckpoint)
+    }
+
+    ScopedRandomGenerator bindRng(sim_rng);
+    populate(config.initialPlants, config.initialHerbivores, config.initialCarnivores);
+    setNumaPlacement(config.numaPlacement);
+}
+
+// Reseeds the simulation's random generator.
+void Simulation::setSeed(unsigned int seed) { sim_rng.seed(seed); }
+
+// Sets how many threads the parallel phases may use.
+void Simulation::setWorkerThreads(int threadCount, bool pinThreads)
+{
+    workerPool.reset(); // The old pool first hands the calling thread its CPUs back
+    workerPool.reset(new ThreadPool(std::max(1, threadCount), pinThreads));
+    workerPool->setTraceRecorder(traceRecorder.get());
+    pinWorkerThreads = pinThreads;
+}
+
+// Moves each stripe of grid rows, with its entities, to the NUMA node of the worker that updates it.
+void Simulation::setNumaPlacement(bool enabled)
+{
+    numaPlacement = enabled;
+    pagesPlaced = enabled ? NumaPlacement(plantTileSize).apply(sim_grid, *workerPool) : 0;
+}
+
+// Switches the plant phase to the tiled parallel update.
+void Simulation::setParallelPlantUpdate(bool enabled, int tileSize)
+{
+    parallelPlantUpdate = enabled;
+    plantTileSize = tileSize;
+}
+
+// Switches the animal phases to two-phase intent/resolve movement.
+void Simulation::setIntentMovement(bool enabled) { intentMovement = enabled; }
+
+// Switches to synchronous updates: cells are read as they were when the month began; moves and births show next month.
+void Simulation::setSynchronousUpdate(bool enabled) { synchronousUpdate = enabled; }
+
+// Chooses which event categories the monthly report records.
+void Simulation::setEventMask(unsigned int mask) { sim_shard.setEventMask(mask); }
+
+// Sets the most events the monthly report keeps and allocates their storage up front.
+void Simulation::setEventCapacity(size_t capacity)
+{
+    sim_shard.setEventCapacity(capacity);
+    sim_stats.setEventCapacity(capacity);
+}
+
+// Redirects all output of the simulation (nullptr discards it).
+void Simulation::setOutput(std::ostream *out)
+{
+    outputStream = out;
+    rebuildOutputPipeline();
+}
+
+// Prints months on a background thread through a queue of queueCapacity months (0 turns it off).
+void Simulation::setBackgroundOutput(size_t queueCapacity, OutputBackpressure policy)
+{
+    outputQueueCapacity = queueCapacity;
+    outputBackpressure = policy;
+    rebuildOutputPipeline();
+}
+
+// Redraws only the cells that changed each month on an ANSI terminal (falls back to full redraws).
+void Simulation::setAnsiRendering(bool enabled, double fullRedrawFraction)
+{
+    outputPipeline.reset(); // The pipeline may be drawing with the old renderer
+    if (ansiRenderer && outputStream)
+        ansiRenderer->finish(*outputStream);
+    ansiRenderer.reset(enabled ? new AnsiRenderer(fullRedrawFraction) : nullptr);
+    rebuildOutputPipeline();
+}
+
+// Recreates (or removes) the background output pipeline after an output setting changed.
+void Simulation::rebuildOutputPipeline()
+{
+    outputPipeline.reset(); // Prints whatever the old pipeline still held
+    if (outputStream && outputQueueCapacity > 0)
+        outputPipeline.reset(new OutputPipeline(*outputStream, outputQueueCapacity, outputBackpressure, ansiRenderer.get()));
+}
+
+// Waits for the background output to catch up before writing to the output stream directly.
+void Simulation::flushOutput()
+{
+    if (outputPipeline)
+        outputPipeline->flush();
+}
+
+// Times every phase of runMonth and adds a per-phase summary to the end report.
+void Simulation::setPhaseTiming(bool enabled) { phaseTimer.setEnabled(enabled); }
+
+// Adds hardware counters per entity update of every phase to the phase timing report.
+void Simulation::setHardwareCounters(bool enabled) { phaseTimer.setHardwareCounters(enabled); }
+
+// Records a trace of the run and writes it to path when the simulation ends (empty turns it off).
+void Simulation::setTraceFile(const std::string &path)
+{
+    traceFile = path;
+    if (path.empty())
+        traceRecorder.reset();
+    else if (!traceRecorder)
+        traceRecorder.reset(new TraceRecorder());
+    phaseTimer.setTraceRecorder(traceRecorder.get());
+    workerPool->setTraceRecorder(traceRecorder.get());
+}
+
+// Adds a memory report to the end report and/or writes it as JSON to jsonPath.
+void Simulation::setMemoryReport(bool print, const std::string &jsonPath)
+{
+    printMemoryReport = print;
+    memoryReportFile = jsonPath;
+}
+
+// Counts events per cell and writes them to directory once per simulated year (empty turns it off).
+void Simulation::setHeatmaps(const std::string &directory, HeatmapFormat format)
+{
+    heatmapDirectory = directory;
+    heatmapFormat = format;
+    if (directory.empty())
+        heatmaps.reset();
+    else if (!heatmaps)
+        heatmaps.reset(new SpatialHeatmaps(sim_grid.getHeight(), sim_grid.getWidth()));
+    sim_shard.setHeatmaps(heatmaps.get());
+}
+
+// Writes the heatmaps of the year so far and starts counting the next year.
+void Simulation::flushHeatmaps()
+{
+    std::string error;
+    if (!heatmaps->writeYear(heatmapDirectory, heatmapYear, heatmapFormat, error))
+        heatmapError = error;
+    heatmaps->clear();
+    heatmapMonths = 0;
+    heatmapYear++;
+}
+
+// Whether a memory report is printed or written at the end.
+bool Simulation::reportsMemory() const { return printMemoryReport || !memoryReportFile.empty(); }
+
+// Adds the month's populations, births and deaths to the trace as counter tracks.
+void Simulation::recordTraceCounters()
+{
+    traceRecorder->addCounter("Population", "plants", sim_stats.getCurrentPlants());
+    traceRecorder->addCounter("Population", "herbivores", sim_stats.getCurrentHerbivores());
+    traceRecorder->addCounter("Population", "carnivores", sim_stats.getCurrentCarnivores());
+    traceRecorder->addCounter("Births", "herbivores", sim_stats.getHerbivoresSpawned());
+    traceRecorder->addCounter("Births", "carnivores", sim_stats.getCarnivoresSpawned());
+    traceRecorder->addCounter("Births", "plants", sim_stats.getPlantsSpread());
+    traceRecorder->addCounter("Removals", "plants", sim_stats.getPlantsEaten() + sim_stats.getPlantsDiedNaturalAge() +
+                                                    sim_stats.getPlantsDiedWeather());
+    traceRecorder->addCounter("Removals", "herbivores", sim_stats.getHerbivoresEaten() + sim_stats.getHerbivoresDiedNatural());
+    traceRecorder->addCounter("Removals", "carnivores", sim_stats.getCarnivoresEaten() + sim_stats.getCarnivoresDiedNatural());
+}
+
+// Writes the trace to traceFile; returns false if the file could not be written.
+bool Simulation::writeTraceFile() const
+{
+    std::ofstream traceOut(traceFile);
+    if (!traceOut)
+        return false;
+    traceRecorder->writeJson(traceOut);
+    return static_cast<bool>(traceOut);
+}
+
+// Writes a checkpoint to path after every everyMonths months (0 turns it off).
+void Simulation::setCheckpointing(const std::string &path, int everyMonths)
+{
+    checkpointFile = path;
+    checkpointInterval = path.empty() ? 0 : std::max(0, everyMonths);
+}
+
+// Writes a world snapshot to directory after every everyMonths months (0 turns it off).
+void Simulation::setSnapshots(const std::string &directory, int everyMonths)
+{
+    snapshotDirectory = directory;
+    snapshotInterval = directory.empty() ? 0 : std::max(0, everyMonths);
+}
+
+// Hands every completed month to a sink as well.
+void Simulation::addStatsSink(StatsSink *sink)
+{
+    if (sink)
+        statsSinks.push_back(sink);
+}
+
+// Stops handing months to the sinks added so far.
+void Simulation::clearStatsSinks() { statsSinks.clear(); }
+
+// Runs this simulation as one subdomain of a larger world.
+void Simulation::setDomainExchange(DomainExchange *exchange) { domainExchange = exchange; }
 
 // Helper function to get validated integer input.
 int Simulation::getValidIntInput(const std::string& prompt, int minVal, int maxVal) {
@@ -73,18 +319,19 @@ void Simulation::determineSeason()
     sim_stats.setCurrentSeasonName(getSeasonName(current_Season_sim));
 }
 
-// Initializes the simulation with user inputs.
-void Simulation::initialize()
+// Initializes the simulation with user inputs; false if they cannot be used.
+bool Simulation::initialize()
 {
+    ScopedRandomGenerator bindRng(sim_rng);
     std::cout << "Welcome to the Cellular Automata Ecosystem Simulation!\n";
     std::cout << "This simulation attempts to model a natural environment with plants, herbivores, and carnivores.\n";
     std::cout << "It is intended for research and educational purposes to observe population dynamics.\n\n";
     std::cout << "You will be asked to input specifications for the simulation.\n";
-    std::cout << "The simulation will then output a " << GRID_WIDTH * GRID_HEIGHT << "-cell grid (representing a "
-              << GRID_WIDTH * GRID_HEIGHT << " sq km map) each month.\n";
+    std::cout << "The simulation will then output a " << sim_grid.getWidth() * sim_grid.getHeight() << "-cell grid (representing a "
+              << sim_grid.getWidth() * sim_grid.getHeight() << " sq km map) each month.\n";
     std::cout << "Monthly statistics and notable events will also be reported.\n\n";
     std::cout << "Simulation Rules:\n";
-    std::cout << "- The total population of plants, herbivores, and carnivores cannot exceed " << MAX_POPULATION << ".\n";
+    std::cout << "- The total population of plants, herbivores, and carnivores cannot exceed " << sim_grid.getMaxPopulation() << ".\n";
     std::cout << "- Maximum simulation duration is " << MAX_SIMULATION_YEARS << " years.\n\n";
     std::cout << "Grid Key:\n";
     std::cout << "  P: Plant\n";
@@ -101,35 +348,43 @@ void Simulation::initialize()
     totalMonthsDuration = years * 12;
 
     std::cout << "\nEnter initial populations:\n";
-    int numP = getValidIntInput("Number of Plants (Ideal: 230-280): ", 0, MAX_POPULATION);
-    int numH = getValidIntInput("Number of Herbivores (Ideal: 90-140): ", 0, MAX_POPULATION);
-    int numC = getValidIntInput("Number of Carnivores (Ideal: 5-20): ", 0, MAX_POPULATION);
+    const int maxPopulation = sim_grid.getMaxPopulation();
+    int numP = getValidIntInput("Number of Plants (Ideal: 230-280): ", 0, maxPopulation);
+    int numH = getValidIntInput("Number of Herbivores (Ideal: 90-140): ", 0, maxPopulation);
+    int numC = getValidIntInput("Number of Carnivores (Ideal: 5-20): ", 0, maxPopulation);
     
-    if (numP + numH + numC > MAX_POPULATION) {
+    if (numP + numH + numC > maxPopulation) {
         std::cout << "Error: Total initial population (" << (numP + numH + numC)
-                  << ") exceeds the maximum allowed (" << MAX_POPULATION << "). Exiting.\n";
-        exit(1); 
+                  << ") exceeds the maximum allowed (" << maxPopulation << "). Exiting.\n";
+        return false;
     }
 
+    populate(numP, numH, numC);
+    return true;
+}
+
+// Places the initial plants, herbivores and carnivores at random empty cells.
+void Simulation::populate(int numP, int numH, int numC)
+{
     auto place = [&](EntityType type_val, int count) {
         for (int i = 0; i < count; ++i) {
             int r_coord, c_coord, attempts = 0;
             do {
-                r_coord = getRandomInt(0, GRID_HEIGHT - 1);
-                c_coord = getRandomInt(0, GRID_WIDTH - 1);
+                r_coord = getRandomInt(sim_grid.getOwnedRowBegin(), sim_grid.getOwnedRowEnd() - 1);
+                c_coord = getRandomInt(0, sim_grid.getWidth() - 1);
                 attempts++;
-            } while (!sim_grid.isEmpty(r_coord, c_coord) && attempts < GRID_WIDTH * GRID_HEIGHT * 2);
+            } while (!sim_grid.isEmpty(r_coord, c_coord) && attempts < sim_grid.getOwnedCellCount() * 2);
             
             if (sim_grid.isEmpty(r_coord, c_coord)) {
                 std::shared_ptr<Entity> newEntity = nullptr;
                 Gender g = (getRandomInt(0, 1) == 0) ? Gender::MALE : Gender::FEMALE;
-                if (type_val == EntityType::PLANT) newEntity = std::make_shared<Plant>(r_coord, c_coord);
-                else if (type_val == EntityType::HERBIVORE) newEntity = std::make_shared<Herbivore>(r_coord, c_coord, g);
-                else if (type_val == EntityType::CARNIVORE) newEntity = std::make_shared<Carnivore>(r_coord, c_coord, g);
+                if (type_val == EntityType::PLANT) newEntity = std::make_shared<Plant>(r_coord, c_coord, plantParams);
+                else if (type_val == EntityType::HERBIVORE) newEntity = std::make_shared<Herbivore>(r_coord, c_coord, g, herbivoreParams);
+                else if (type_val == EntityType::CARNIVORE) newEntity = std::make_shared<Carnivore>(r_coord, c_coord, g, carnivoreParams);
                 
                 if (newEntity) sim_grid.addEntity(newEntity);
             } else {
-                std::cout << "Warning: Could not place all initial entities due to lack of space.\n";
+                if (outputStream) *outputStream << "Warning: Could not place all initial entities due to lack of space.\n";
                 break;
             }
         }
@@ -151,17 +406,17 @@ void Simulation::handleMigration()
             EntityType type_val = (getRandomInt(0, 1) == 0) ? EntityType::HERBIVORE : EntityType::CARNIVORE;
             Gender g = (getRandomInt(0, 1) == 0) ? Gender::MALE : Gender::FEMALE;
             if (type_val == EntityType::HERBIVORE)
-                newAnimal = std::make_shared<Herbivore>(0, 0, g); 
+                newAnimal = std::make_shared<Herbivore>(0, 0, g, herbivoreParams); 
             else
-                newAnimal = std::make_shared<Carnivore>(0, 0, g); 
+                newAnimal = std::make_shared<Carnivore>(0, 0, g, carnivoreParams); 
 
             if (sim_grid.addMigratingAnimal(newAnimal))
             {
                 actualImmigrated++;
-                sim_stats.addMonthlyEvent(newAnimal->getSpeciesName() + " immigrated to (" + std::to_string(newAnimal->getR()) + "," + std::to_string(newAnimal->getC()) + ").");
+                ECOSIM_RECORD_EVENT(sim_shard, EventKind::IMMIGRATED, newAnimal->getType(), newAnimal->getR(), newAnimal->getC(), newAnimal->getId());
             }
         }
-        if(actualImmigrated > 0) sim_stats.incrementAnimalsImmigrated(); // Only increment if any actually immigrated
+        if(actualImmigrated > 0) sim_shard.incrementAnimalsImmigrated(); // Only increment if any actually immigrated
     }
     else if (current_Season_sim == Season::AUTUMN)
     {
@@ -176,8 +431,8 @@ void Simulation::handleMigration()
         }
         for(const auto& herbivoreToRemove : temp_herbivores_to_emigrate) {
             if(herbivoreToRemove->isAlive()){ // Double check if still alive
-                sim_stats.addMonthlyEvent("Herbivore at (" + std::to_string(herbivoreToRemove->getR()) + "," + std::to_string(herbivoreToRemove->getC()) + ") emigrated.");
-                sim_grid.removeEntity(herbivoreToRemove, sim_stats);
+                ECOSIM_RECORD_EVENT(sim_shard, EventKind::EMIGRATED, EntityType::HERBIVORE, herbivoreToRemove->getR(), herbivoreToRemove->getC(), herbivoreToRemove->getId());
+                sim_grid.removeEntity(herbivoreToRemove, sim_shard);
                 actualEmigrated++;
             }
         }
@@ -190,35 +445,96 @@ void Simulation::handleMigration()
         }
         for(const auto& carnivoreToRemove : temp_carnivores_to_emigrate) {
             if(carnivoreToRemove->isAlive()){
-                sim_stats.addMonthlyEvent("Carnivore at (" + std::to_string(carnivoreToRemove->getR()) + "," + std::to_string(carnivoreToRemove->getC()) + ") emigrated.");
-                sim_grid.removeEntity(carnivoreToRemove, sim_stats);
+                ECOSIM_RECORD_EVENT(sim_shard, EventKind::EMIGRATED, EntityType::CARNIVORE, carnivoreToRemove->getR(), carnivoreToRemove->getC(), carnivoreToRemove->getId());
+                sim_grid.removeEntity(carnivoreToRemove, sim_shard);
                 actualEmigrated++;
             }
         }
-        if(actualEmigrated > 0) sim_stats.incrementAnimalsEmigrated(); // Corrected to actualEmigrated and incrementAnimalsEmigrated
+        if(actualEmigrated > 0) sim_shard.incrementAnimalsEmigrated(); // Corrected to actualEmigrated and incrementAnimalsEmigrated
     }
 }
 
 // Runs one month of the simulation.
 void Simulation::runMonth()
 {
+    ScopedRandomGenerator bindRng(sim_rng);
+    ScopedTraceRecorder bindTrace(traceRecorder.get());
+    if (traceRecorder)
+        traceRecorder->nameThread("Simulation");
+    ECOSIM_PHASE_TIMING(phaseTimer.beginMonth(currentMonthCounter + 1));
+    const bool countAllocations = reportsMemory() && allocationCountingEnabled();
+    const unsigned long long allocationsAtStart = countAllocations ? heapAllocationCount() : 0;
     currentMonthCounter++; 
     sim_stats.reset();
+    sim_shard.clear();
+    sim_shard.setMonth(currentMonthCounter);
     determineSeason(); 
-    std::cout << "\n--- Month: " << sim_stats.getCurrentMonthName() << " " << (currentMonthCounter -1 ) / 12 + 1 << " (Season: " << sim_stats.getCurrentSeasonName() << ") ---\n";
-
-    auto plants_copy = sim_grid.getPlants(); // Use getter
+    std::string monthHeader = "\n--- Month: " + sim_stats.getCurrentMonthName() + " " + std::to_string((currentMonthCounter - 1) / 12 + 1) +
+                              " (Season: " + sim_stats.getCurrentSeasonName() + ") ---\n";
+    if (outputStream && !outputPipeline && !ansiRenderer)
+        *outputStream << monthHeader; // In place, the banner goes below the grid instead
+    ECOSIM_PHASE_TIMING(phaseTimer.lap(SimPhase::SETUP));
+
+    // In a subdomain, the halo is refreshed and border crossers handed off before every phase.
+    if (domainExchange)
+        domainExchange->beforePhase(sim_grid, sim_shard);
+    ECOSIM_PHASE_TIMING(phaseTimer.lap(SimPhase::EXCHANGE));
+    // Synchronous mode: all three phases read the cells as they are now; their moves and births only show there next month.
+    if (synchronousUpdate)
+        sim_grid.beginSynchronousMonth();
     auto herbivores_copy = sim_grid.getHerbivores(); // Use getter
     auto carnivores_copy = sim_grid.getCarnivores(); // Use getter
+    ECOSIM_PHASE_TIMING(phaseTimer.lap(SimPhase::SETUP));
 
-    for (const auto &c_ptr : carnivores_copy)
-        if (c_ptr->isAlive()) c_ptr->update(sim_grid, sim_stats, current_Season_sim);
-    for (const auto &h_ptr : herbivores_copy)
-        if (h_ptr->isAlive()) h_ptr->update(sim_grid, sim_stats, current_Season_sim);
-    for (const auto &p_ptr : plants_copy)
-        if (p_ptr->isAlive()) p_ptr->update(sim_grid, sim_stats, current_Season_sim);
+    if (intentMovement)
+    {
+        IntentMovePhase movePhase;
+        movePhase.run(sim_grid, sim_shard, current_Season_sim, *workerPool,
+                      std::vector<std::shared_ptr<Animal>>(carnivores_copy.begin(), carnivores_copy.end()), currentMonthCounter, sim_rng());
+        ECOSIM_PHASE_TIMING(phaseTimer.lap(SimPhase::CARNIVORES, carnivores_copy.size()));
+        if (domainExchange)
+        {
+            domainExchange->beforePhase(sim_grid, sim_shard);
+            herbivores_copy = sim_grid.getHerbivores();
+        }
+        ECOSIM_PHASE_TIMING(phaseTimer.lap(SimPhase::EXCHANGE));
+        movePhase.run(sim_grid, sim_shard, current_Season_sim, *workerPool,
+                      std::vector<std::shared_ptr<Animal>>(herbivores_copy.begin(), herbivores_copy.end()), currentMonthCounter, sim_rng());
+    }
+    else
+    {
+        for (const auto &c_ptr : carnivores_copy)
+            if (c_ptr->isAlive()) c_ptr->update(sim_grid, sim_shard, current_Season_sim);
+        ECOSIM_PHASE_TIMING(phaseTimer.lap(SimPhase::CARNIVORES, carnivores_copy.size()));
+        if (domainExchange)
+        {
+            domainExchange->beforePhase(sim_grid, sim_shard);
+            herbivores_copy = sim_grid.getHerbivores();
+        }
+        ECOSIM_PHASE_TIMING(phaseTimer.lap(SimPhase::EXCHANGE));
+        for (const auto &h_ptr : herbivores_copy)
+            if (h_ptr->isAlive()) h_ptr->update(sim_grid, sim_shard, current_Season_sim);
+    }
+    ECOSIM_PHASE_TIMING(phaseTimer.lap(SimPhase::HERBIVORES, herbivores_copy.size()));
+    if (domainExchange)
+        domainExchange->beforePhase(sim_grid, sim_shard);
+    ECOSIM_PHASE_TIMING(phaseTimer.lap(SimPhase::EXCHANGE));
+    ECOSIM_PHASE_TIMING(const size_t plantsAtStart = sim_grid.getPlants().size());
+    if (parallelPlantUpdate)
+        ParallelPlantPhase(plantTileSize).run(sim_grid, sim_shard, current_Season_sim, *workerPool, sim_rng());
+    else
+    {
+        auto plants_copy = sim_grid.getPlants(); // Use getter
+        for (const auto &p_ptr : plants_copy)
+            if (p_ptr->isAlive()) p_ptr->update(sim_grid, sim_shard, current_Season_sim);
+    }
+    ECOSIM_PHASE_TIMING(phaseTimer.lap(SimPhase::PLANTS, plantsAtStart));
     
-    handleMigration();
+    if (synchronousUpdate)
+        sim_grid.endSynchronousMonth();
+    if (!domainExchange || domainExchange->runsMigration(currentMonthCounter))
+        handleMigration();
+    ECOSIM_PHASE_TIMING(phaseTimer.lap(SimPhase::MIGRATION));
 
     // Re-fetch live lists from grid for cleanup, as update calls might have changed them
     // The Grid's removeEntity already handles list removal, but this ensures consistency.
@@ -244,23 +560,74 @@ void Simulation::runMonth()
             // ensure it's cleared from the grid cells map and then from specialized lists by removeEntity.
             // removeEntity handles the removal from both grid.cells and specialized lists.
             // Calling it again is safe if it's already removed.
-            sim_grid.removeEntity(e_ptr, sim_stats);
+            sim_grid.removeEntity(e_ptr, sim_shard);
         }
     }
 
 
+    sim_stats.mergeShard(sim_shard); // The month's counters and events, in update order
+    ECOSIM_PHASE_TIMING(phaseTimer.lap(SimPhase::CLEANUP));
+
+    // Settle the last phase's border crossers so every entity is counted by exactly one subdomain.
+    if (domainExchange)
+        domainExchange->beforePhase(sim_grid, sim_shard);
+    ECOSIM_PHASE_TIMING(phaseTimer.lap(SimPhase::EXCHANGE));
+
     sim_stats.setCurrentPlants(sim_grid.getPlants().size());
     sim_stats.setCurrentHerbivores(sim_grid.getHerbivores().size());
     sim_stats.setCurrentCarnivores(sim_grid.getCarnivores().size());
+    sim_history.append(sim_stats, current_Season_sim);
+    if (traceRecorder)
+        recordTraceCounters();
+    ECOSIM_PHASE_TIMING(phaseTimer.lap(SimPhase::CLEANUP));
 
-    sim_grid.display();
-    sim_stats.display();
+    if (outputPipeline)
+    {
+        // Only a copy of the symbols and stats leaves this thread; printing happens in the background.
+        MonthSnapshot snapshot;
+        snapshot.header = std::move(monthHeader);
+        snapshot.firstRow = sim_grid.getOwnedRowBegin();
+        snapshot.width = sim_grid.getWidth();
+        snapshot.cellSymbols = sim_grid.symbolSnapshot();
+        snapshot.stats = sim_stats;
+        outputPipeline->submit(std::move(snapshot));
+    }
+    else if (outputStream)
+    {
+        if (ansiRenderer)
+        {
+            ansiRenderer->render(*outputStream, sim_grid);
+            *outputStream << monthHeader;
+        }
+        else
+            sim_grid.display(*outputStream);
+        sim_stats.display(*outputStream);
+    }
+    for (StatsSink *sink : statsSinks)
+        sink->onMonth(currentMonthCounter, current_Season_sim, sim_stats, sink->wantsGrid() ? &sim_grid : nullptr);
+    if (heatmaps && ++heatmapMonths == 12)
+        flushHeatmaps();
+    if (snapshotInterval > 0 && currentMonthCounter % snapshotInterval == 0)
+    {
+        std::string error;
+        if (!WorldSnapshot::write(sim_grid, currentMonthCounter,
+                                  snapshotDirectory + "/world_month" + std::to_string(currentMonthCounter) + ".ecosnap", error))
+            snapshotError = error;
+    }
+    ECOSIM_PHASE_TIMING(phaseTimer.lap(SimPhase::DISPLAY));
+    ECOSIM_PHASE_TIMING(phaseTimer.endMonth());
+    if (countAllocations)
+        monthlyAllocations.push_back(heapAllocationCount() - allocationsAtStart);
 
     bool allAnimalsDead = sim_grid.getHerbivores().empty() && sim_grid.getCarnivores().empty();
     bool plantsGone = sim_grid.getPlants().empty() && (sim_stats.getCurrentHerbivores() > 0 || sim_stats.getCurrentCarnivores() > 0) ;
     bool herbivoresGone = sim_grid.getHerbivores().empty() && sim_stats.getCurrentCarnivores() > 0;
 
-    if (currentMonthCounter > 1) { 
+    if (domainExchange) {
+        // Populations of a single stripe say nothing about the world; the coordinator decides.
+        if (!domainExchange->finishMonth(sim_stats, simulationEndReason))
+            currentMonthCounter = totalMonthsDuration + 1;
+    } else if (currentMonthCounter > 1) { 
         if (allAnimalsDead) {
             simulationEndReason = "All animals have died.";
             currentMonthCounter = totalMonthsDuration + 1; 
@@ -277,7 +644,15 @@ void Simulation::runMonth()
         }
     }
 
-    if (currentMonthCounter <= totalMonthsDuration) { 
+    if (checkpointInterval > 0 && hasMonthsRemaining() && currentMonthCounter % checkpointInterval == 0)
+    {
+        std::string error;
+        if (!saveCheckpoint(checkpointFile, error))
+            checkpointError = error;
+    }
+
+    if (interactivePrompts && currentMonthCounter <= totalMonthsDuration) { 
+        flushOutput();
         std::cout << "Press Enter to continue to the next month (or Q to quit)...";
         char q_input_char = std::cin.get();
         if (std::cin.eof()){ // Handle EOF / Ctrl+D
@@ -295,10 +670,9 @@ void Simulation::runMonth()
     }
 }
 
-// Starts and manages the simulation loop.
-void Simulation::start()
+// Shows the grid and population before the first month.
+void Simulation::showInitialState()
 {
-    initialize();      
     determineSeason();  
     sim_stats.setCurrentMonthName("Initial Setup"); 
     sim_stats.setCurrentSeasonName(getSeasonName(current_Season_sim));
@@ -306,17 +680,93 @@ void Simulation::start()
     sim_stats.setCurrentHerbivores(sim_grid.getHerbivores().size());
     sim_stats.setCurrentCarnivores(sim_grid.getCarnivores().size());
     
-    sim_grid.display();
-    std::cout << "\n--- Initial State ---\nSeason: " << sim_stats.getCurrentSeasonName()
-              << "\nInitial Plants: " << sim_stats.getCurrentPlants()
-              << "\nInitial Herbivores: " << sim_stats.getCurrentHerbivores()
-              << "\nInitial Carnivores: " << sim_stats.getCurrentCarnivores()
-              << "\nPress Enter to start simulation...";
+    if (!outputStream)
+        return;
+    flushOutput();
+    if (ansiRenderer)
+        ansiRenderer->render(*outputStream, sim_grid);
+    else
+        sim_grid.display(*outputStream);
+    *outputStream << "\n--- Initial State ---\nSeason: " << sim_stats.getCurrentSeasonName()
+                  << "\nInitial Plants: " << sim_stats.getCurrentPlants()
+                  << "\nInitial Herbivores: " << sim_stats.getCurrentHerbivores()
+                  << "\nInitial Carnivores: " << sim_stats.getCurrentCarnivores() << "\n";
+}
+
+// Reports why and when the simulation ended.
+void Simulation::reportEnd()
+{
+    for (StatsSink *sink : statsSinks)
+        sink->finish();
+    if (traceRecorder && !writeTraceFile())
+        traceError = "Could not write the trace to " + traceFile + ".";
+    if (heatmaps && heatmapMonths > 0)
+        flushHeatmaps(); // The part of the last year that ran
+    if (!memoryReportFile.empty())
+    {
+        std::ofstream memoryOut(memoryReportFile);
+        getMemoryReport().writeJson(memoryOut);
+        if (!memoryOut)
+            memoryReportError = "Could not write the memory report to " + memoryReportFile + ".";
+    }
+    if (!outputStream)
+        return;
+    flushOutput();
+    if (ansiRenderer)
+        ansiRenderer->finish(*outputStream);
+    int finalMonthCount = std::min(currentMonthCounter -1, totalMonthsDuration); 
+    if (finalMonthCount < 0 && currentMonthCounter == 0) finalMonthCount = 0; // If user quits at initial prompt
+    else if (finalMonthCount < 0) finalMonthCount = 0;
+
+
+    if (!simulationEndReason.empty()) {
+        *outputStream << "\nSimulation ended after " << finalMonthCount << " completed months.\n";
+        *outputStream << "Reason: " << simulationEndReason << "\n";
+    } else {
+        *outputStream << "\nSimulation for " << totalMonthsDuration / 12 << " years (" << totalMonthsDuration << " months) finished.\n";
+    }
+    if (workerPool->getThreadCount() > 1)
+        workerPool->reportWorkerStats(*outputStream);
+    if (phaseTimer.isEnabled())
+        phaseTimer.report(*outputStream);
+    if (traceRecorder && traceError.empty())
+        *outputStream << "\nTrace of " << traceRecorder->getEventCount() << " events written to " << traceFile << ".\n";
+    else if (traceRecorder)
+        *outputStream << "\n" << traceError << "\n";
+    if (!heatmapError.empty())
+        *outputStream << "\nHeatmaps: " << heatmapError << "\n";
+    if (!checkpointError.empty())
+        *outputStream << "\nCheckpoint: " << checkpointError << "\n";
+    if (!snapshotError.empty())
+        *outputStream << "\nSnapshot: " << snapshotError << "\n";
+    if (printMemoryReport)
+        getMemoryReport().print(*outputStream);
+    if (!memoryReportFile.empty() && memoryReportError.empty())
+        *outputStream << "\nMemory report written to " << memoryReportFile << ".\n";
+    else if (!memoryReportFile.empty())
+        *outputStream << "\n" << memoryReportError << "\n";
+    if (numaPlacement)
+    {
+        *outputStream << "\nNUMA placement moved " << pagesPlaced << " pages at the start.";
+        NumaPlacement::report(NumaPlacement::survey(sim_grid), *outputStream);
+    }
+    if (outputPipeline && outputPipeline->getFramesDropped() > 0)
+        *outputStream << "Background output: " << outputPipeline->getFramesWritten() << " months printed, "
+                      << outputPipeline->getFramesDropped() << " dropped while the output fell behind.\n";
+}
+
+// Starts and manages the simulation loop; false if the setup entered could not be used.
+bool Simulation::start()
+{
+    if (!initialize())
+        return false;
+    showInitialState();
+    std::cout << "Press Enter to start simulation...";
     
     char start_char = std::cin.get();
     if(std::cin.eof()){
         std::cout << "\nEOF detected. Exiting simulation setup." << std::endl;
-        return;
+        return true;
     }
     if (start_char != '\n') { // Clear buffer if user typed something then enter
         std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
@@ -327,16 +777,221 @@ void Simulation::start()
     {
         runMonth(); 
     }
+    reportEnd();
+    return true;
+}
 
-    int finalMonthCount = std::min(currentMonthCounter -1, totalMonthsDuration); 
-    if (finalMonthCount < 0 && currentMonthCounter == 0) finalMonthCount = 0; // If user quits at initial prompt
-    else if (finalMonthCount < 0) finalMonthCount = 0;
+// Runs every remaining month without prompts.
+void Simulation::runToCompletion()
+{
+    if (currentMonthCounter == 0)
+        showInitialState();
+    while (hasMonthsRemaining())
+        runMonth();
+    reportEnd();
+}
 
+// Checks whether the simulation still has months left to run.
+bool Simulation::hasMonthsRemaining() const { return currentMonthCounter < totalMonthsDuration; }
 
-    if (!simulationEndReason.empty()) {
-        std::cout << "\nSimulation ended after " << finalMonthCount << " completed months.\n";
-        std::cout << "Reason: " << simulationEndReason << "\n";
-    } else {
-        std::cout << "\nSimulation for " << totalMonthsDuration / 12 << " years (" << totalMonthsDuration << " months) finished.\n";
+// Captures the grid, counters, generator and statistics history between months.
+SimulationCheckpoint Simulation::makeCheckpoint() const
+{
+    SimulationCheckpoint checkpoint;
+    checkpoint.gridHeight = sim_grid.getHeight();
+    checkpoint.gridWidth = sim_grid.getWidth();
+    checkpoint.nextEntityId = sim_grid.getNextEntityId();
+    checkpoint.entityIdStride = sim_grid.getEntityIdStride();
+    checkpoint.totalMonths = totalMonthsDuration;
+    checkpoint.monthsRun = currentMonthCounter;
+    checkpoint.monthIndexInYear = currentMonthIndexInYear;
+    checkpoint.season = current_Season_sim;
+    checkpoint.northernHemisphere = isNorthernHemisphereSelected;
+    checkpoint.carnivoresStarvedPreviousMonth = carnivoresStarvedPreviousMonth;
+    checkpoint.endReason = simulationEndReason;
+    std::stringstream generatorText;
+    generatorText << sim_rng;
+    for (std::uint32_t word; generatorText >> word;)
+        checkpoint.generatorState.push_back(word);
+    checkpoint.herbivoreParams = herbivoreParams;
+    checkpoint.carnivoreParams = carnivoreParams;
+    checkpoint.plantParams = plantParams;
+    // Animals may stand on plants that are still listed, and the dead may stay in their cells
+    // until something moves onto them; both change later months, so both are saved.
+    std::unordered_set<const Entity *> listed;
+    auto saveListed = [&](const std::shared_ptr<Entity> &entity) {
+        listed.insert(entity.get());
+        const bool inCell = sim_grid.getEntity(entity->getR(), entity->getC()) == entity;
+        checkpoint.entities.push_back({makeEntityRecord(*entity), true, inCell});
+    };
+    for (const auto &p : sim_grid.getPlants()) saveListed(p);
+    for (const auto &h : sim_grid.getHerbivores()) saveListed(h);
+    for (const auto &c : sim_grid.getCarnivores()) saveListed(c);
+    for (int r = 0; r < sim_grid.getHeight(); ++r)
+        for (int c = 0; c < sim_grid.getWidth(); ++c)
+        {
+            std::shared_ptr<Entity> occupant = sim_grid.getEntity(r, c);
+            if (occupant && listed.count(occupant.get()) == 0)
+                checkpoint.entities.push_back({makeEntityRecord(*occupant), false, true});
+        }
+    checkpoint.history = sim_history;
+    return checkpoint;
+}
+
+// Carries on from a checkpoint; on failure error explains why and nothing is changed.
+bool Simulation::restoreCheckpoint(const SimulationCheckpoint &checkpoint, std::string &error)
+{
+    if (domainExchange || sim_grid.getOwnedRowBegin() != 0 || sim_grid.getOwnedRowEnd() != sim_grid.getHeight())
+    {
+        error = "A checkpoint holds a whole world; a subdomain cannot restore one.";
+        return false;
+    }
+    std::mt19937 rng;
+    std::stringstream generatorText;
+    for (std::uint32_t word : checkpoint.generatorState)
+        generatorText << word << ' ';
+    if (!(generatorText >> rng))
+    {
+        error = "The checkpoint's generator state is not one this build can read.";
+        return false;
+    }
+
+    // Every entity goes back into its list in the order it was saved, so updates run in the same order.
+    Grid grid(checkpoint.gridHeight, checkpoint.gridWidth);
+    grid.setEntityIdSequence(checkpoint.nextEntityId, checkpoint.entityIdStride);
+    for (const CheckpointEntity &saved : checkpoint.entities)
+    {
+        const EntityRecord &record = saved.record;
+        std::shared_ptr<Entity> entity = rebuildEntity(record);
+        if (entity && !saved.listed)
+            entity->kill();
+        if (!entity || record.id == 0 || !grid.restoreEntity(entity, saved.listed, saved.inCell))
+        {
+            error = "Checkpoint entity " + std::to_string(record.id) + " at (" + std::to_string(record.r) + ", " +
+                    std::to_string(record.c) + ") is off the grid or on an occupied cell.";
+            return false;
+        }
     }
+
+    flushOutput();
+    sim_grid = std::move(grid);
+    sim_rng = rng;
+    totalMonthsDuration = checkpoint.totalMonths;
+    currentMonthCounter = checkpoint.monthsRun;
+    currentMonthIndexInYear = checkpoint.monthIndexInYear;
+    current_Season_sim = checkpoint.season;
+    isNorthernHemisphereSelected = checkpoint.northernHemisphere;
+    carnivoresStarvedPreviousMonth = checkpoint.carnivoresStarvedPreviousMonth;
+    simulationEndReason = checkpoint.endReason;
+    herbivoreParams = checkpoint.herbivoreParams;
+    carnivoreParams = checkpoint.carnivoreParams;
+    plantParams = checkpoint.plantParams;
+    sim_history = checkpoint.history;
+    sim_history.reserve(totalMonthsDuration);
+
+    sim_stats.reset();
+    sim_stats.setCurrentMonthName(month_Names_sim[currentMonthIndexInYear]);
+    sim_stats.setCurrentSeasonName(getSeasonName(current_Season_sim));
+    sim_stats.setCurrentPlants(sim_grid.getPlants().size());
+    sim_stats.setCurrentHerbivores(sim_grid.getHerbivores().size());
+    sim_stats.setCurrentCarnivores(sim_grid.getCarnivores().size());
+    // Heatmaps count from here on, in the year the checkpoint was taken (its earlier months are not saved).
+    if (heatmaps)
+    {
+        heatmaps.reset();
+        setHeatmaps(heatmapDirectory, heatmapFormat);
+    }
+    heatmapMonths = currentMonthCounter % 12;
+    heatmapYear = currentMonthCounter / 12 + 1;
+    if (numaPlacement)
+        setNumaPlacement(true);
+    return true;
+}
+
+// Writes makeCheckpoint() to a temporary file and renames it over path, so a run killed
+// while writing leaves the previous checkpoint intact.
+bool Simulation::saveCheckpoint(const std::string &path, std::string &error) const
+{
+    const std::string partialPath = path + ".tmp";
+    {
+        std::ofstream out(partialPath, std::ios::binary);
+        if (!out || !makeCheckpoint().writeBinary(out) || !out.flush())
+        {
+            error = "Could not write the checkpoint to " + partialPath + ".";
+            std::remove(partialPath.c_str());
+            return false;
+        }
+    }
+    if (std::rename(partialPath.c_str(), path.c_str()) != 0)
+    {
+        error = "Could not move the checkpoint to " + path + ".";
+        std::remove(partialPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+// Reads a checkpoint file and restores it; on failure error explains why.
+bool Simulation::loadCheckpoint(const std::string &path, std::string &error)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+    {
+        error = "Could not open checkpoint " + path + ".";
+        return false;
+    }
+    SimulationCheckpoint checkpoint;
+    if (!checkpoint.readBinary(in, error) || !restoreCheckpoint(checkpoint, error))
+    {
+        error = path + ": " + error;
+        return false;
+    }
+    return true;
+}
+
+// Getters
+// Gets the number of months run so far.
+int Simulation::getCurrentMonthCounter() const { return currentMonthCounter; }
+// Gets the simulation grid.
+const Grid& Simulation::getGrid() const { return sim_grid; }
+// Gets the statistics of the most recent month.
+const MonthlyStats& Simulation::getStats() const { return sim_stats; }
+const StatsHistory& Simulation::getHistory() const { return sim_history; }
+const PhaseTimer& Simulation::getPhaseTimer() const { return phaseTimer; }
+
+// Gets where the simulation's memory goes right now.
+MemoryReport Simulation::getMemoryReport() const
+{
+    MemoryReport report;
+    report.gridCells = static_cast<long long>(sim_grid.getOwnedCellCount());
+    report.species[0] = {"Plants", sim_grid.getPlants().size(), sharedEntityBytes(EntityType::PLANT)};
+    report.species[1] = {"Herbivores", sim_grid.getHerbivores().size(), sharedEntityBytes(EntityType::HERBIVORE)};
+    report.species[2] = {"Carnivores", sim_grid.getCarnivores().size(), sharedEntityBytes(EntityType::CARNIVORE)};
+    report.cellStorageBytes = sim_grid.getCellStorageBytes();
+    report.listStorageBytes = sim_grid.getListStorageBytes();
+    report.eventStorageBytes = sim_shard.getMonthlyEvents().getStorageBytes() + sim_stats.getMonthlyEvents().getStorageBytes();
+    report.historyStorageBytes = sim_history.getStorageBytes();
+    report.peakRssBytes = peakResidentBytes();
+    report.allocationsCounted = allocationCountingEnabled();
+    report.monthlyAllocations = monthlyAllocations;
+    return report;
+}
+// Gets the reason the simulation stopped early (empty if it ran its full length).
+const std::string& Simulation::getEndReason() const { return simulationEndReason; }
+
+// Gets why files the run writes could not be written, one message each; empty when every write succeeded.
+std::vector<std::string> Simulation::getWriteErrors() const
+{
+    std::vector<std::string> errors;
+    if (!traceError.empty())
+        errors.push_back(traceError);
+    if (!heatmapError.empty())
+        errors.push_back("Heatmaps: " + heatmapError);
+    if (!checkpointError.empty())
+        errors.push_back("Checkpoint: " + checkpointError);
+    if (!snapshotError.empty())
+        errors.push_back("Snapshot: " + snapshotError);
+    if (!memoryReportError.empty())
+        errors.push_back(memoryReportError);
+    return errors;
 }
\ No newline at end of file
@@ -0,0 +1,388 @@
+// simulationConfig.cpp
+#include "../headers/simulationConfig.hpp"
+
+#include <cstdlib>
+#include <cerrno>
+#include <climits>
+#include <fstream>
+#include <utility>
+
+// Parses a whole string as an int; false if it is not one.
+static bool parseInt(const std::string &text, int &result)
+{
+    if (text.empty())
+        return false;
+    char *end = nullptr;
+    errno = 0;
+    long value = std::strtol(text.c_str(), &end, 10);
+    if (errno != 0 || *end != '\0' || value < INT_MIN || value > INT_MAX)
+        return false;
+    result = static_cast<int>(value);
+    return true;
+}
+
+// Parses a whole string as a double; false if it is not one.
+static bool parseDouble(const std::string &text, double &result)
+{
+    if (text.empty())
+        return false;
+    char *end = nullptr;
+    errno = 0;
+    result = std::strtod(text.c_str(), &end);
+    return errno == 0 && *end == '\0';
+}
+
+// Parses on/off style booleans.
+static bool parseBool(const std::string &text, bool &result)
+{
+    if (text == "1" || text == "true" || text == "yes" || text == "on") { result = true; return true; }
+    if (text == "0" || text == "false" || text == "no" || text == "off") { result = false; return true; }
+    return false;
+}
+
+// Sets one species parameter ("herbivore.maxAge", "plant.spreadChance", ...).
+static bool applySpeciesOption(SimulationConfig &config, const std::string &name, const std::string &value, std::string &error)
+{
+    size_t dot = name.find('.');
+    std::string species = name.substr(0, dot), field = name.substr(dot + 1);
+
+    if (species == "plant")
+    {
+        int *target = nullptr;
+        if (field == "spreadChance") target = &config.plantParams.spreadChance;
+        else if (field == "maxAge") target = &config.plantParams.maxAge;
+        else if (field == "winterDeathChance") target = &config.plantParams.winterDeathChance;
+        else if (field == "autumnDeathChance") target = &config.plantParams.autumnDeathChance;
+        if (!target)
+        {
+            error = "Unknown plant parameter '" + field + "'.";
+            return false;
+        }
+        if (!parseInt(value, *target))
+        {
+            error = "Expected an integer for " + name + ", got '" + value + "'.";
+            return false;
+        }
+        return true;
+    }
+
+    AnimalParams *params = nullptr;
+    if (species == "herbivore") params = &config.herbivoreParams;
+    else if (species == "carnivore") params = &config.carnivoreParams;
+    if (!params)
+    {
+        error = "Unknown species '" + species + "'.";
+        return false;
+    }
+    if (field == "size")
+    {
+        if (!parseDouble(value, params->size))
+        {
+            error = "Expected a number for " + name + ", got '" + value + "'.";
+            return false;
+        }
+        return true;
+    }
+    int *target = nullptr;
+    if (field == "maxAge") target = &params->maxAge;
+    else if (field == "maxEnergy") target = &params->maxEnergy;
+    else if (field == "visionRange") target = &params->visionRange;
+    else if (field == "moveCost") target = &params->moveCost;
+    else if (field == "gestationPeriod") target = &params->gestationPeriod;
+    else if (field == "minBreedingAge") target = &params->minBreedingAge;
+    else if (field == "energyToReproduce") target = &params->energyToReproduce;
+    else if (field == "maxTurnsWithoutFood") target = &params->maxTurnsWithoutFood;
+    if (!target)
+    {
+        error = "Unknown " + species + " parameter '" + field + "'.";
+        return false;
+    }
+    if (!parseInt(value, *target))
+    {
+        error = "Expected an integer for " + name + ", got '" + value + "'.";
+        return false;
+    }
+    return true;
+}
+
+// Sets one option by name (e.g. "years", "plants", "herbivore.maxAge"); on failure error explains why.
+bool SimulationConfig::applyOption(const std::string &name, const std::string &value, std::string &error)
+{
+    if (name.find('.') != std::string::npos)
+        return applySpeciesOption(*this, name, value, error);
+
+    if (name == "hemisphere")
+    {
+        if (value == "N" || value == "n") northernHemisphere = true;
+        else if (value == "S" || value == "s") northernHemisphere = false;
+        else
+        {
+            error = "Hemisphere must be N or S, got '" + value + "'.";
+            return false;
+        }
+        return true;
+    }
+    if (name == "parallel-plants" || name == "intent-movement" || name == "synchronous" || name == "drop-output" ||
+        name == "pin-threads" || name == "numa-placement" || name == "phase-timing" ||
+        name == "hardware-counters" || name == "memory-report" || name == "ansi")
+    {
+        bool &target = (name == "parallel-plants") ? parallelPlantUpdate
+                     : (name == "intent-movement") ? intentMovement
+                     : (name == "synchronous") ? synchronousUpdate
+                     : (name == "pin-threads") ? pinThreads
+                     : (name == "numa-placement") ? numaPlacement
+                     : (name == "phase-timing") ? phaseTiming
+                     : (name == "hardware-counters") ? hardwareCounters
+                     : (name == "memory-report") ? memoryReport
+                     : (name == "ansi") ? ansiRendering : dropOutputWhenBehind;
+        if (!parseBool(value, target))
+        {
+            error = "Expected on/off for " + name + ", got '" + value + "'.";
+            return false;
+        }
+        return true;
+    }
+    if (name == "events")
+    {
+        if (!parseEventMask(value, eventMask))
+        {
+            error = "Events must be all, none or a comma-separated list of feeding, births, mating and migration, got '" + value + "'.";
+            return false;
+        }
+        return true;
+    }
+    if (name == "trace" || name == "memory-json" || name == "heatmaps" || name == "checkpoint" || name == "restore" ||
+        name == "snapshots")
+    {
+        (name == "trace" ? traceFile
+         : name == "heatmaps" ? heatmapDirectory
+         : name == "snapshots" ? snapshotDirectory
+         : name == "checkpoint" ? checkpointFile
+         : name == "restore" ? restoreFile : memoryReportFile) = value;
+        return true;
+    }
+    if (name == "heatmap-format")
+    {
+        if (value == "pgm") heatmapFormat = HeatmapFormat::PGM;
+        else if (value == "binary") heatmapFormat = HeatmapFormat::BINARY;
+        else
+        {
+            error = "Heatmap format must be pgm or binary, got '" + value + "'.";
+            return false;
+        }
+        return true;
+    }
+    if (name == "seed")
+    {
+        char *end = nullptr;
+        unsigned long parsed = std::strtoul(value.c_str(), &end, 10);
+        if (value.empty() || *end != '\0')
+        {
+            error = "Expected an unsigned integer for seed, got '" + value + "'.";
+            return false;
+        }
+        seed = static_cast<unsigned int>(parsed);
+        return true;
+    }
+
+    int *target = nullptr;
+    if (name == "years") target = &years;
+    else if (name == "plants") target = &initialPlants;
+    else if (name == "herbivores") target = &initialHerbivores;
+    else if (name == "carnivores") target = &initialCarnivores;
+    else if (name == "height") target = &gridHeight;
+    else if (name == "width") target = &gridWidth;
+    else if (name == "threads") target = &workerThreads;
+    else if (name == "tile-size") target = &plantTileSize;
+    else if (name == "output-queue") target = &outputQueueCapacity;
+    else if (name == "event-capacity") target = &eventCapacity;
+    else if (name == "checkpoint-every") target = &checkpointInterval;
+    else if (name == "snapshot-every") target = &snapshotInterval;
+    if (!target)
+    {
+        error = "Unknown option '" + name + "'.";
+        return false;
+    }
+    if (!parseInt(value, *target))
+    {
+        error = "Expected an integer for " + name + ", got '" + value + "'.";
+        return false;
+    }
+    return true;
+}
+
+// Strips leading and trailing whitespace (including the \r of files with Windows line endings).
+static std::string trim(const std::string &text)
+{
+    const char *space = " \t\r\n";
+    size_t first = text.find_first_not_of(space);
+    if (first == std::string::npos)
+        return "";
+    return text.substr(first, text.find_last_not_of(space) - first + 1);
+}
+
+// Applies every "name = value" line of a file ('#' starts a comment); on failure error names the file and line.
+bool SimulationConfig::loadFile(const std::string &path, std::string &error)
+{
+    std::ifstream in(path);
+    if (!in)
+    {
+        error = "Could not open config file " + path + ".";
+        return false;
+    }
+    std::string line;
+    for (int lineNumber = 1; std::getline(in, line); ++lineNumber)
+    {
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty())
+            continue;
+        size_t equals = line.find('=');
+        std::string name = trim(line.substr(0, equals));
+        if (equals == std::string::npos || name.empty())
+            error = "Expected name = value, got '" + line + "'.";
+        else if (applyOption(name, trim(line.substr(equals + 1)), error))
+            continue;
+        error = path + ":" + std::to_string(lineNumber) + ": " + error;
+        return false;
+    }
+    return true;
+}
+
+// Checks one animal species' parameters; on failure error explains why.
+static bool validateAnimalParams(const std::string &species, const AnimalParams &params, std::string &error)
+{
+    if (params.maxAge < 1 || params.maxEnergy < 1 || params.gestationPeriod < 1 || params.maxTurnsWithoutFood < 0 ||
+        params.visionRange < 0 || params.moveCost < 0 || params.minBreedingAge < 0 || params.energyToReproduce < 0 ||
+        params.size <= 0.0)
+    {
+        error = "Invalid " + species + " parameters (ages, energy and gestation must be positive, costs and ranges non-negative).";
+        return false;
+    }
+    return true;
+}
+
+// Checks that no option writes to one fixed path or restores one saved run, for a config copied into several runs at once.
+bool SimulationConfig::validateForManyRuns(const std::string &runs, std::string &error) const
+{
+    const std::pair<const char *, const std::string *> paths[] = {
+        {"trace", &traceFile}, {"memory-json", &memoryReportFile}, {"heatmaps", &heatmapDirectory},
+        {"checkpoint", &checkpointFile}, {"snapshots", &snapshotDirectory}};
+    for (const auto &path : paths)
+        if (!path.second->empty())
+        {
+            error = std::string("Option ") + path.first + " writes to one path, which " + runs + " would all overwrite.";
+            return false;
+        }
+    if (!restoreFile.empty())
+    {
+        error = "Option restore carries on one saved run, which " + runs + " cannot all continue.";
+        return false;
+    }
+    return true;
+}
+
+// Parses the value of a driver's own count flag as a whole int of at least minimum; on failure error explains why.
+bool SimulationConfig::parseCount(const std::string &flag, const std::string &value, int minimum, int &result, std::string &error)
+{
+    int parsed = 0;
+    if (!parseInt(value, parsed) || parsed < minimum)
+    {
+        error = "Expected an integer of at least " + std::to_string(minimum) + " for " + flag + ", got '" + value + "'.";
+        return false;
+    }
+    result = parsed;
+    return true;
+}
+
+// Checks the values against the simulation limits; on failure error explains why.
+bool SimulationConfig::validate(std::string &error) const
+{
+    if (gridHeight < 1 || gridWidth < 1)
+    {
+        error = "Grid dimensions must be positive.";
+        return false;
+    }
+    if (years < 1 || years > MAX_SIMULATION_YEARS)
+    {
+        error = "Number of years must be between 1 and " + std::to_string(MAX_SIMULATION_YEARS) + ".";
+        return false;
+    }
+    if (initialPlants < 0 || initialHerbivores < 0 || initialCarnivores < 0)
+    {
+        error = "Initial populations cannot be negative.";
+        return false;
+    }
+    long long totalPopulation = static_cast<long long>(initialPlants) + initialHerbivores + initialCarnivores;
+    long long maxPopulation = static_cast<long long>(gridHeight) * gridWidth;
+    if (totalPopulation > maxPopulation)
+    {
+        error = "Total initial population (" + std::to_string(totalPopulation) +
+                ") exceeds the maximum allowed (" + std::to_string(maxPopulation) + ").";
+        return false;
+    }
+    if (workerThreads < 1)
+    {
+        error = "Worker thread count must be at least 1.";
+        return false;
+    }
+    if (plantTileSize < 2)
+    {
+        error = "Plant tile size must be at least 2.";
+        return false;
+    }
+    if (numaPlacement && !pinThreads)
+    {
+        error = "NUMA placement needs pinned worker threads (pin-threads=on).";
+        return false;
+    }
+    if (hardwareCounters && !phaseTiming)
+    {
+        error = "Hardware counters are reported with the phase timings (phase-timing=on).";
+        return false;
+    }
+    if (eventCapacity < 1)
+    {
+        error = "Event capacity must be at least 1.";
+        return false;
+    }
+    if (outputQueueCapacity < 0)
+    {
+        error = "Output queue capacity cannot be negative.";
+        return false;
+    }
+    if (checkpointInterval < 0 || (checkpointInterval > 0 && checkpointFile.empty()))
+    {
+        error = "Checkpoint interval must be non-negative and needs a checkpoint file (checkpoint=path).";
+        return false;
+    }
+    if (!checkpointFile.empty() && checkpointInterval == 0)
+    {
+        error = "A checkpoint file needs a checkpoint interval (checkpoint-every=N).";
+        return false;
+    }
+    if (snapshotInterval < 0 || (snapshotInterval > 0 && snapshotDirectory.empty()))
+    {
+        error = "Snapshot interval must be non-negative and needs a snapshot directory (snapshots=path).";
+        return false;
+    }
+    if (!snapshotDirectory.empty() && snapshotInterval == 0)
+    {
+        error = "A snapshot directory needs a snapshot interval (snapshot-every=N).";
+        return false;
+    }
+    if (!validateAnimalParams("herbivore", herbivoreParams, error) || !validateAnimalParams("carnivore", carnivoreParams, error))
+        return false;
+    const int chances[] = {plantParams.spreadChance, plantParams.winterDeathChance, plantParams.autumnDeathChance};
+    for (int chance : chances)
+        if (chance < 0 || chance > 100)
+        {
+            error = "Plant chances must be percentages between 0 and 100.";
+            return false;
+        }
+    if (plantParams.maxAge < 1)
+    {
+        error = "Plant maximum age must be positive.";
+        return false;
+    }
+    return true;
+}
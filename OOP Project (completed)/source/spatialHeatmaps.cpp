@@ -0,0 +1,93 @@
+// spatialHeatmaps.cpp
+#include "../headers/spatialHeatmaps.hpp"
+
+#include <algorithm>
+#include <fstream>
+
+static const char BINARY_MAGIC[7] = {'E', 'C', 'O', 'H', 'E', 'A', 'T'};
+static const unsigned char BINARY_VERSION = 1;
+
+// Writes a 32-bit value little-endian.
+static void writeUint32(std::ostream &out, std::uint32_t value)
+{
+    unsigned char bytes[4] = {static_cast<unsigned char>(value), static_cast<unsigned char>(value >> 8),
+                              static_cast<unsigned char>(value >> 16), static_cast<unsigned char>(value >> 24)};
+    out.write(reinterpret_cast<const char *>(bytes), 4);
+}
+
+// SpatialHeatmaps constructor for a grid of the given size (all counters zero).
+SpatialHeatmaps::SpatialHeatmaps(int height_val, int width_val)
+    : height(std::max(0, height_val)), width(std::max(0, width_val)),
+      counts(LAYER_COUNT * static_cast<size_t>(height) * width, 0) {}
+
+// Gets the count of one cell.
+std::uint32_t SpatialHeatmaps::getCount(HeatmapLayer layer, int r_coord, int c_coord) const
+{
+    return counts[(static_cast<size_t>(layer) * height + r_coord) * width + c_coord];
+}
+
+// Sets every counter back to zero.
+void SpatialHeatmaps::clear() { std::fill(counts.begin(), counts.end(), 0); }
+
+// Gets the file name stem of a layer.
+const char *SpatialHeatmaps::getLayerName(HeatmapLayer layer)
+{
+    static const char *const names[LAYER_COUNT] = {"births", "died_old_age", "died_starvation", "eaten",
+                                                   "plants_eaten", "herbivore_occupancy", "carnivore_occupancy"};
+    return names[static_cast<size_t>(layer)];
+}
+
+// Writes one layer as a binary PGM image, the busiest cell white and empty cells black.
+bool SpatialHeatmaps::writePgm(std::ostream &out, HeatmapLayer layer) const
+{
+    const size_t cells = static_cast<size_t>(height) * width;
+    auto first = counts.begin() + static_cast<size_t>(layer) * cells;
+    const std::uint32_t peak = cells ? *std::max_element(first, first + cells) : 0;
+    std::vector<unsigned char> pixels(cells);
+    for (size_t i = 0; i < cells; ++i)
+        pixels[i] = peak ? static_cast<unsigned char>((static_cast<unsigned long long>(first[i]) * 255 + peak - 1) / peak) : 0;
+    out << "P5\n# " << getLayerName(layer) << ", white = " << peak << "\n" << width << " " << height << "\n255\n";
+    out.write(reinterpret_cast<const char *>(pixels.data()), static_cast<std::streamsize>(pixels.size()));
+    return static_cast<bool>(out);
+}
+
+// Writes every layer in the binary format; returns false if the stream failed.
+bool SpatialHeatmaps::writeBinary(std::ostream &out) const
+{
+    out.write(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    out.put(static_cast<char>(BINARY_VERSION));
+    writeUint32(out, static_cast<std::uint32_t>(LAYER_COUNT));
+    writeUint32(out, static_cast<std::uint32_t>(height));
+    writeUint32(out, static_cast<std::uint32_t>(width));
+    for (std::uint32_t count : counts)
+        writeUint32(out, count);
+    return static_cast<bool>(out);
+}
+
+// Writes the counters of one year to files in a directory; on failure error explains why.
+bool SpatialHeatmaps::writeYear(const std::string &directory, int year, HeatmapFormat format, std::string &error) const
+{
+    const std::string suffix = "_year" + std::to_string(year);
+    if (format == HeatmapFormat::BINARY)
+    {
+        std::string path = directory + "/heatmaps" + suffix + ".bin";
+        std::ofstream out(path, std::ios::binary);
+        if (!out || !writeBinary(out))
+        {
+            error = "Could not write " + path + ".";
+            return false;
+        }
+        return true;
+    }
+    for (size_t layer = 0; layer < LAYER_COUNT; ++layer)
+    {
+        std::string path = directory + "/" + getLayerName(static_cast<HeatmapLayer>(layer)) + suffix + ".pgm";
+        std::ofstream out(path, std::ios::binary);
+        if (!out || !writePgm(out, static_cast<HeatmapLayer>(layer)))
+        {
+            error = "Could not write " + path + ".";
+            return false;
+        }
+    }
+    return true;
+}
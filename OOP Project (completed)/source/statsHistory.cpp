@@ -0,0 +1,212 @@
+// statsHistory.cpp
+#include "../headers/statsHistory.hpp"
+#include "../headers/monthlyStats.hpp"
+#include "../headers/utils.hpp" // For getSeasonName
+
+#include <cstring>
+#include <utility> // For std::move
+#include <iostream>
+
+static const char BINARY_MAGIC[8] = {'E', 'C', 'O', 'S', 'T', 'A', 'T', 'S'};
+static const std::uint32_t BINARY_VERSION = 2;
+static const std::uint32_t HISTOGRAM_BINS = static_cast<std::uint32_t>(AnimalHistograms::SPECIES_COUNT * AnimalHistograms::BINS_PER_SPECIES);
+
+// Writes a 32-bit value little-endian.
+static void writeUint32(std::ostream &out, std::uint32_t value)
+{
+    unsigned char bytes[4] = {static_cast<unsigned char>(value), static_cast<unsigned char>(value >> 8),
+                              static_cast<unsigned char>(value >> 16), static_cast<unsigned char>(value >> 24)};
+    out.write(reinterpret_cast<const char *>(bytes), 4);
+}
+
+// Reads a 32-bit little-endian value; returns false at the end of the stream.
+static bool readUint32(std::istream &in, std::uint32_t &value)
+{
+    unsigned char bytes[4];
+    if (!in.read(reinterpret_cast<char *>(bytes), 4))
+        return false;
+    value = static_cast<std::uint32_t>(bytes[0]) | static_cast<std::uint32_t>(bytes[1]) << 8 |
+            static_cast<std::uint32_t>(bytes[2]) << 16 | static_cast<std::uint32_t>(bytes[3]) << 24;
+    return true;
+}
+
+// Appends the figures of a completed month.
+void StatsHistory::append(const MonthlyStats &stats, Season season)
+{
+    const int values[COLUMN_COUNT] = {
+        stats.getPlantsEaten(), stats.getPlantsDiedNaturalAge(), stats.getPlantsDiedWeather(), stats.getPlantsSpread(),
+        stats.getCurrentPlants(), stats.getHerbivoresEaten(), stats.getHerbivoresDiedNatural(), stats.getHerbivoresSpawned(),
+        stats.getCurrentHerbivores(), stats.getCarnivoresEaten(), stats.getCarnivoresDiedNatural(), stats.getCarnivoresSpawned(),
+        stats.getCurrentCarnivores(), stats.getAnimalsImmigrated(), stats.getAnimalsEmigrated()};
+    seasons.push_back(static_cast<std::uint8_t>(season));
+    for (size_t column = 0; column < COLUMN_COUNT; ++column)
+        columns[column].push_back(values[column]);
+    histograms.push_back(stats.getAnimalHistograms());
+}
+
+// Reserves room for a number of months.
+void StatsHistory::reserve(size_t months)
+{
+    seasons.reserve(months);
+    for (auto &column : columns)
+        column.reserve(months);
+    histograms.reserve(months);
+}
+
+// Forgets every month.
+void StatsHistory::clear()
+{
+    seasons.clear();
+    for (auto &column : columns)
+        column.clear();
+    histograms.clear();
+}
+
+// Gets the number of months recorded.
+size_t StatsHistory::getMonthCount() const { return seasons.size(); }
+// Gets the bytes reserved for the months.
+size_t StatsHistory::getStorageBytes() const
+{
+    size_t bytes = seasons.capacity();
+    for (const auto &column : columns)
+        bytes += column.capacity() * sizeof(std::int32_t);
+    return bytes + histograms.capacity() * sizeof(AnimalHistograms);
+}
+
+// Gets all values of one counter, indexed by month.
+const std::vector<std::int32_t> &StatsHistory::getColumn(StatsColumn column) const { return columns[static_cast<size_t>(column)]; }
+// Gets the season of a recorded month.
+Season StatsHistory::getSeason(size_t month) const { return static_cast<Season>(seasons[month]); }
+// Gets the animal histograms of a recorded month.
+const AnimalHistograms &StatsHistory::getHistograms(size_t month) const { return histograms[month]; }
+
+// Gets the CSV header name of a counter.
+const char *StatsHistory::getColumnName(StatsColumn column)
+{
+    static const char *const names[COLUMN_COUNT] = {
+        "plantsEaten", "plantsDiedNaturalAge", "plantsDiedWeather", "plantsSpread", "plants",
+        "herbivoresEaten", "herbivoresDiedNatural", "herbivoresSpawned", "herbivores",
+        "carnivoresEaten", "carnivoresDiedNatural", "carnivoresSpawned", "carnivores",
+        "animalsImmigrated", "animalsEmigrated"};
+    return names[static_cast<size_t>(column)];
+}
+
+// Writes one CSV row per month (month, season and every counter), after a header line.
+void StatsHistory::writeCsv(std::ostream &out) const
+{
+    writeCsvHeader(out);
+    for (size_t month = 0; month < seasons.size(); ++month)
+        writeCsvRow(out, month);
+}
+
+// Writes the CSV header line.
+void StatsHistory::writeCsvHeader(std::ostream &out)
+{
+    out << "month,season";
+    for (size_t column = 0; column < COLUMN_COUNT; ++column)
+        out << ',' << getColumnName(static_cast<StatsColumn>(column));
+    out << '\n';
+}
+
+// Writes the CSV row of one recorded month.
+void StatsHistory::writeCsvRow(std::ostream &out, size_t month) const
+{
+    out << month + 1 << ',' << getSeasonName(getSeason(month));
+    for (size_t column = 0; column < COLUMN_COUNT; ++column)
+        out << ',' << columns[column][month];
+    out << '\n';
+}
+
+// Writes every month's animal histograms as CSV.
+void StatsHistory::writeHistogramCsv(std::ostream &out) const
+{
+    AnimalHistograms::writeCsvHeader(out);
+    for (size_t month = 0; month < histograms.size(); ++month)
+        histograms[month].writeCsvRows(out, month);
+}
+
+// Writes the binary format; returns false if the stream failed.
+bool StatsHistory::writeBinary(std::ostream &out) const
+{
+    out.write(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    writeUint32(out, BINARY_VERSION);
+    writeUint32(out, static_cast<std::uint32_t>(COLUMN_COUNT));
+    writeUint32(out, static_cast<std::uint32_t>(seasons.size()));
+    out.write(reinterpret_cast<const char *>(seasons.data()), seasons.size());
+    for (const auto &column : columns)
+        for (std::int32_t value : column)
+            writeUint32(out, static_cast<std::uint32_t>(value));
+    writeUint32(out, HISTOGRAM_BINS);
+    for (const AnimalHistograms &month : histograms)
+        for (std::uint32_t count : month.getCounts())
+            writeUint32(out, count);
+    return static_cast<bool>(out);
+}
+
+// Replaces this history with one read in the binary format; on failure error explains why.
+bool StatsHistory::readBinary(std::istream &in, std::string &error)
+{
+    char magic[sizeof(BINARY_MAGIC)];
+    std::uint32_t version = 0, columnCount = 0, monthCount = 0;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, BINARY_MAGIC, sizeof(magic)) != 0)
+    {
+        error = "Not a statistics history file.";
+        return false;
+    }
+    if (!readUint32(in, version) || !readUint32(in, columnCount) || !readUint32(in, monthCount))
+    {
+        error = "Truncated statistics history header.";
+        return false;
+    }
+    if (version < 1 || version > BINARY_VERSION || columnCount != COLUMN_COUNT)
+    {
+        error = "Unsupported statistics history version " + std::to_string(version) + " with " +
+                std::to_string(columnCount) + " columns.";
+        return false;
+    }
+    if (monthCount > static_cast<std::uint32_t>(MAX_SIMULATION_YEARS) * 12)
+    {
+        error = "Statistics history claims " + std::to_string(monthCount) + " months, more than any run can have.";
+        return false;
+    }
+
+    StatsHistory loaded;
+    loaded.seasons.resize(monthCount);
+    bool complete = static_cast<bool>(in.read(reinterpret_cast<char *>(loaded.seasons.data()), monthCount));
+    for (auto &column : loaded.columns)
+    {
+        column.resize(monthCount);
+        for (std::uint32_t month = 0; complete && month < monthCount; ++month)
+        {
+            std::uint32_t value;
+            complete = readUint32(in, value);
+            column[month] = static_cast<std::int32_t>(value);
+        }
+    }
+    loaded.histograms.resize(monthCount);
+    if (complete && version >= 2)
+    {
+        std::uint32_t bins = 0;
+        complete = readUint32(in, bins);
+        if (complete && bins != HISTOGRAM_BINS)
+        {
+            error = "Statistics history has " + std::to_string(bins) + " histogram bins per month, expected " +
+                    std::to_string(HISTOGRAM_BINS) + ".";
+            return false;
+        }
+        for (auto &month : loaded.histograms)
+        {
+            std::array<std::uint32_t, HISTOGRAM_BINS> counts{};
+            for (std::uint32_t &count : counts)
+                complete = complete && readUint32(in, count);
+            month.setCounts(counts);
+        }
+    }
+    if (!complete)
+    {
+        error = "Truncated statistics history data.";
+        return false;
+    }
+    *this = std::move(loaded);
+    return true;
+}
@@ -0,0 +1,36 @@
+// statsShard.cpp
+#include "../headers/statsShard.hpp"
+
+#include <utility> // For std::move
+
+// Resets every counter and drops the events, keeping the event storage, mask and heatmaps for the next month.
+void StatsShard::clear()
+{
+    EventLog events = std::move(monthlyEvents);
+    unsigned int mask = eventMask;
+    SpatialHeatmaps *keptHeatmaps = heatmaps;
+    *this = StatsShard();
+    monthlyEvents = std::move(events);
+    monthlyEvents.clear();
+    eventMask = mask;
+    heatmaps = keptHeatmaps;
+}
+
+// Adds another shard's counters and appends its events.
+void StatsShard::absorb(const StatsShard &other)
+{
+    plantsEaten += other.plantsEaten;
+    plantsDiedNaturalAge += other.plantsDiedNaturalAge;
+    plantsDiedWeather += other.plantsDiedWeather;
+    plantsSpread += other.plantsSpread;
+    herbivoresEaten += other.herbivoresEaten;
+    herbivoresDiedNatural += other.herbivoresDiedNatural;
+    herbivoresSpawned += other.herbivoresSpawned;
+    carnivoresEaten += other.carnivoresEaten;
+    carnivoresDiedNatural += other.carnivoresDiedNatural;
+    carnivoresSpawned += other.carnivoresSpawned;
+    animalsImmigrated += other.animalsImmigrated;
+    animalsEmigrated += other.animalsEmigrated;
+    monthlyEvents.appendAll(other.monthlyEvents);
+    animalHistograms.absorb(other.animalHistograms);
+}
@@ -0,0 +1,69 @@
+// statsSink.cpp
+#include "../headers/statsSink.hpp"
+#include "../headers/monthlyStats.hpp"
+#include "../headers/grid.hpp"
+
+#include <iostream>
+
+// ConsoleSink constructor.
+ConsoleSink::ConsoleSink(std::ostream &out_val, bool showGrid_val) : out(out_val), showGrid(showGrid_val) {}
+
+// Asks for the grid only when it is printed.
+bool ConsoleSink::wantsGrid() const { return showGrid; }
+
+// Prints the month's grid (if wanted) and statistics.
+void ConsoleSink::onMonth(int, Season, const MonthlyStats &stats, const Grid *grid)
+{
+    if (grid)
+        grid->display(out);
+    stats.display(out);
+}
+
+// CsvSink constructor.
+CsvSink::CsvSink(std::ostream &out_val) : out(out_val) {}
+
+// Writes the month's row (and the header before the first one).
+void CsvSink::onMonth(int, Season season, const MonthlyStats &stats, const Grid *)
+{
+    if (rows.getMonthCount() == 0)
+        StatsHistory::writeCsvHeader(out);
+    rows.append(stats, season);
+    rows.writeCsvRow(out, rows.getMonthCount() - 1);
+}
+
+// Flushes the rows written so far.
+void CsvSink::finish() { out.flush(); }
+
+// HistogramCsvSink constructor.
+HistogramCsvSink::HistogramCsvSink(std::ostream &out_val) : out(out_val), headerWritten(false) {}
+
+// Writes the month's histogram rows (and the header before the first ones).
+void HistogramCsvSink::onMonth(int month, Season, const MonthlyStats &stats, const Grid *)
+{
+    if (!headerWritten)
+        AnimalHistograms::writeCsvHeader(out);
+    headerWritten = true;
+    stats.getAnimalHistograms().writeCsvRows(out, static_cast<size_t>(month - 1));
+}
+
+// Flushes the rows written so far.
+void HistogramCsvSink::finish() { out.flush(); }
+
+// BinarySink constructor.
+BinarySink::BinarySink(std::ostream &out_val) : out(out_val), written(false) {}
+
+// Keeps the month until the run finishes.
+void BinarySink::onMonth(int, Season season, const MonthlyStats &stats, const Grid *)
+{
+    months.append(stats, season);
+}
+
+// Writes every collected month (only once, however often the run is reported as finished).
+void BinarySink::finish()
+{
+    if (written)
+        return;
+    months.writeBinary(out);
+    out.flush();
+    written = true;
+}
@@ -0,0 +1,217 @@
+// threadPool.cpp
+#include "../headers/threadPool.hpp"
+#include "../headers/numaPlacement.hpp" // For CPU pinning
+#include "../headers/traceRecorder.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+
+// ThreadPool constructor; the calling thread counts as one of threadCount.
+ThreadPool::ThreadPool(int threadCount, bool pinThreads)
+    : currentJob(nullptr), busyWorkers(0), jobGeneration(0), stopping(false), traceRecorder(nullptr)
+{
+    if (threadCount < 1)
+        threadCount = 1;
+    for (int i = 0; i < threadCount; ++i)
+        queues.emplace_back(new WorkerQueue());
+    if (pinThreads)
+    {
+        std::vector<int> cpus = allowedCpusByNode();
+        if (!cpus.empty())
+        {
+            for (int i = 0; i < threadCount; ++i)
+                workerCpus.push_back(cpus[i % cpus.size()]); // More workers than CPUs share them round-robin
+            callerCpus = cpus;
+            pinCurrentThread({workerCpus[0]});
+        }
+    }
+    for (int i = 1; i < threadCount; ++i)
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+}
+
+// Joins all worker threads (and gives the calling thread back its CPUs if it was pinned).
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    for (auto &worker : workers)
+        worker.join();
+    if (!callerCpus.empty())
+        pinCurrentThread(callerCpus);
+}
+
+// Takes the next task for a worker, from its own queue first and then by stealing.
+bool ThreadPool::takeTask(int workerIndex, size_t &task)
+{
+    WorkerQueue &own = *queues[workerIndex];
+    {
+        std::lock_guard<std::mutex> lock(own.queueMutex);
+        if (!own.tasks.empty())
+        {
+            task = own.tasks.front();
+            own.tasks.pop_front();
+            return true;
+        }
+    }
+    const int queueCount = static_cast<int>(queues.size());
+    for (int offset = 1; offset < queueCount; ++offset)
+    {
+        WorkerQueue &victim = *queues[(workerIndex + offset) % queueCount];
+        std::lock_guard<std::mutex> lock(victim.queueMutex);
+        if (!victim.tasks.empty())
+        {
+            task = victim.tasks.back();
+            victim.tasks.pop_back();
+            own.stats.tasksStolen++;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Runs tasks for a worker until none are left anywhere. Tasks never enqueue
+// new tasks, so one empty sweep over all queues means this worker is done.
+void ThreadPool::drainJob(int workerIndex, const std::function<void(size_t)> &job)
+{
+    WorkerQueue &own = *queues[workerIndex];
+    ScopedTraceRecorder bindTrace(traceRecorder);
+    if (traceRecorder)
+        traceRecorder->nameThread("Worker", workerIndex);
+    size_t task;
+    while (takeTask(workerIndex, task))
+    {
+        auto taskStart = std::chrono::steady_clock::now();
+        job(task);
+        auto taskEnd = std::chrono::steady_clock::now();
+        own.jobBusySeconds += std::chrono::duration<double>(taskEnd - taskStart).count();
+        own.stats.tasksRun++;
+        if (traceRecorder)
+            traceRecorder->addSpan("Task", "worker", taskStart, taskEnd, "task", static_cast<long long>(task));
+    }
+}
+
+// Main loop of each worker thread.
+void ThreadPool::workerLoop(int workerIndex)
+{
+    if (!workerCpus.empty())
+        pinCurrentThread({workerCpus[workerIndex]});
+    unsigned long long seenGeneration = 0;
+    while (true)
+    {
+        const std::function<void(size_t)> *job = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(poolMutex);
+            workAvailable.wait(lock, [&] { return stopping || jobGeneration != seenGeneration; });
+            if (stopping)
+                return;
+            seenGeneration = jobGeneration;
+            if (!currentJob) // Woke after the job had already been finished by others.
+                continue;
+            job = currentJob;
+            busyWorkers++;
+        }
+        drainJob(workerIndex, *job);
+        {
+            std::lock_guard<std::mutex> lock(poolMutex);
+            busyWorkers--;
+        }
+        workFinished.notify_all();
+    }
+}
+
+// Runs job(0..count-1); task i starts on worker ownerOf(i) and may be stolen by idle workers.
+void ThreadPool::runTasks(size_t count, const std::function<void(size_t)> &job, const std::function<int(size_t)> &ownerOf)
+{
+    if (count == 0)
+        return;
+    const int queueCount = static_cast<int>(queues.size());
+    auto jobStart = std::chrono::steady_clock::now();
+    for (int i = 0; i < queueCount; ++i)
+        queues[i]->jobBusySeconds = 0.0;
+    for (size_t task = 0; task < count; ++task)
+    {
+        int owner = ownerOf(task) % queueCount;
+        queues[owner]->tasks.push_back(task); // No job is running, so the queues are not shared yet.
+    }
+
+    if (!workers.empty() && count > 1)
+    {
+        {
+            std::lock_guard<std::mutex> lock(poolMutex);
+            currentJob = &job;
+            jobGeneration++;
+        }
+        workAvailable.notify_all();
+    }
+    drainJob(0, job);
+    {
+        std::unique_lock<std::mutex> lock(poolMutex);
+        workFinished.wait(lock, [&] { return busyWorkers == 0; });
+        currentJob = nullptr;
+    }
+
+    // Anything a worker spent inside this job without a task counts as idle time.
+    double jobSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - jobStart).count();
+    for (int i = 0; i < queueCount; ++i)
+    {
+        WorkerStats &stats = queues[i]->stats;
+        stats.busySeconds += queues[i]->jobBusySeconds;
+        if (jobSeconds > queues[i]->jobBusySeconds)
+            stats.idleSeconds += jobSeconds - queues[i]->jobBusySeconds;
+    }
+}
+
+// Runs job(0..count-1), handing each worker a contiguous block of indices to start with.
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)> &job)
+{
+    const size_t threads = queues.size();
+    runTasks(count, job, [&](size_t task) { return static_cast<int>(task * threads / count); });
+}
+
+// Gets the number of threads taking part in a job, including the caller.
+int ThreadPool::getThreadCount() const { return static_cast<int>(queues.size()); }
+
+// Gets the CPU a worker is pinned to, or -1 if the pool is not pinned.
+int ThreadPool::getWorkerCpu(int workerIndex) const
+{
+    return workerCpus.empty() ? -1 : workerCpus[workerIndex];
+}
+
+// Records every task as a span on its worker's thread (nullptr stops it). Call between jobs only.
+void ThreadPool::setTraceRecorder(TraceRecorder *recorder) { traceRecorder = recorder; }
+
+// Gets the scheduling counters of every worker (index 0 is the calling thread).
+std::vector<WorkerStats> ThreadPool::getWorkerStats() const
+{
+    std::vector<WorkerStats> result;
+    for (const auto &queue : queues)
+        result.push_back(queue->stats);
+    return result;
+}
+
+// Clears the scheduling counters.
+void ThreadPool::resetWorkerStats()
+{
+    for (auto &queue : queues)
+        queue->stats = WorkerStats();
+}
+
+// Prints per-worker task, steal and idle figures.
+void ThreadPool::reportWorkerStats(std::ostream &out) const
+{
+    out << "\n--- Worker Scheduling ---\n";
+    out << std::left << std::setw(8) << "Worker" << std::setw(10) << "Tasks" << std::setw(10) << "Stolen"
+        << std::setw(12) << "Busy (ms)" << "Idle (ms)\n";
+    for (size_t i = 0; i < queues.size(); ++i)
+    {
+        const WorkerStats &stats = queues[i]->stats;
+        out << std::left << std::setw(8) << i << std::setw(10) << stats.tasksRun << std::setw(10) << stats.tasksStolen
+            << std::setw(12) << std::fixed << std::setprecision(2) << stats.busySeconds * 1000.0
+            << stats.idleSeconds * 1000.0 << "\n";
+    }
+    out << std::defaultfloat << std::right;
+}
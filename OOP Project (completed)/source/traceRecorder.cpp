@@ -0,0 +1,146 @@
+// traceRecorder.cpp
+#include "../headers/traceRecorder.hpp"
+
+#include <atomic>
+#include <iostream>
+#include <iomanip>
+
+// Source of TraceRecorder::recorderId (0 is never handed out).
+static std::atomic<unsigned long long> nextRecorderId(1);
+
+// Recorder the trace scopes on this thread go to.
+static thread_local TraceRecorder *boundRecorder = nullptr;
+
+// TraceRecorder constructor; timestamps count from now.
+TraceRecorder::TraceRecorder() : recorderId(nextRecorderId++), origin(Clock::now()) {}
+
+// Converts a time point to nanoseconds since the recorder was created.
+long long TraceRecorder::sinceOrigin(Clock::time_point time) const
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time - origin).count();
+}
+
+// Gets the calling thread's buffer, registering it on first use.
+TraceRecorder::ThreadBuffer &TraceRecorder::threadBuffer()
+{
+    static thread_local unsigned long long cachedRecorderId = 0;
+    static thread_local ThreadBuffer *cachedBuffer = nullptr;
+    if (cachedRecorderId == recorderId)
+        return *cachedBuffer;
+
+    // A thread that alternates between recorders finds its old buffer again instead of adding one.
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    const std::thread::id self = std::this_thread::get_id();
+    ThreadBuffer *found = nullptr;
+    for (auto &buffer : buffers)
+        if (buffer->owner == self)
+            found = buffer.get();
+    if (!found)
+    {
+        buffers.emplace_back(new ThreadBuffer());
+        found = buffers.back().get();
+        found->owner = self;
+        found->traceThreadId = static_cast<int>(buffers.size());
+        found->events.reserve(1024);
+    }
+    cachedRecorderId = recorderId;
+    cachedBuffer = found;
+    return *found;
+}
+
+// Records a span on the calling thread, optionally with one integer argument.
+void TraceRecorder::addSpan(const char *name, const char *category, Clock::time_point start, Clock::time_point end,
+                            const char *argName, long long argValue)
+{
+    long long startNs = sinceOrigin(start);
+    threadBuffer().events.push_back({name, category, 'X', startNs, sinceOrigin(end) - startNs, argName, argValue});
+}
+
+// Records the current value of one series of a counter track (e.g. "Population", "plants").
+void TraceRecorder::addCounter(const char *name, const char *series, long long value)
+{
+    threadBuffer().events.push_back({name, series, 'C', sinceOrigin(Clock::now()), 0, nullptr, value});
+}
+
+// Names the calling thread in the trace as role (or "role index"), unless it already has a name.
+void TraceRecorder::nameThread(const char *role, int index)
+{
+    ThreadBuffer &buffer = threadBuffer();
+    if (!buffer.threadName.empty())
+        return;
+    buffer.threadName = role;
+    if (index >= 0)
+        buffer.threadName += " " + std::to_string(index);
+}
+
+// Gets the number of events recorded on all threads.
+size_t TraceRecorder::getEventCount() const
+{
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    size_t count = 0;
+    for (const auto &buffer : buffers)
+        count += buffer->events.size();
+    return count;
+}
+
+// Forgets every event (thread names are kept).
+void TraceRecorder::clear()
+{
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    for (auto &buffer : buffers)
+        buffer->events.clear();
+}
+
+// Writes a nanosecond count as trace-event microseconds.
+static void writeMicros(std::ostream &out, long long nanoseconds)
+{
+    out << nanoseconds / 1000 << '.' << std::setw(3) << std::setfill('0') << nanoseconds % 1000 << std::setfill(' ');
+}
+
+// Writes every event as a Chrome trace-event JSON object, one event per line.
+void TraceRecorder::writeJson(std::ostream &out) const
+{
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"Ecosystem simulation\"}}";
+    for (const auto &buffer : buffers)
+    {
+        const int tid = buffer->traceThreadId;
+        if (!buffer->threadName.empty())
+        {
+            out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid
+                << ",\"args\":{\"name\":\"" << buffer->threadName << "\"}}";
+            out << ",\n{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid
+                << ",\"args\":{\"sort_index\":" << tid << "}}";
+        }
+        for (const TraceEvent &event : buffer->events)
+        {
+            out << ",\n{\"name\":\"" << event.name << "\",\"ph\":\"" << event.type << "\",\"pid\":1,\"tid\":" << tid << ",\"ts\":";
+            writeMicros(out, event.startNs);
+            if (event.type == 'C')
+            {
+                out << ",\"args\":{\"" << event.category << "\":" << event.argValue << "}}";
+                continue;
+            }
+            out << ",\"dur\":";
+            writeMicros(out, event.durationNs);
+            out << ",\"cat\":\"" << event.category << "\"";
+            if (event.argName)
+                out << ",\"args\":{\"" << event.argName << "\":" << event.argValue << "}";
+            out << "}";
+        }
+    }
+    out << "\n]}\n";
+}
+
+// Gets the recorder spans on the calling thread go to (nullptr when tracing is off).
+TraceRecorder *activeTraceRecorder() { return boundRecorder; }
+
+// Routes the calling thread's trace scopes to a recorder while in scope.
+ScopedTraceRecorder::ScopedTraceRecorder(TraceRecorder *recorder) : previousRecorder(boundRecorder)
+{
+    boundRecorder = recorder;
+}
+
+// Restores the recorder that was active before.
+ScopedTraceRecorder::~ScopedTraceRecorder() { boundRecorder = previousRecorder; }
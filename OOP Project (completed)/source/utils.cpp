@@ -6,6 +6,34 @@
 std::random_device rd;
 std::mt19937 gen(rd()); // Definition
 
+// Generator the helpers draw from on this thread; nullptr means the global gen.
+static thread_local std::mt19937 *boundGenerator = nullptr;
+
+// Returns the generator the random helpers use on the calling thread.
+std::mt19937& activeRandomGenerator()
+{
+    return boundGenerator ? *boundGenerator : gen;
+}
+
+// Binds the calling thread's random helpers to the given generator.
+ScopedRandomGenerator::ScopedRandomGenerator(std::mt19937 &generator) : previousGenerator(boundGenerator)
+{
+    boundGenerator = &generator;
+}
+
+// Restores whichever generator was bound before.
+ScopedRandomGenerator::~ScopedRandomGenerator() { boundGenerator = previousGenerator; }
+
+// Derives an independent seed for a numbered stream using the splitmix64 finalizer.
+unsigned int deriveSeed(unsigned long long baseSeed, unsigned long long streamIndex)
+{
+    unsigned long long z = baseSeed + 0x9E3779B97F4A7C15ULL * (streamIndex + 1);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z = z ^ (z >> 31);
+    return static_cast<unsigned int>(z ^ (z >> 32));
+}
+
 // Generates a random integer within a specified range (inclusive).
 int getRandomInt(int min, int max)
 {
@@ -14,7 +42,7 @@ int getRandomInt(int min, int max)
     if (min == max)
         return min;
     std::uniform_int_distribution<> distrib(min, max);
-    return distrib(gen);
+    return distrib(activeRandomGenerator());
 }
 
 // Generates a random double within a specified range.
@@ -23,7 +51,7 @@ double getRandomDouble(double min, double max)
     if (min > max)
         std::swap(min, max);
     std::uniform_real_distribution<> distrib(min, max);
-    return distrib(gen);
+    return distrib(activeRandomGenerator());
 }
 
 // Returns the string name of a given season.
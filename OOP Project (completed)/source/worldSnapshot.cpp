@@ -0,0 +1,335 @@
+// worldSnapshot.cpp
+#include "../headers/worldSnapshot.hpp"
+#include "../headers/grid.hpp"
+#include "../headers/plants.hpp"
+#include "../headers/herbivore.hpp"
+#include "../headers/carnivore.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdio>   // For std::rename, std::remove
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include <type_traits>
+
+static_assert(std::is_trivially_copyable<SnapshotHeader>::value, "The snapshot header is read straight from the mapping");
+
+static const char SNAPSHOT_MAGIC[8] = {'E', 'C', 'O', 'S', 'N', 'A', 'P', '\0'};
+static const std::uint32_t SNAPSHOT_VERSION = 1;
+static const std::uint32_t SNAPSHOT_BYTE_ORDER = 0x01020304;
+static const std::uint64_t SNAPSHOT_ALIGNMENT = 64; // Every array starts on a cache line
+static const size_t COLUMN_COUNT = static_cast<size_t>(SnapshotColumn::COUNT);
+static const size_t PLANT_COLUMN_COUNT = static_cast<size_t>(SnapshotColumn::AGE) + 1;
+static const size_t WRITE_CHUNK = 4096; // Values gathered per write
+
+// Rounds an offset up to the next array boundary.
+static std::uint64_t alignUp(std::uint64_t offset) { return (offset + SNAPSHOT_ALIGNMENT - 1) / SNAPSHOT_ALIGNMENT * SNAPSHOT_ALIGNMENT; }
+
+// Gets the position of a species in the header's tables.
+static size_t speciesSlot(EntityType species)
+{
+    return species == EntityType::PLANT ? 0 : species == EntityType::HERBIVORE ? 1 : 2;
+}
+
+// Lays out one species' arrays from offset on and returns the offset after them.
+static std::uint64_t layOutSpecies(SnapshotSpeciesTable &table, std::uint64_t count, size_t columns, std::uint64_t offset)
+{
+    table.count = count;
+    table.idsOffset = offset;
+    offset = alignUp(offset + count * sizeof(std::uint64_t));
+    table.flagsOffset = offset;
+    offset = alignUp(offset + count);
+    for (size_t column = 0; column < COLUMN_COUNT; ++column)
+    {
+        table.columnOffsets[column] = column < columns ? offset : 0;
+        if (column < columns)
+            offset = alignUp(offset + count * sizeof(std::int32_t));
+    }
+    return offset;
+}
+
+// Writes zero bytes until the stream reaches offset.
+static void padTo(std::ostream &out, std::uint64_t offset)
+{
+    static const char zeros[SNAPSHOT_ALIGNMENT] = {};
+    const std::uint64_t position = static_cast<std::uint64_t>(out.tellp());
+    if (offset > position)
+        out.write(zeros, static_cast<std::streamsize>(offset - position));
+}
+
+// Writes one value per entity of a list at offset, gathering them in chunks.
+template <typename Value, typename List, typename Field>
+static void writeColumn(std::ostream &out, std::uint64_t offset, const List &list, Field field)
+{
+    padTo(out, offset);
+    Value buffer[WRITE_CHUNK];
+    size_t used = 0;
+    for (const auto &entity : list)
+    {
+        buffer[used++] = static_cast<Value>(field(*entity));
+        if (used == WRITE_CHUNK)
+        {
+            out.write(reinterpret_cast<const char *>(buffer), sizeof(buffer));
+            used = 0;
+        }
+    }
+    out.write(reinterpret_cast<const char *>(buffer), static_cast<std::streamsize>(used * sizeof(Value)));
+}
+
+// Writes the id and flag arrays every species has.
+template <typename List>
+static void writeIdsAndFlags(std::ostream &out, const SnapshotSpeciesTable &table, const List &list)
+{
+    writeColumn<std::uint64_t>(out, table.idsOffset, list, [](const Entity &e) { return e.getId(); });
+    writeColumn<std::uint8_t>(out, table.flagsOffset, list, [](const Entity &e) {
+        const Animal *animal = e.getType() == EntityType::PLANT ? nullptr : static_cast<const Animal *>(&e);
+        return (e.getGender() == Gender::FEMALE ? SNAPSHOT_FEMALE : 0) |
+               (animal && animal->isCurrentlyPregnant() ? SNAPSHOT_PREGNANT : 0);
+    });
+}
+
+// Writes the int32 columns of an animal species.
+template <typename List>
+static void writeAnimalColumns(std::ostream &out, const SnapshotSpeciesTable &table, const List &list)
+{
+    writeIdsAndFlags(out, table, list);
+    const std::uint64_t *at = table.columnOffsets;
+    writeColumn<std::int32_t>(out, at[0], list, [](const Animal &a) { return a.getR(); });
+    writeColumn<std::int32_t>(out, at[1], list, [](const Animal &a) { return a.getC(); });
+    writeColumn<std::int32_t>(out, at[2], list, [](const Animal &a) { return a.getCurrentAge(); });
+    writeColumn<std::int32_t>(out, at[3], list, [](const Animal &a) { return a.getCurrentEnergy(); });
+    writeColumn<std::int32_t>(out, at[4], list, [](const Animal &a) { return a.getCurrentCooldownForReproduction(); });
+    writeColumn<std::int32_t>(out, at[5], list, [](const Animal &a) { return a.getCurrentGestationProgress(); });
+    writeColumn<std::int32_t>(out, at[6], list, [](const Animal &a) { return a.getMealsMissedTurns(); });
+}
+
+// Writes the owned rows of a grid as a snapshot file; on failure error explains why.
+bool WorldSnapshot::write(const Grid &grid, int month, const std::string &path, std::string &error)
+{
+    const auto &plants = grid.getPlants();
+    const auto &herbivores = grid.getHerbivores();
+    const auto &carnivores = grid.getCarnivores();
+    const int firstRow = grid.getOwnedRowBegin();
+    const int width = grid.getWidth();
+    const size_t cellCount = static_cast<size_t>(grid.getOwnedCellCount());
+    if (plants.size() + herbivores.size() + carnivores.size() >= SNAPSHOT_REMAINS_CELL)
+    {
+        error = "Too many entities for a snapshot's 32-bit cells.";
+        return false;
+    }
+
+    SnapshotHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.byteOrder = SNAPSHOT_BYTE_ORDER;
+    header.height = grid.getOwnedRowEnd() - firstRow;
+    header.width = width;
+    header.month = month;
+    header.firstRow = firstRow;
+    header.cellsOffset = alignUp(sizeof(SnapshotHeader));
+    std::uint64_t offset = alignUp(header.cellsOffset + cellCount * sizeof(std::uint32_t));
+    offset = layOutSpecies(header.species[0], plants.size(), PLANT_COLUMN_COUNT, offset);
+    offset = layOutSpecies(header.species[1], herbivores.size(), COLUMN_COUNT, offset);
+    offset = layOutSpecies(header.species[2], carnivores.size(), COLUMN_COUNT, offset);
+    header.fileBytes = offset;
+
+    // Cells refer to the entity their cell holds; listed entities moved over keep only their columns.
+    std::vector<std::uint32_t> cells(cellCount, SNAPSHOT_EMPTY_CELL);
+    std::uint32_t reference = 1;
+    auto refer = [&](const auto &list) {
+        for (const auto &entity : list)
+        {
+            if (grid.isOwnedRow(entity->getR()) && grid.getEntity(entity->getR(), entity->getC()) == entity)
+                cells[static_cast<size_t>(entity->getR() - firstRow) * width + entity->getC()] = reference;
+            reference++;
+        }
+    };
+    refer(plants);
+    refer(herbivores);
+    refer(carnivores);
+    for (int r = firstRow; r < grid.getOwnedRowEnd(); ++r)
+    {
+        const std::shared_ptr<Entity> *row = grid.storedRow(r);
+        std::uint32_t *cellRow = cells.data() + static_cast<size_t>(r - firstRow) * width;
+        for (int c = 0; c < width; ++c)
+            if (row[c] && cellRow[c] == SNAPSHOT_EMPTY_CELL)
+                cellRow[c] = SNAPSHOT_REMAINS_CELL;
+    }
+
+    const std::string partialPath = path + ".tmp";
+    {
+        std::ofstream out(partialPath, std::ios::binary);
+        if (out)
+        {
+            out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            padTo(out, header.cellsOffset);
+            out.write(reinterpret_cast<const char *>(cells.data()), static_cast<std::streamsize>(cells.size() * sizeof(std::uint32_t)));
+            const SnapshotSpeciesTable &plantTable = header.species[0];
+            writeIdsAndFlags(out, plantTable, plants);
+            writeColumn<std::int32_t>(out, plantTable.columnOffsets[0], plants, [](const Plant &p) { return p.getR(); });
+            writeColumn<std::int32_t>(out, plantTable.columnOffsets[1], plants, [](const Plant &p) { return p.getC(); });
+            writeColumn<std::int32_t>(out, plantTable.columnOffsets[2], plants, [](const Plant &p) { return p.getCurrentAgePlant(); });
+            writeAnimalColumns(out, header.species[1], herbivores);
+            writeAnimalColumns(out, header.species[2], carnivores);
+            padTo(out, header.fileBytes);
+            out.flush();
+        }
+        if (!out)
+        {
+            error = "Could not write " + partialPath + ".";
+            std::remove(partialPath.c_str());
+            return false;
+        }
+    }
+    if (std::rename(partialPath.c_str(), path.c_str()) != 0)
+    {
+        error = "Could not move the snapshot to " + path + ".";
+        std::remove(partialPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+WorldSnapshot::WorldSnapshot() : mapping(nullptr), mappedBytes(0) {}
+
+WorldSnapshot::~WorldSnapshot() { close(); }
+
+// Maps a snapshot file read-only; on failure error explains why and nothing is open.
+bool WorldSnapshot::open(const std::string &path, std::string &error)
+{
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        error = "Could not open snapshot " + path + ".";
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(SnapshotHeader))
+    {
+        ::close(fd);
+        error = path + ": Too short for a snapshot.";
+        return false;
+    }
+    void *address = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd); // The mapping keeps the file
+    if (address == MAP_FAILED)
+    {
+        error = "Could not map snapshot " + path + ".";
+        return false;
+    }
+    mapping = static_cast<const unsigned char *>(address);
+    mappedBytes = static_cast<size_t>(info.st_size);
+    if (!validate(error))
+    {
+        error = path + ": " + error;
+        close();
+        return false;
+    }
+    return true;
+}
+
+// Unmaps the file.
+void WorldSnapshot::close()
+{
+    if (mapping)
+        munmap(const_cast<unsigned char *>(mapping), mappedBytes);
+    mapping = nullptr;
+    mappedBytes = 0;
+}
+
+// Checks the header against the file size; on failure error explains why.
+bool WorldSnapshot::validate(std::string &error) const
+{
+    const SnapshotHeader &head = header();
+    if (std::memcmp(head.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0)
+    {
+        error = "Not a world snapshot.";
+        return false;
+    }
+    if (head.version != SNAPSHOT_VERSION || head.byteOrder != SNAPSHOT_BYTE_ORDER)
+    {
+        error = head.version != SNAPSHOT_VERSION ? "Unsupported snapshot version " + std::to_string(head.version) + "."
+                                                  : std::string("Snapshot was written with another byte order.");
+        return false;
+    }
+    // An array fits if it starts on a boundary and ends inside the file.
+    auto fits = [&](std::uint64_t arrayOffset, std::uint64_t count, std::uint64_t valueBytes) {
+        return arrayOffset % SNAPSHOT_ALIGNMENT == 0 && arrayOffset >= sizeof(SnapshotHeader) && arrayOffset <= mappedBytes &&
+               count <= (mappedBytes - arrayOffset) / valueBytes;
+    };
+    if (head.height < 0 || head.width < 0 || head.firstRow < 0 || head.fileBytes > mappedBytes ||
+        !fits(head.cellsOffset, static_cast<std::uint64_t>(head.height) * static_cast<std::uint64_t>(head.width), sizeof(std::uint32_t)))
+    {
+        error = "Snapshot dimensions do not match the file.";
+        return false;
+    }
+    for (size_t slot = 0; slot < 3; ++slot)
+    {
+        const SnapshotSpeciesTable &species = head.species[slot];
+        bool valid = fits(species.idsOffset, species.count, sizeof(std::uint64_t)) && fits(species.flagsOffset, species.count, 1);
+        for (size_t column = 0; column < COLUMN_COUNT; ++column)
+        {
+            const bool present = slot > 0 || column < PLANT_COLUMN_COUNT;
+            valid = valid && (present ? fits(species.columnOffsets[column], species.count, sizeof(std::int32_t))
+                                      : species.columnOffsets[column] == 0);
+        }
+        if (!valid)
+        {
+            error = "Snapshot entity columns do not match the file.";
+            return false;
+        }
+    }
+    return true;
+}
+
+// Gets the table of a species.
+const SnapshotSpeciesTable &WorldSnapshot::table(EntityType species) const { return header().species[speciesSlot(species)]; }
+
+// Gets the number of entities of a species.
+size_t WorldSnapshot::getCount(EntityType species) const { return static_cast<size_t>(table(species).count); }
+
+// Gets every cell, row by row.
+const std::uint32_t *WorldSnapshot::getCells() const
+{
+    return reinterpret_cast<const std::uint32_t *>(mapping + header().cellsOffset);
+}
+
+// Finds the species and column index of the entity a cell refers to.
+bool WorldSnapshot::getCellEntity(std::uint32_t cell, EntityType &species, size_t &index) const
+{
+    if (cell == SNAPSHOT_EMPTY_CELL || cell == SNAPSHOT_REMAINS_CELL)
+        return false;
+    index = cell - 1;
+    const EntityType order[] = {EntityType::PLANT, EntityType::HERBIVORE, EntityType::CARNIVORE};
+    for (EntityType candidate : order)
+    {
+        if (index < getCount(candidate))
+        {
+            species = candidate;
+            return true;
+        }
+        index -= getCount(candidate);
+    }
+    return false;
+}
+
+// Gets the ids of a species' entities.
+const std::uint64_t *WorldSnapshot::getIds(EntityType species) const
+{
+    return reinterpret_cast<const std::uint64_t *>(mapping + table(species).idsOffset);
+}
+
+// Gets the SNAPSHOT_* flags of a species' entities.
+const std::uint8_t *WorldSnapshot::getFlags(EntityType species) const { return mapping + table(species).flagsOffset; }
+
+// Gets one column of a species' entities (nullptr for columns plants do not have).
+const std::int32_t *WorldSnapshot::getColumn(EntityType species, SnapshotColumn column) const
+{
+    const std::uint64_t columnOffset = table(species).columnOffsets[static_cast<size_t>(column)];
+    return columnOffset ? reinterpret_cast<const std::int32_t *>(mapping + columnOffset) : nullptr;
+}